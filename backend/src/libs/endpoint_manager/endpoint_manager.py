@@ -429,6 +429,66 @@ class EndpointManager(metaclass=FinalClass):
                 )
             ]
         )
+        self.paths_initialised.add_path(
+            f"{self.v1_str}/feeder/visit/batch", self.cat_endpoints.post_feeder_visit_batch, "POST",
+            decorators=[
+                decorators.auth_endpoint(),
+                decorators.cat_endpoint,
+                decorators.json_body(
+                    "Visits buffered by a feeder, coalesced per beacon, the times are ages counted back from the request",
+                    example={
+                        "feeder_mac": "11:22:33:44:55:66",
+                        "visits": [
+                            {"mac": "AABBCCDDEEFF", "first_ms_ago": 240000,
+                                "last_ms_ago": 1500, "samples": 12, "rssi": -52},
+                            {"mac": "112233445566", "first_ms_ago": 90000,
+                                "last_ms_ago": 30000, "samples": 4, "rssi": -58}
+                        ]
+                    }
+                ),
+                decorators.set_operation_id("post_feeder_visit_batch"),
+                decorators.set_summary("Record the buffered visits of a feeder"),
+                decorators.set_description(
+                    "Records one location history line per visit of a beacon of the feeder owner, in a single insert")
+            ]
+        )
+        self.paths_initialised.add_path(
+            f"{self.v1_str}/feeder/beacons", self.cat_endpoints.get_feeder_beacons, "GET",
+            decorators=[
+                decorators.auth_endpoint(),
+                decorators.cat_endpoint,
+                decorators.json_body(
+                    "Beacons allowed at the feeder, send the last ETag in If-None-Match to get a 304 while unchanged",
+                    example={"feeder_mac": "11:22:33:44:55:66"}
+                ),
+                decorators.set_operation_id("get_feeder_beacons"),
+                decorators.set_summary("Get the beacon allowlist of a feeder"),
+                decorators.set_description(
+                    "Sorted MAC addresses of the beacons registered by the owner of the feeder, versioned by an ETag")
+            ]
+        )
+        self.paths_initialised.add_path(
+            f"{self.v1_str}/feeder/feed_plan", self.cat_endpoints.post_feed_plan, "POST",
+            decorators=[
+                decorators.auth_endpoint(),
+                decorators.cat_endpoint,
+                decorators.json_body(
+                    "Beacons seen by one scan with their smoothed RSSI, the visits are recorded and the portions booked",
+                    example={
+                        "feeder_mac": "11:22:33:44:55:66",
+                        "max_portion": 50,
+                        "beacons": [
+                            {"mac": "AABBCCDDEEFF", "rssi": -48},
+                            {"mac": "112233445566", "rssi": -57}
+                        ]
+                    }
+                ),
+                decorators.set_operation_id("post_feed_plan"),
+                decorators.set_summary("Decide the feeding of every beacon near a feeder"),
+                decorators.set_description(
+                    "Records a visit per known beacon and returns the portions to distribute, strongest RSSI first")
+            ]
+        )
 
         # Pet endpoints
         self.paths_initialised.add_path(
@@ -21,8 +21,9 @@ r"""
 # // AR
 # +==== END CatFeeder =================+
 """
+import hashlib
 from dataclasses import dataclass
-from typing import TYPE_CHECKING, Union, Optional
+from typing import TYPE_CHECKING, Any, Dict, Union, Optional
 from datetime import datetime, timezone, timedelta
 
 import requests
@@ -1246,21 +1247,7 @@ class CatEndpoints:
         pet = pet_data[0]
 
         # Check if food counter needs reset
-        food_reset_time = self._parse_dt(pet.get("food_reset"))
-        if food_reset_time and datetime.now(timezone.utc) >= food_reset_time:
-            # Reset food counter and update next reset time
-            reset_hours = pet.get("time_reset_hours", 24)
-            reset_minutes = pet.get("time_reset_minutes", 0)
-            next_reset = datetime.now(
-                timezone.utc) + timedelta(hours=reset_hours, minutes=reset_minutes)
-
-            self.database_link.update_data_in_table(
-                self.tab_pet,
-                [0, next_reset.isoformat()],
-                ["food_eaten", "food_reset"],
-                where=f"beacon={beacon_id}"
-            )
-            pet["food_eaten"] = 0
+        self._refresh_food_counter(pet, beacon_id)
 
         # Check if pet can receive food
         can_distribute = pet["food_eaten"] < pet["food_max"]
@@ -1363,21 +1350,7 @@ class CatEndpoints:
         pet = pet_data[0]
 
         # Check if food counter needs reset
-        food_reset_time = self._parse_dt(pet.get("food_reset"))
-        if food_reset_time and datetime.now(timezone.utc) >= food_reset_time:
-            # Reset food counter
-            reset_hours = pet.get("time_reset_hours", 24)
-            reset_minutes = pet.get("time_reset_minutes", 0)
-            next_reset = datetime.now(
-                timezone.utc) + timedelta(hours=reset_hours, minutes=reset_minutes)
-
-            self.database_link.update_data_in_table(
-                self.tab_pet,
-                [0, next_reset.isoformat()],
-                ["food_eaten", "food_reset"],
-                where=f"beacon={beacon_id}"
-            )
-            pet["food_eaten"] = 0
+        self._refresh_food_counter(pet, beacon_id)
 
         # Check if pet can receive food
         if pet["food_eaten"] >= pet["food_max"]:
@@ -1508,6 +1481,367 @@ class CatEndpoints:
         )
         return HCI.created(bod)
 
+    async def post_feeder_visit_batch(self, request: Request) -> Response:
+        """Register every visit a feeder buffered since its last upload (called by the feeder itself).
+
+        The feeder coalesces the sightings of each beacon (first seen, last
+        seen, sample count and mean RSSI) and sends them together instead of
+        one post_feeder_visit per beacon and per scan. Each visit becomes one
+        location history line, created when the beacon was first seen and
+        edited when it was last seen. The feeder has no clock, the times are
+        sent as ages counted back from the request.
+
+        The feeder authenticates with the token of its owner, a feeder of
+        another account is reported as not found.
+
+        Args:
+            request (Request): The incoming request with the feeder MAC, the buffered visits and the owner token.
+
+        Returns:
+            Response: The number of visits recorded and of beacons the feeder owner does not have.
+        """
+        title = "post_feeder_visit_batch"
+        data = self._user_connected(request, title)
+        if isinstance(data, Response):
+            return data
+        body = await self.boilerplate_incoming_initialised.get_body(request)
+
+        elems = ["feeder_mac", "visits"]
+        for elem in elems:
+            if elem not in body:
+                return self.boilerplate_responses_initialised.missing_variable_in_body(title, data.token, elem)
+        if not isinstance(body["visits"], list):
+            return self.boilerplate_responses_initialised.bad_request(title, data.token)
+
+        feeder_data = self.database_link.get_data_from_table(
+            self.tab_feeder,
+            ["id", "owner"],
+            f"owner={data.user_id} AND mac='{body['feeder_mac']}'",
+            beautify=True
+        )
+        if not isinstance(feeder_data, list) or len(feeder_data) == 0:
+            return HCI.not_found(
+                self.boilerplate_responses_initialised.build_response_body(
+                    title,
+                    "Feeder not found",
+                    "not_found",
+                    data.token,
+                    error=True
+                )
+            )
+        feeder_id = feeder_data[0]["id"]
+
+        beacon_data = self.database_link.get_data_from_table(
+            self.tab_beacon,
+            ["id", "mac"],
+            f"owner={feeder_data[0]['owner']}",
+            beautify=True
+        )
+        if not isinstance(beacon_data, list):
+            return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+        beacon_ids = {
+            self._normalise_mac(row["mac"]): row["id"] for row in beacon_data if row.get("mac")
+        }
+
+        location_cols = self.database_link.get_table_column_names(
+            self.tab_location_history)
+        if not isinstance(location_cols, list):
+            return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+        location_cols = CONST.clean_list(
+            location_cols, self.cols_to_remove, self.disp)
+        location_cols.extend(["creation_date", "edit_date"])
+
+        _now = datetime.now()  # tz=self.forced_timezone
+        rows = []
+        unknown = 0
+        for entry in body["visits"]:
+            if not isinstance(entry, dict) or "mac" not in entry:
+                continue
+            beacon_id = beacon_ids.get(self._normalise_mac(str(entry["mac"])))
+            if beacon_id is None:
+                unknown += 1
+                continue
+            try:
+                first_ms_ago = max(int(entry.get("first_ms_ago", 0)), 0)
+                last_ms_ago = max(int(entry.get("last_ms_ago", 0)), 0)
+            except (TypeError, ValueError):
+                first_ms_ago = 0
+                last_ms_ago = 0
+            first_seen = self.database_link.datetime_to_string(
+                _now - timedelta(milliseconds=first_ms_ago), False, True)
+            last_seen = self.database_link.datetime_to_string(
+                _now - timedelta(milliseconds=min(last_ms_ago, first_ms_ago)), False, True)
+            rows.append([beacon_id, feeder_id, first_seen, last_seen])
+
+        # Every visit of the batch goes in with a single insert
+        if len(rows) > 0:
+            resp = self.database_link.insert_data_into_table(
+                self.tab_location_history,
+                rows,
+                location_cols
+            )
+            if resp == self.database_link.error:
+                return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+
+        bod = self.boilerplate_responses_initialised.build_response_body(
+            title,
+            "Feeder visits recorded successfully",
+            {"recorded": len(rows), "unknown": unknown},
+            data.token,
+            error=False
+        )
+        return HCI.success(bod)
+
+    @staticmethod
+    def _normalise_mac(mac: str) -> str:
+        """Bring a MAC address to the 12 upper case hex digits the feeders report.
+
+        Args:
+            mac (str): The MAC address, with or without separators.
+
+        Returns:
+            str: The normalised MAC address.
+        """
+        return "".join(c for c in str(mac) if c not in ":-. ").upper()
+
+    async def get_feeder_beacons(self, request: Request) -> Response:
+        """Get the MAC addresses of the beacons the owner of a feeder registered (called by the feeder itself).
+
+        The list is sorted and versioned by an ETag, a feeder sending back the
+        version it holds in If-None-Match gets an empty 304 while nothing changed.
+
+        The feeder authenticates with the token of its owner, a feeder of
+        another account is reported as not found.
+
+        Args:
+            request (Request): The incoming request with the feeder MAC and the owner token.
+
+        Returns:
+            Response: The beacon list, or 304 when the feeder is up to date.
+        """
+        title = "get_feeder_beacons"
+        data = self._user_connected(request, title)
+        if isinstance(data, Response):
+            return data
+        body = await self.boilerplate_incoming_initialised.get_body(request)
+
+        if "feeder_mac" not in body:
+            return self.boilerplate_responses_initialised.missing_variable_in_body(title, data.token, "feeder_mac")
+
+        feeder_data = self.database_link.get_data_from_table(
+            self.tab_feeder,
+            ["owner"],
+            f"owner={data.user_id} AND mac='{body['feeder_mac']}'",
+            beautify=True
+        )
+        if not isinstance(feeder_data, list) or len(feeder_data) == 0:
+            return HCI.not_found(
+                self.boilerplate_responses_initialised.build_response_body(
+                    title,
+                    "Feeder not found",
+                    "not_found",
+                    data.token,
+                    error=True
+                )
+            )
+
+        beacon_data = self.database_link.get_data_from_table(
+            self.tab_beacon,
+            ["mac"],
+            f"owner={feeder_data[0]['owner']}",
+            beautify=True
+        )
+        if not isinstance(beacon_data, list):
+            return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+
+        beacons = sorted({
+            self._normalise_mac(row["mac"]) for row in beacon_data if row.get("mac")
+        })
+        digest = hashlib.sha256(",".join(beacons).encode("utf-8")).hexdigest()[:16]
+        etag = f'"{digest}"'
+        headers = {"ETag": etag}
+
+        if request.headers.get("If-None-Match") == etag:
+            return HCI.not_modified(headers=headers)
+
+        bod = self.boilerplate_responses_initialised.build_response_body(
+            title,
+            "The beacons of the feeder owner have been gathered",
+            {"beacons": beacons, "version": etag},
+            data.token,
+            error=False
+        )
+        return HCI.success(bod, headers=headers)
+
+    def _refresh_food_counter(self, pet: Dict[str, Any], beacon_id: int) -> None:
+        """Reset the food counter of a pet whose reset time has passed.
+
+        Args:
+            pet (Dict[str, Any]): The pet row, food_eaten is updated in place.
+            beacon_id (int): The id of the beacon carried by the pet.
+        """
+        food_reset_time = self._parse_dt(pet.get("food_reset"))
+        if food_reset_time and datetime.now(timezone.utc) >= food_reset_time:
+            reset_hours = pet.get("time_reset_hours", 24)
+            reset_minutes = pet.get("time_reset_minutes", 0)
+            next_reset = datetime.now(
+                timezone.utc) + timedelta(hours=reset_hours, minutes=reset_minutes)
+
+            self.database_link.update_data_in_table(
+                self.tab_pet,
+                [0, next_reset.isoformat()],
+                ["food_eaten", "food_reset"],
+                where=f"beacon={beacon_id}"
+            )
+            pet["food_eaten"] = 0
+
+    async def post_feed_plan(self, request: Request) -> Response:
+        """Record the visits of every beacon near a feeder and decide who gets fed (called by the feeder itself).
+
+        One request replaces the visit, fed check and fed update round-trips
+        the feeder used to send for each beacon. The beacons are served from
+        the strongest smoothed RSSI (closest to the bowl) to the weakest, each
+        pet below its daily limit gets one portion, capped by max_portion, and
+        the portion is booked on the pet right away.
+
+        The feeder authenticates with the token of its owner, a feeder of
+        another account is reported as not found.
+
+        Args:
+            request (Request): The incoming request with the feeder MAC, the nearby beacons and the owner token.
+
+        Returns:
+            Response: The ordered portions the feeder must distribute.
+        """
+        title = "post_feed_plan"
+        data = self._user_connected(request, title)
+        if isinstance(data, Response):
+            return data
+        body = await self.boilerplate_incoming_initialised.get_body(request)
+
+        elems = ["feeder_mac", "beacons"]
+        for elem in elems:
+            if elem not in body:
+                return self.boilerplate_responses_initialised.missing_variable_in_body(title, data.token, elem)
+        if not isinstance(body["beacons"], list):
+            return self.boilerplate_responses_initialised.bad_request(title, data.token)
+
+        feeder_data = self.database_link.get_data_from_table(
+            self.tab_feeder,
+            ["id", "owner"],
+            f"owner={data.user_id} AND mac='{body['feeder_mac']}'",
+            beautify=True
+        )
+        if not isinstance(feeder_data, list) or len(feeder_data) == 0:
+            return HCI.not_found(
+                self.boilerplate_responses_initialised.build_response_body(
+                    title,
+                    "Feeder not found",
+                    "not_found",
+                    data.token,
+                    error=True
+                )
+            )
+        feeder_id = feeder_data[0]["id"]
+
+        # Only the beacons of the feeder owner are considered, whatever separators they were registered with
+        beacon_data = self.database_link.get_data_from_table(
+            self.tab_beacon,
+            ["id", "mac"],
+            f"owner={feeder_data[0]['owner']}",
+            beautify=True
+        )
+        if not isinstance(beacon_data, list):
+            return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+        beacon_ids = {
+            self._normalise_mac(row["mac"]): row["id"] for row in beacon_data if row.get("mac")
+        }
+
+        nearby = []
+        for entry in body["beacons"]:
+            if not isinstance(entry, dict) or "mac" not in entry:
+                continue
+            try:
+                rssi = int(entry.get("rssi", -127))
+            except (TypeError, ValueError):
+                rssi = -127
+            nearby.append((rssi, str(entry["mac"])))
+        nearby.sort(key=lambda item: item[0], reverse=True)
+
+        max_portion = body.get("max_portion")
+        location_cols = self.database_link.get_table_column_names(
+            self.tab_location_history)
+        if not isinstance(location_cols, list):
+            return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+        location_cols = CONST.clean_list(
+            location_cols, self.cols_to_remove, self.disp)
+
+        # Feeders that upload their visits through post_feeder_visit_batch ask for none here
+        record_visits = body.get("record_visits", True) is not False
+        portions = []
+        visits = 0
+        for rssi, mac in nearby:
+            beacon_id = beacon_ids.get(self._normalise_mac(mac))
+            if beacon_id is None:
+                continue
+
+            if record_visits:
+                resp = self.database_link.insert_data_into_table(
+                    self.tab_location_history,
+                    [beacon_id, feeder_id],
+                    location_cols
+                )
+                if resp == self.database_link.error:
+                    return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+                visits += 1
+
+            pet_data = self.database_link.get_data_from_table(
+                self.tab_pet,
+                [
+                    "food_eaten", "food_max", "food_reset",
+                    "time_reset_hours", "time_reset_minutes"
+                ],
+                f"beacon={beacon_id}",
+                beautify=True
+            )
+            if not isinstance(pet_data, list) or len(pet_data) == 0:
+                continue
+
+            pet = pet_data[0]
+            self._refresh_food_counter(pet, beacon_id)
+            amount = pet["food_max"] - pet["food_eaten"]
+            if isinstance(max_portion, int) and max_portion > 0:
+                amount = min(amount, max_portion)
+            if amount <= 0:
+                continue
+
+            resp = self.database_link.update_data_in_table(
+                self.tab_pet,
+                [pet["food_eaten"] + amount],
+                ["food_eaten"],
+                where=f"beacon={beacon_id}"
+            )
+            if resp == self.database_link.error:
+                return self.boilerplate_responses_initialised.internal_server_error(title, data.token)
+            portions.append({"beacon_mac": mac, "amount": amount, "rssi": rssi})
+
+        raw_content = {
+            "portions": portions,
+            "visits": visits
+        }
+        cleaned_content = EN_CONST.sanitize_response_data(
+            raw_content, disp=self.disp
+        )
+
+        bod = self.boilerplate_responses_initialised.build_response_body(
+            title,
+            "The feeding plan has been decided",
+            cleaned_content,
+            data.token,
+            error=False
+        )
+        return HCI.success(bod)
+
     async def put_register_pet(self, request: Request) -> Response:
         """Register a new pet linked to a beacon.
 
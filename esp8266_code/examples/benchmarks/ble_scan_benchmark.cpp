@@ -0,0 +1,199 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ble_scan_benchmark.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the native benchmark measuring BLE scan-to-decision latency, detection rate and discovery parsing cost of the AT+DISC? and AT+DISI? scans against the AT-09 emulator.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "at09_emulator.hpp"
+#include "arduino_shim.hpp"
+#include "ble_handler.hpp"
+#include "config.hpp"
+#include "pins.hpp"
+
+// Built by `pio run -e native_ble_scan_benchmark`, run `.pio/build/native_ble_scan_benchmark/program [max_beacons] [baud]`
+
+using BluetoothLE::DiscoveryMode;
+using BluetoothLE::Emulation::AT09Emulator;
+using BluetoothLE::Emulation::Dialect;
+using BluetoothLE::Emulation::EmulatedBeacon;
+using BluetoothLE::Emulation::EmulatorConfig;
+
+struct ScanResult {
+    DiscoveryMode mode;         // What the scan actually used, AT+DISI? falls back to AT+DISC? on CC41
+    uint16_t population;
+    uint16_t in_range;          // Beacons at or above BLE_MIN_VALID_RSSI_VALUE
+    uint8_t reported;
+    uint8_t reported_in_range;  // Reported devices that really are in range
+    uint8_t misread;            // Reported as in range while they are not (no RSSI in the line)
+    uint8_t overflow;
+    uint32_t evicted;           // Weaker devices replaced by a stronger one once the table was full
+    uint64_t scan_us;           // Virtual time spent in startScan() + finishScan()
+    int64_t decision_us;        // Virtual time until a near beacon was handed to the caller (-1 = never)
+    int64_t last_near_us;       // Virtual time until the last beacon really in range was reported (-1 = none)
+    uint64_t host_ns;           // Wall time spent by the host CPU in startScan() + finishScan()
+    uint64_t reply_bytes;
+    uint64_t dropped_bytes;
+};
+
+struct DecisionProbe {
+    uint64_t start_us;
+    int64_t decision_us;
+    int64_t last_near_us;
+    const AT09Emulator *module;
+};
+
+static const EmulatedBeacon *find_beacon(const AT09Emulator &module, const BluetoothLE::MacAddress &address)
+{
+    for (const EmulatedBeacon &beacon : module.beacons()) {
+        BluetoothLE::MacAddress candidate;
+        if (candidate.parse(beacon.address, 12) && candidate == address) {
+            return &beacon;
+        }
+    }
+    return nullptr;
+}
+
+static void note_near(const BluetoothLE::BLEDevice &device, DecisionProbe *probe)
+{
+    const EmulatedBeacon *truth = find_beacon(*probe->module, device.address);
+    if (truth != nullptr && truth->rssi >= BLE_MIN_VALID_RSSI_VALUE) {
+        probe->last_near_us = static_cast<int64_t>(ArduinoShim::Clock::now_us() - probe->start_us);
+    }
+}
+
+// Same early exit as the firmware: stop at the first beacon close enough to the bowl
+static bool on_device(const BluetoothLE::BLEDevice &device, void *context)
+{
+    DecisionProbe *probe = static_cast<DecisionProbe *>(context);
+    note_near(device, probe);
+    if (BluetoothLE::BeaconRecord::normalise_rssi(device.rssi, device.tx_power) < BLE_MIN_VALID_RSSI_VALUE) {
+        return false;
+    }
+    probe->decision_us = static_cast<int64_t>(ArduinoShim::Clock::now_us() - probe->start_us);
+    return true;
+}
+
+// Rest of the window, after the decision
+static bool on_late_device(const BluetoothLE::BLEDevice &device, void *context)
+{
+    note_near(device, static_cast<DecisionProbe *>(context));
+    return false;
+}
+
+static ScanResult run_scan(const Dialect dialect, const DiscoveryMode mode, const uint32_t baud, const uint16_t population, const uint32_t seed)
+{
+    ArduinoShim::Clock::reset();
+    EmulatorConfig config;
+    config.dialect = dialect;
+    config.baud = baud;
+    config.scan_window_ms = BLE_PERIODIC_SCAN_DURATION;
+    config.enable_pin = Pins::BLE_EN_PIN;
+    AT09Emulator module(config);
+    module.populate(population, seed);
+    ArduinoShim::Wiring::connect(Pins::BLE_RXD_PIN, &module);
+
+    BluetoothLE::BLEHandler ble(baud);
+    ble.init();
+    ble.enable();
+    ble.setDiscoveryMode(mode);
+    module.reset_stats();
+
+    const uint64_t start_us = ArduinoShim::Clock::now_us();
+    DecisionProbe probe = { start_us, -1, -1, &module };
+    const auto wall_start = std::chrono::steady_clock::now();
+    ble.startScan(BLE_PERIODIC_SCAN_DURATION, on_device, &probe);
+    ble.finishScan(on_late_device, &probe);
+    const auto wall_end = std::chrono::steady_clock::now();
+    const uint64_t end_us = ArduinoShim::Clock::now_us();
+
+    ScanResult result = {};
+    result.mode = ble.getDiscoveryMode();
+    result.population = population;
+    for (const EmulatedBeacon &beacon : module.beacons()) {
+        if (beacon.rssi >= BLE_MIN_VALID_RSSI_VALUE) {
+            result.in_range++;
+        }
+    }
+    result.reported = ble.getDeviceCount();
+    result.overflow = ble.getOverflowCount();
+    result.evicted = ble.getRetentionStats().evicted;
+    const BluetoothLE::BLEDevice *devices = ble.getScannedDevices();
+    for (uint8_t i = 0; i < result.reported; ++i) {
+        const EmulatedBeacon *truth = find_beacon(module, devices[i].address);
+        const bool near = truth != nullptr && truth->rssi >= BLE_MIN_VALID_RSSI_VALUE;
+        if (near) {
+            result.reported_in_range++;
+        } else if (BluetoothLE::BeaconRecord::normalise_rssi(devices[i].rssi, devices[i].tx_power) >= BLE_MIN_VALID_RSSI_VALUE) {
+            result.misread++;
+        }
+    }
+    result.scan_us = end_us - start_us;
+    result.decision_us = probe.decision_us;
+    result.last_near_us = probe.last_near_us;
+    result.host_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count());
+    result.reply_bytes = module.stats().bytes_to_host;
+    result.dropped_bytes = module.stats().bytes_dropped;
+
+    ArduinoShim::Wiring::disconnect(Pins::BLE_RXD_PIN);
+    return result;
+}
+
+static double to_ms(const int64_t us)
+{
+    return (us < 0) ? -1.0 : us / 1000.0;
+}
+
+int main(int argc, char **argv)
+{
+    const uint16_t max_beacons = (argc > 1) ? static_cast<uint16_t>(std::strtoul(argv[1], nullptr, 10)) : 256;
+    const uint32_t baud = (argc > 2) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : BLUETOOTH_BAUDRATE;
+    const Dialect dialects[] = { Dialect::HMSoft, Dialect::CC41, Dialect::Extended };
+    const DiscoveryMode modes[] = { DiscoveryMode::Names, DiscoveryMode::Advertisement };
+
+    ArduinoShim::set_console_echo(false);
+    printf("BLE scan benchmark: window %lu ms, %lu baud, MAX_BLE_DEVICES %u (%u bytes + %u bytes of names + %u bytes of UUIDs), RSSI threshold %d dBm\n",
+        BLE_PERIODIC_SCAN_DURATION, static_cast<unsigned long>(baud), static_cast<unsigned>(MAX_BLE_DEVICES),
+        static_cast<unsigned>(MAX_BLE_DEVICES * sizeof(BluetoothLE::BLEDevice)), static_cast<unsigned>(sizeof(BluetoothLE::NamePool)),
+        static_cast<unsigned>(sizeof(BluetoothLE::BeaconUuidPool)), BLE_MIN_VALID_RSSI_VALUE);
+    printf("%-9s %-5s %6s %6s %8s %9s %7s %8s %8s %8s %10s %12s %13s %9s %8s %9s\n",
+        "dialect", "mode", "beacons", "near", "reported", "near_rep", "detect", "misread", "overflow", "evicted",
+        "scan_ms", "decision_ms", "last_near_ms", "rx_bytes", "dropped", "ns/byte");
+    for (const Dialect dialect : dialects) {
+        for (const DiscoveryMode mode : modes) {
+            for (uint16_t population = 8; population <= max_beacons; population *= 2) {
+                const ScanResult r = run_scan(dialect, mode, baud, population, 1234 + population);
+                const double ns_per_byte = (r.reply_bytes > 0) ? static_cast<double>(r.host_ns) / static_cast<double>(r.reply_bytes) : 0.0;
+                const double detect = (r.in_range > 0) ? 100.0 * r.reported_in_range / r.in_range : 100.0;
+                printf("%-9s %-5s %6u %6u %8u %9u %6.1f%% %8u %8u %8u %10.1f %12.1f %13.1f %9llu %8llu %9.1f\n",
+                    BluetoothLE::Emulation::dialect_name(dialect), (r.mode == DiscoveryMode::Advertisement) ? "DISI" : "DISC",
+                    r.population, r.in_range, r.reported, r.reported_in_range, detect, r.misread, r.overflow, r.evicted,
+                    r.scan_us / 1000.0, to_ms(r.decision_us), to_ms(r.last_near_us),
+                    static_cast<unsigned long long>(r.reply_bytes), static_cast<unsigned long long>(r.dropped_bytes), ns_per_byte);
+                if (population > max_beacons / 2) {
+                    break;
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: scan_duty_benchmark.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is a benchmark comparing the radio time and the detection latency of the scan duty cycle policies.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "arduino_shim.hpp"
+#include "config.hpp"
+#include "scan_duty_cycle.hpp"
+
+// Built by `pio run -e native_scan_duty_benchmark`, run `.pio/build/native_scan_duty_benchmark/program [days]`
+//
+// A cat walks up to the feeder: its collar is heard (weak RSSI) for the
+// approach, then it sits at the bowl. The firmware only acts once a window
+// overlaps the time at the bowl, the latency is measured from the arrival at
+// the bowl to the first advertisement heard inside such a window. Every
+// policy replays the same visits.
+
+static constexpr uint32_t APPROACH_MS = 45000;       // Collar heard before the cat reaches the bowl
+static constexpr uint32_t AT_BOWL_MS = 90000;        // Time spent eating
+static constexpr uint32_t ADVERTISING_MS = 1000;     // Collar advertising interval
+static constexpr uint32_t MEAN_VISIT_GAP_MS = 7200000;  // A visit every 2 hours on average
+static constexpr uint32_t RETURN_GAP_MS = 300000;    // Cats often come back within 5 minutes
+static constexpr uint32_t RETURN_PERCENT = 30;
+
+struct Visit {
+    uint64_t heard_ms;      // Start of the approach
+    uint64_t bowl_ms;       // Arrival at the bowl
+    uint64_t leave_ms;
+};
+
+struct PolicyResult {
+    uint32_t scans;
+    uint64_t radio_ms;
+    uint32_t detected;
+    uint32_t missed;
+    double mean_latency_ms;
+    uint32_t p95_latency_ms;
+    uint32_t worst_latency_ms;
+};
+
+static uint32_t next_random(uint32_t &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static std::vector<Visit> make_visits(const uint64_t duration_ms, uint32_t seed)
+{
+    std::vector<Visit> visits;
+    uint64_t now = 0;
+    while (true) {
+        const bool returning = !visits.empty() && next_random(seed) % 100 < RETURN_PERCENT;
+        const uint32_t mean_gap = returning ? RETURN_GAP_MS : MEAN_VISIT_GAP_MS;
+        now += (next_random(seed) % (2 * mean_gap)) + 1;
+        Visit visit = { now, now + APPROACH_MS, now + APPROACH_MS + AT_BOWL_MS };
+        if (visit.leave_ms >= duration_ms) {
+            break;
+        }
+        visits.push_back(visit);
+        now = visit.leave_ms;
+    }
+    return visits;
+}
+
+static PolicyResult run_policy(BluetoothLE::ScanDutyCycle &duty, const std::vector<Visit> &visits, const uint64_t duration_ms)
+{
+    std::vector<uint32_t> latencies;
+    size_t next_visit = 0;
+    bool detected = false;
+    uint32_t missed = 0;
+    uint64_t now = 0;
+    while (now < duration_ms) {
+        if (!duty.due(static_cast<uint32_t>(now))) {
+            now += BLE_SCAN_TICK_INTERVAL;
+            continue;
+        }
+        const uint64_t start = now;
+        const uint64_t end = start + duty.window_ms();
+        duty.started(static_cast<uint32_t>(start));
+
+        // Visits over before this window were either detected or missed
+        while (next_visit < visits.size() && visits[next_visit].leave_ms <= start) {
+            if (!detected) {
+                missed++;
+            }
+            next_visit++;
+            detected = false;
+        }
+        bool known_seen = false;
+        if (next_visit < visits.size()) {
+            const Visit &visit = visits[next_visit];
+            // The first advertisement of the window, or the first one after the cat sat down
+            const uint64_t heard = std::max(start + ADVERTISING_MS, visit.heard_ms + ADVERTISING_MS);
+            known_seen = heard <= end && heard < visit.leave_ms;
+            const uint64_t at_bowl = std::max(heard, visit.bowl_ms + ADVERTISING_MS);
+            if (!detected && at_bowl <= end && at_bowl < visit.leave_ms) {
+                detected = true;
+                latencies.push_back(static_cast<uint32_t>(at_bowl - visit.bowl_ms));
+            }
+        }
+        duty.finished(static_cast<uint32_t>(end), known_seen);
+        now = end;
+    }
+    for (; next_visit < visits.size(); ++next_visit) {
+        if (!detected) {
+            missed++;
+        }
+        detected = false;
+    }
+
+    PolicyResult result = {};
+    result.scans = duty.stats().scans;
+    result.radio_ms = duty.stats().radio_ms;
+    result.detected = static_cast<uint32_t>(latencies.size());
+    result.missed = missed;
+    if (!latencies.empty()) {
+        uint64_t total = 0;
+        for (const uint32_t latency : latencies) {
+            total += latency;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        result.mean_latency_ms = static_cast<double>(total) / latencies.size();
+        result.p95_latency_ms = latencies[(latencies.size() * 95) / 100 < latencies.size() ? (latencies.size() * 95) / 100 : latencies.size() - 1];
+        result.worst_latency_ms = latencies.back();
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t days = (argc > 1) ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 7;
+    const uint64_t duration_ms = static_cast<uint64_t>(days) * 24ULL * 3600000ULL;
+    const std::vector<Visit> visits = make_visits(duration_ms, 42);
+
+    struct Policy {
+        const char *name;
+        uint32_t min_interval_ms;
+        uint32_t max_interval_ms;
+        BluetoothLE::ScanMode mode;
+    };
+    const Policy policies[] = {
+        { "fixed-min", BLE_SCAN_MIN_INTERVAL, BLE_SCAN_MIN_INTERVAL, BluetoothLE::ScanMode::Fixed },
+        { "fixed-30s", 30000, 30000, BluetoothLE::ScanMode::Fixed },
+        { "fixed-max", BLE_SCAN_MAX_INTERVAL, BLE_SCAN_MAX_INTERVAL, BluetoothLE::ScanMode::Fixed },
+        { "adaptive", BLE_SCAN_MIN_INTERVAL, BLE_SCAN_MAX_INTERVAL, BluetoothLE::ScanMode::Adaptive },
+    };
+
+    ArduinoShim::set_console_echo(false);
+    printf("Scan duty cycle benchmark: %u day(s), %u visits, window %lu ms, approach %u ms, %u ms at the bowl\n",
+        days, static_cast<unsigned>(visits.size()), BLE_PERIODIC_SCAN_DURATION, APPROACH_MS, AT_BOWL_MS);
+    printf("%-10s %8s %8s %10s %9s %7s %14s %12s %13s\n",
+        "policy", "interval", "scans", "radio_ms/h", "duty_%", "missed", "mean_latency", "p95_latency", "worst_latency");
+    for (const Policy &policy : policies) {
+        BluetoothLE::ScanDutyCycle duty(BLE_PERIODIC_SCAN_DURATION, policy.min_interval_ms, policy.max_interval_ms, policy.mode);
+        const PolicyResult r = run_policy(duty, visits, duration_ms);
+        const double hours = duration_ms / 3600000.0;
+        char interval[24];
+        if (policy.min_interval_ms == policy.max_interval_ms) {
+            snprintf(interval, sizeof(interval), "%lus", static_cast<unsigned long>(policy.min_interval_ms / 1000));
+        } else {
+            snprintf(interval, sizeof(interval), "%lu-%lus", static_cast<unsigned long>(policy.min_interval_ms / 1000), static_cast<unsigned long>(policy.max_interval_ms / 1000));
+        }
+        printf("%-10s %8s %8u %10.0f %9.2f %7u %12.1f s %10.1f s %11.1f s\n",
+            policy.name, interval, r.scans, r.radio_ms / hours, 100.0 * r.radio_ms / duration_ms, r.missed,
+            r.mean_latency_ms / 1000.0, r.p95_latency_ms / 1000.0, r.worst_latency_ms / 1000.0);
+    }
+    return 0;
+}
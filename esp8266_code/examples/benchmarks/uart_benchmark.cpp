@@ -0,0 +1,152 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: uart_benchmark.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the benchmark comparing the SoftwareSerial and hardware UART links to the BLE module.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <HardwareSerial.h>
+#include <SoftwareSerial.h>
+#include "arduino_shim.hpp"
+#include "config.hpp"
+#include "leds.hpp"
+#include "pins.hpp"
+
+// Built by `pio run -e native_uart_benchmark`, run `.pio/build/native_uart_benchmark/program [bytes]`
+//
+// A peer streams AT-09 style discovery lines back-to-back while the firmware
+// drains the port from its loop and refreshes the LED strip, whose show()
+// keeps interrupts off for the whole WS2812 frame. Both links are measured on
+// the same traffic: SoftwareSerial on GPIO12/13 and UART0 swapped onto GPIO13/15.
+
+static const char REPLY[] = "OK+DISA:A1B2C3D4E5F6:Collar:-058\r\n";
+
+class StreamingModule : public ArduinoShim::SerialPeer
+{
+    public:
+    StreamingModule(const uint32_t baud, const uint32_t total, const uint64_t start_us)
+        : _frame_us((10ULL * 1000000ULL + baud - 1) / baud), _total(total), _start_us(start_us)
+    {
+    }
+
+    void on_host_byte(const uint8_t byte, const uint64_t now_us) override {}
+
+    void service(ArduinoShim::SerialPort &port, const uint64_t now_us) override
+    {
+        while (_sent < _total) {
+            const uint64_t stop_bit_us = _start_us + (_sent + 1) * _frame_us;
+            if (stop_bit_us > now_us) {
+                break;
+            }
+            port.deliver(static_cast<uint8_t>(REPLY[_sent % (sizeof(REPLY) - 1)]), stop_bit_us);
+            _sent++;
+        }
+    }
+
+    bool done() const { return _sent >= _total; }
+    uint64_t end_us() const { return _start_us + _total * _frame_us; }
+
+    private:
+    uint64_t _frame_us;
+    uint32_t _total;
+    uint64_t _start_us;
+    uint32_t _sent = 0;
+};
+
+struct LinkResult {
+    uint64_t received;
+    uint32_t overflowed;    // Dropped because the RX buffer was full
+    uint32_t corrupted;     // Misread or lost while interrupts were off
+    double kbytes_per_s;    // Bytes handed to the firmware per second of stream
+    double tx_ms_per_kb;    // CPU time blocked writing 1 KB of commands
+};
+
+static LinkResult run_link(ArduinoShim::SerialPort &port, const uint8_t rx_pin, const uint32_t baud, const uint32_t total,
+    const uint32_t poll_us, const uint32_t render_ms)
+{
+    ArduinoShim::Clock::reset();
+    ArduinoShim::Interrupts::reset();
+    StreamingModule module(baud, total, 0);
+    ArduinoShim::Wiring::connect(rx_pin, &module);
+
+    LinkResult result = {};
+    uint64_t next_render_us = 0;
+    uint64_t received = 0;
+    // Firmware loop: other tasks take poll_us between two reads of the port
+    while (!module.done() || port.available() > 0) {
+        while (port.available() > 0) {
+            port.read();
+            received++;
+        }
+        if (render_ms > 0 && ArduinoShim::Clock::now_us() >= next_render_us) {
+            LED::LedStrip.show();
+            next_render_us += static_cast<uint64_t>(render_ms) * 1000;
+        }
+        ArduinoShim::Clock::advance_us(poll_us);
+    }
+    result.received = received;
+    result.overflowed = port.rx_overflow_count();
+    result.corrupted = port.rx_corrupted_count();
+    result.kbytes_per_s = static_cast<double>(received) / (static_cast<double>(module.end_us()) / 1000000.0) / 1000.0;
+
+    ArduinoShim::Wiring::disconnect(rx_pin);
+    const uint64_t tx_start = ArduinoShim::Clock::now_us();
+    for (uint16_t i = 0; i < 1024; ++i) {
+        port.write(static_cast<uint8_t>('A'));
+    }
+    result.tx_ms_per_kb = (ArduinoShim::Clock::now_us() - tx_start) / 1000.0;
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t total = (argc > 1) ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 8192;
+    const uint32_t bauds[] = { 9600, 38400, 115200 };
+    const uint32_t renders_ms[] = { 0, LED_RENDER_INTERVAL, 20 };
+    const uint32_t poll_us = FEEDER_TICK_INTERVAL * 1000;  // A loop pass with the scheduler ticking the feeder
+
+    ArduinoShim::set_console_echo(false);
+    printf("UART benchmark: %u bytes streamed, port drained every %u us, %u LEDs (show() = %u us with interrupts off)\n",
+        total, poll_us, static_cast<unsigned>(LED_NUMBER), LED::LedStrip.show_time_us());
+    printf("%-8s %7s %9s %9s %8s %9s %7s %9s %11s\n",
+        "link", "baud", "render_ms", "received", "overflow", "corrupted", "loss%", "kB/s", "tx_ms/KB");
+    for (const uint32_t baud : bauds) {
+        for (const uint32_t render_ms : renders_ms) {
+            SoftwareSerial soft(Pins::BLE_RXD_PIN, Pins::BLE_TXD_PIN);
+            soft.begin(baud);
+            const LinkResult sw = run_link(soft, soft.rx_pin(), baud, total, poll_us, render_ms);
+
+            Serial.begin(baud);
+            Serial.swap();
+            const LinkResult hw = run_link(Serial, Serial.rx_pin(), baud, total, poll_us, render_ms);
+            Serial.end();
+
+            const struct { const char *name; const LinkResult &r; } rows[] = { { "software", sw }, { "uart0", hw } };
+            for (const auto &row : rows) {
+                const double loss = 100.0 * static_cast<double>(total - row.r.received + row.r.corrupted) / total;
+                printf("%-8s %7u %9u %9llu %8u %9u %7.2f %9.2f %11.1f\n",
+                    row.name, baud, render_ms, static_cast<unsigned long long>(row.r.received), row.r.overflowed, row.r.corrupted,
+                    loss, row.r.kbytes_per_s, row.r.tx_ms_per_kb);
+            }
+        }
+    }
+    return 0;
+}
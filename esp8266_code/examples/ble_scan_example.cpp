@@ -47,6 +47,7 @@ void example_setup()
     }
 
     // Print module information
+    bleHandler.refreshModuleInfo();
     bleHandler.printStatus();
 
     // Optional: Perform initial scan
@@ -100,7 +100,8 @@ namespace MyUtils
             static void disable(Component c);
 
             static void activity(const Component c, const bool active = true);
-            static void data_transmission(const Component comp, const uint8_t size);
+            static void data_transmission(const Component comp, const uint8_t size);  // Raise the traffic bar to `size` LEDs
+            static void traffic(const Component comp, const size_t bytes);  // Hot path: only counts, render() turns the bytes into the bar
 
             static void set_colour(Component &c, const LED::Colour &colour);
             static void set_position(Component &c, uint16_t pos);
@@ -119,6 +120,13 @@ namespace MyUtils
             static LED::ColourPos _nodes[
                 static_cast<size_t>(Component::_COUNT)
             ];
+
+            // Traffic meter: bytes counted since the last render, bar height in 1/16 of a LED
+            static uint16_t _traffic_bytes[static_cast<size_t>(Component::_COUNT)];
+            static uint8_t _traffic_level[static_cast<size_t>(Component::_COUNT)];
+            static uint32_t _traffic_decayed_ms;
+            static void _update_traffic(const uint32_t now);
+            static void _draw_traffic(const size_t node_idx);
         };
 
         void initialise_active_components();
@@ -0,0 +1,91 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: at_response_parser.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the byte-at-a-time parser for the AT-09 responses.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "ble_AT_quickies.hpp"
+
+namespace BluetoothLE
+{
+    /**
+     * @brief Kind of token completed by the parser.
+     */
+    enum class ATEvent : uint8_t {
+        None = 0,       // Nothing complete yet
+        Ok,             // OK
+        Error,          // ERROR...
+        DiscoveryStart, // OK+DISCS, OK+DISIS
+        Device,         // OK+DISC:..., OK+DIS0:..., OK+DISA:...
+        DiscoveryEnd,   // OK+DISCE
+        Accepted,       // OK+CONNA, more is coming
+        Connected,      // OK+CONN
+        ConnectFailed,  // OK+CONNF
+        Lost,           // OK+LOST
+        Value,          // Any other OK+xxx or +xxx answer (OK+Get:1, +ROLE=1, OK+NAME:...)
+        Line            // Anything else
+    };
+
+    /**
+     * @brief Incremental tokenizer for the module replies.
+     *
+     * Bytes are fed one at a time into a fixed line buffer. A token ends on
+     * CR/LF, on flush() (idle line), or when a fixed-size token such as
+     * OK+DISCS or OK+DIS0:<address> is directly followed by the next "O",
+     * which is how HMSoft firmwares chain their replies without separators.
+     * The completed token stays readable through line() until the next feed.
+     * Lines longer than the buffer are truncated and flagged.
+     */
+    class ATResponseParser
+    {
+        public:
+        ATEvent feed(const uint8_t byte);
+        ATEvent flush();    // Complete whatever is buffered (the line went idle)
+        void reset();
+
+        bool pending() const;           // Bytes buffered without a completed token
+        const char *line() const;       // Last completed token, null-terminated
+        size_t length() const;
+        bool truncated() const;         // The last token did not fit in the buffer
+        ATEvent last_event() const;
+
+        static bool is_terminal(const ATEvent event);   // Ends the reply to a command
+
+        static constexpr size_t LINE_BUFFER_SIZE = 80;  // Longest OK+DISA line with a 31 char name and the 78 char AT+DISI? line fit
+
+        private:
+        void _begin_token();
+        ATEvent _emit();
+        bool _is_complete_token() const;
+        bool _is(const std::string_view &token) const;
+        bool _starts_with(const std::string_view &prefix) const;
+        ATEvent _classify() const;
+
+        char _buffer[LINE_BUFFER_SIZE] = {};
+        size_t _length = 0;
+        bool _emitted = false;
+        bool _truncated = false;
+        char _carry = '\0';     // First byte of the next token, seen while splitting chained replies
+        ATEvent _event = ATEvent::None;
+    };
+}
@@ -0,0 +1,84 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: beacon_allowlist.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the list of beacons the feeder is allowed to report, synced from the control server.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+#include "ble_structs.hpp"
+#include "my_overloads.hpp"
+
+namespace BluetoothLE
+{
+    /**
+     * @brief Counters describing how the allowlist filters the sightings.
+     */
+    struct BeaconAllowlistStats {
+        uint32_t syncs = 0;         // Successful round-trips with the control server
+        uint32_t not_modified = 0;  // Syncs answered 304, the list was already current
+        uint32_t failures = 0;      // Syncs that did not reach the server or could not be read
+        uint32_t truncated = 0;     // Beacons of the last update that did not fit BEACON_ALLOWLIST_CAPACITY
+        uint32_t allowed = 0;       // Sightings that went on to the server
+        uint32_t filtered = 0;      // Sightings dropped without any HTTP traffic
+    };
+
+    /**
+     * @brief Sorted array of the beacon MAC addresses registered to the owner of the feeder.
+     *
+     * The control server hands out the list together with a version (its
+     * ETag), sent back on the next sync so an unchanged list costs an empty
+     * 304 instead of the whole array. Lookups are a binary search over the
+     * raw 6 byte addresses. Until a first sync succeeded the list is unknown
+     * and allows() lets every device through, as the feeder did before.
+     */
+    class BeaconAllowlist
+    {
+        public:
+        static constexpr size_t VERSION_SIZE = 40;  // ETag, quotes included, null terminator included
+
+        bool contains(const MacAddress &address) const;
+        bool allows(const MacAddress &address);  // contains(), or true while never synced, counted in the stats
+
+        bool replace(const MacAddress *addresses, const uint8_t count, const char *version, const uint32_t received = 0);  // Sorts and deduplicates a fresh list
+        void confirm();         // The server answered 304, the list is current
+        void record_failure();
+
+        bool synced() const;
+        const char *version() const;  // "" until the first sync
+        uint8_t count() const;
+        const MacAddress *entries() const;  // Sorted ascending
+        static constexpr uint8_t capacity() { return BEACON_ALLOWLIST_CAPACITY; }
+
+        const BeaconAllowlistStats &stats() const;
+        void clear();
+        void print() const;
+
+        private:
+        static int _compare(const MacAddress &left, const MacAddress &right);
+
+        MacAddress _entries[BEACON_ALLOWLIST_CAPACITY];
+        uint8_t _count = 0;
+        bool _synced = false;
+        char _version[VERSION_SIZE] = { '\0' };
+        BeaconAllowlistStats _stats;
+    };
+}
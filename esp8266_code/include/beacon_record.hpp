@@ -0,0 +1,83 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: beacon_record.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the iBeacon record read from the AT+DISI? discovery lines.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "ble_structs.hpp"
+#include "ble_constants.hpp"
+
+namespace BluetoothLE
+{
+    /**
+     * @brief Identity of a device as reported by an AT+DISI? discovery line.
+     *
+     * "OK+DISC:4C000215:<32 hex UUID>:<4 hex major><4 hex minor><2 hex TX>:<12 hex MAC>:-058"
+     * The fields have a fixed width, so the line is read by position instead
+     * of searching for the separators. Devices that are not iBeacons are
+     * reported with a zeroed factory id and UUID, they keep their MAC and RSSI.
+     */
+    struct BeaconRecord {
+        static constexpr size_t UUID_SIZE = 16;
+        static constexpr size_t UUID_HEX_LENGTH = UUID_SIZE * 2;
+
+        MacAddress address;
+        uint8_t uuid[UUID_SIZE] = { 0 };
+        uint16_t major = 0;
+        uint16_t minor = 0;
+        int8_t tx_power = 0;    // Measured power at 1 m in dBm (0 = not advertised)
+        int8_t rssi = -127;
+        bool ibeacon = false;   // Apple iBeacon factory id, the identifiers are meaningful
+
+        bool parse(const char *line, size_t length);  // False when the line is not a valid AT+DISI? line
+        bool matches(const uint8_t *filter_uuid, int32_t filter_major = -1, int32_t filter_minor = -1) const;  // -1 = any value
+        uint16_t distance_cm() const;
+
+        static bool is_advertisement_line(const char *line, size_t length);  // Tells AT+DISI? lines from the name based ones
+        static bool parse_uuid(const char *hex, size_t length, uint8_t *uuid);  // 32 hex digits, dashes allowed
+        static int8_t normalise_rssi(int8_t rssi, int8_t tx_power);  // RSSI the device would show at Constants::REFERENCE_TX_POWER
+        static uint16_t estimate_distance_cm(int8_t rssi, int8_t tx_power);  // Log-distance path loss, 0 when tx_power is unknown
+    };
+
+    /**
+     * @brief Fixed buffer storing every distinct iBeacon UUID of a scan once.
+     *
+     * The beacons of a household share one or two UUIDs (one per brand of
+     * tag), so each device keeps a one byte identifier instead of 16 bytes.
+     */
+    class BeaconUuidPool
+    {
+        public:
+        uint8_t intern(const uint8_t *uuid);       // Identifier of the UUID, BLEDevice::NO_UUID when full
+        const uint8_t *get(const uint8_t id) const;  // nullptr for BLEDevice::NO_UUID or an unknown identifier
+        void clear();
+
+        uint8_t count() const;
+        uint16_t rejected() const;  // UUIDs dropped because the pool was full
+
+        private:
+        uint8_t _uuids[Constants::MAX_BEACON_UUIDS][BeaconRecord::UUID_SIZE];
+        uint8_t _count = 0;
+        uint16_t _rejected = 0;
+    };
+}
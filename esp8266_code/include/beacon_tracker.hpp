@@ -0,0 +1,117 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: beacon_tracker.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the table tracking the beacons seen around the feeder across scans.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+#include "ble_structs.hpp"
+#include "my_overloads.hpp"
+
+namespace BluetoothLE
+{
+    /**
+     * @brief Presence change caused by an observation or by expire().
+     */
+    enum class BeaconTransition : uint8_t {
+        None = 0,
+        Entered,    // The smoothed RSSI climbed over BEACON_ENTER_RSSI
+        Left        // The smoothed RSSI fell under BEACON_LEAVE_RSSI or the beacon went silent
+    };
+
+    /**
+     * @brief Everything remembered about one beacon between scans.
+     *
+     * The RSSI is kept as an exponentially weighted moving average in 1/16 dBm
+     * so a single weak or strong sample does not flip the presence state.
+     */
+    struct TrackedBeacon {
+        MacAddress address;             // Raw MAC address (hashed and compared as 6 bytes)
+        int16_t rssi_x16 = 0;           // Smoothed RSSI, 1/16 dBm
+        int8_t last_rssi = -127;        // Latest raw sample (dBm)
+        bool present = false;           // Hysteresis state, true between Entered and Left
+        bool used = false;              // Slot holds a beacon
+        uint16_t sightings = 0;         // Scans that reported the beacon
+        uint32_t first_seen_ms = 0;
+        uint32_t last_seen_ms = 0;
+        uint32_t entered_ms = 0;        // Latest Entered transition
+        uint32_t last_reported_ms = 0;  // Latest mark_reported(), 0 = never reported while present
+
+        int8_t rssi() const;            // Smoothed RSSI rounded to the nearest dBm
+    };
+
+    /**
+     * @brief Counters describing how the tracker behaves over time.
+     */
+    struct BeaconTrackerStats {
+        uint32_t observations = 0;  // Samples fed to observe()
+        uint32_t probes = 0;        // Slots inspected by lookups, probes / observations = average chain length
+        uint32_t entered = 0;
+        uint32_t left = 0;
+        uint32_t forgotten = 0;     // Slots released after BEACON_FORGET_TIMEOUT_MS of silence
+        uint32_t dropped = 0;       // Samples ignored because the table was full
+    };
+
+    /**
+     * @brief Fixed-size hash table of the beacons seen around the feeder.
+     *
+     * Beacons are keyed by MAC address with open addressing (linear probing),
+     * so a sample is matched to its beacon in O(1) without walking the scan
+     * results. Presence uses two thresholds: a beacon enters when its smoothed
+     * RSSI reaches BEACON_ENTER_RSSI and only leaves once it drops under
+     * BEACON_LEAVE_RSSI or stays silent for BEACON_LEAVE_TIMEOUT_MS, which
+     * stops a cat sitting at the edge of the range from flapping.
+     */
+    class BeaconTracker
+    {
+        static_assert((BEACON_TRACKER_CAPACITY & (BEACON_TRACKER_CAPACITY - 1)) == 0, "BEACON_TRACKER_CAPACITY must be a power of two");
+
+        public:
+        static constexpr uint8_t MAX_TRACKED = (BEACON_TRACKER_CAPACITY / 4) * 3;  // Load factor kept under 3/4
+
+        BeaconTransition observe(const MacAddress &address, const int8_t rssi, const uint32_t now_ms, const TrackedBeacon **entry = nullptr);
+        uint8_t expire(const uint32_t now_ms);  // Apply the silence timeouts, returns the beacons that left
+
+        const TrackedBeacon *find(const MacAddress &address) const;
+        bool mark_reported(const MacAddress &address, const uint32_t now_ms);  // The application acted on the beacon
+        bool retry_report(const MacAddress &address, const uint32_t now_ms);   // Acting failed, due again after BEACON_REPORT_RETRY_INTERVAL
+
+        uint8_t count() const;
+        uint8_t present_count() const;
+        const TrackedBeacon *slot(const uint8_t index) const;  // Raw table access for listings (check `used`)
+        static constexpr uint8_t capacity() { return BEACON_TRACKER_CAPACITY; }
+
+        const BeaconTrackerStats &stats() const;
+        void clear();
+        void print() const;
+
+        private:
+        static uint8_t _hash(const MacAddress &address);
+        int16_t _lookup(const MacAddress &address, uint8_t *probes = nullptr) const;  // Slot holding the address, -1 if absent
+        void _remove(uint8_t index);                 // Backward shift deletion, keeps the probe chains intact
+        BeaconTransition _leave(TrackedBeacon &beacon, const uint32_t now_ms, const char *reason);
+
+        TrackedBeacon _slots[BEACON_TRACKER_CAPACITY];
+        uint8_t _count = 0;
+        BeaconTrackerStats _stats;
+    };
+}
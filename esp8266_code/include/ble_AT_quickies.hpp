@@ -54,6 +54,7 @@ namespace BluetoothLE
         {
             inline constexpr std::string_view NAME = "AT+NAME";      // append new name + AT_NEWLINE
             inline constexpr std::string_view PASS = "AT+PASS";      // append PIN + AT_NEWLINE
+            inline constexpr std::string_view BAUD = "AT+BAUD";      // append the Constants::BAUD_RATES index + AT_NEWLINE
             inline constexpr std::string_view ROLE_SLAVE = "AT+ROLE0" AT_NEWLINE;
             inline constexpr std::string_view ROLE_MASTER = "AT+ROLE1" AT_NEWLINE;
         }
@@ -65,6 +66,7 @@ namespace BluetoothLE
             inline constexpr std::string_view SLEEP = "AT+SLEEP" AT_NEWLINE;
             inline constexpr std::string_view DISCOVER = "AT+DISC?" AT_NEWLINE;
             inline constexpr std::string_view DISCOVER_ALT = "AT+DISC" AT_NEWLINE;  // Alternative without '?'
+            inline constexpr std::string_view DISCOVER_IBEACON = "AT+DISI?" AT_NEWLINE;  // Advertisement data, no name resolution
             inline constexpr std::string_view CONNECT = "AT+CON";    // append MAC + AT_NEWLINE
         }
 
@@ -75,13 +77,19 @@ namespace BluetoothLE
             {
                 inline constexpr std::string_view OK = "OK";
                 inline constexpr std::string_view CONN = "OK+CONN";
+                inline constexpr std::string_view CONN_ACCEPTED = "OK+CONNA";  // Connection attempt started
+                inline constexpr std::string_view CONN_FAILED = "OK+CONNF";
                 inline constexpr std::string_view LOST = "OK+LOST";
                 inline constexpr std::string_view DISC = "OK+DISC:";
                 inline constexpr std::string_view DIS = "OK+DIS";     // Covers OK+DIS0, OK+DISA, etc.
                 inline constexpr std::string_view DISCS = "OK+DISCS";
+                inline constexpr std::string_view DISCE = "OK+DISCE";  // End of the discovery window
+                inline constexpr std::string_view DISIS = "OK+DISIS";  // Start of an AT+DISI? window, its lines use the OK+DISC: prefix
                 inline constexpr std::string_view NAME = "OK+NAME:";
                 inline constexpr std::string_view ADDR = "OK+ADDR:";
                 inline constexpr std::string_view VERS = "OK+VERS:";
+                inline constexpr std::string_view SLEEP = "OK+SLEEP";
+                inline constexpr std::string_view WAKE = "OK+WAKE";   // Sent once the wake-up string woke the module
                 inline constexpr std::string_view ROLE = "OK+Get:";   // Response to role query (generic)
 
                 namespace Role
@@ -114,6 +122,7 @@ namespace BluetoothLE
  *   AT+ADDR?        - Get MAC address
  *   AT+VERS?        - Get firmware version
  *   AT+BAUD?        - Get baud rate
+ *   AT+BAUDn        - Set baud rate (0=9600, 1=19200, 2=38400, 3=57600, 4=115200)
  *
  * Role Management:
  *   AT+ROLE?        - Get role (0=Slave/Peripheral, 1=Master/Central)
@@ -122,12 +131,14 @@ namespace BluetoothLE
  *
  * Scanning & Connection (Master mode only):
  *   AT+DISC?        - Start device discovery
+ *   AT+DISI?        - Discovery from the advertisement data (OK+DISIS, then
+ *                     OK+DISC:<factory>:<UUID>:<major><minor><tx>:<MAC>:<RSSI>, then OK+DISCE)
  *   AT+CONxxxxxxxxxxxx - Connect to device by MAC (12 hex digits)
  *   AT              - Disconnect from current device
  *
  * Power & Reset:
  *   AT+RESET        - Reset module
- *   AT+SLEEP        - Enter sleep mode
+ *   AT+SLEEP        - Enter sleep mode (OK+SLEEP), a string longer than 80 bytes wakes it (OK+WAKE)
  *
  * Pin & Security:
  *   AT+PASS?        - Get pairing PIN
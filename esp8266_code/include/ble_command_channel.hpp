@@ -0,0 +1,123 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ble_command_channel.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the framed binary command protocol spoken with a phone paired over bluetooth.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace BluetoothLE
+{
+    /*
+     * Frames exchanged with the paired phone, all integers little endian:
+     *   request:  0xA5 | opcode | seq | length | payload[length] | crc8
+     *   response: 0x5A | opcode | seq | status | length | payload[length] | crc8
+     * The CRC-8 (polynomial 0x07, init 0x00) covers everything between the
+     * start byte and the checksum. `seq` is chosen by the phone and echoed
+     * back so it can match replies to requests.
+     */
+    namespace Protocol
+    {
+        inline constexpr uint8_t REQUEST_START = 0xA5;
+        inline constexpr uint8_t RESPONSE_START = 0x5A;
+        inline constexpr uint8_t MAX_PAYLOAD = 32;
+        inline constexpr size_t MAX_RESPONSE_SIZE = 5 + MAX_PAYLOAD + 1;
+        inline constexpr uint32_t FRAME_TIMEOUT_MS = 200;  // A frame whose bytes stop arriving for that long is dropped
+        inline constexpr uint8_t DEVICES_PER_PAGE = 4;     // 7 bytes per device after the 2 byte page header
+
+        enum class Opcode : uint8_t {
+            Ping = 0x01,        // Payload echoed back
+            Status = 0x02,      // u32 uptime_ms, u32 heap_free, u8 role, u8 devices, u8 present beacons, u8 feeding, u8 allowlist size
+            Devices = 0x03,     // Request: u8 offset. Response: u8 total, u8 offset, then (6 byte MAC, i8 rssi) per device of the last scan
+            Connect = 0x04,     // Request: 6 byte MAC, waits for the module like connectToDevice()
+            Feed = 0x05,        // Request: u16 grams. Response: u16 grams dispensed (clamped to MAX_FEEDING_SINGLE_PORTION)
+            Hello = 0x06        // Response: board name
+        };
+
+        enum class Status : uint8_t {
+            Ok = 0x00,
+            Busy = 0x01,            // The feeder or the module is already doing something
+            Failed = 0x02,
+            BadLength = 0x03,       // Payload size wrong for the opcode, or longer than MAX_PAYLOAD
+            BadChecksum = 0x04,
+            UnknownOpcode = 0x05
+        };
+
+        struct CommandFrame {
+            uint8_t opcode = 0;
+            uint8_t seq = 0;
+            uint8_t length = 0;
+            uint8_t payload[MAX_PAYLOAD] = {};
+        };
+
+        struct CommandStats {
+            uint32_t frames = 0;            // Valid requests dispatched
+            uint32_t rejected = 0;          // Requests answered with an error status
+            uint32_t bad_checksum = 0;
+            uint32_t stray_bytes = 0;       // Bytes skipped while looking for a start byte
+            uint32_t timeouts = 0;          // Partial frames dropped after FRAME_TIMEOUT_MS
+            uint32_t last_dispatch_us = 0;  // Parse of the last byte to response ready
+            uint32_t worst_dispatch_us = 0;
+        };
+
+        uint8_t crc8(const uint8_t *data, const size_t length, uint8_t crc = 0);
+    }
+
+    /**
+     * @brief Byte-at-a-time reader and dispatcher of the phone commands.
+     *
+     * Bytes go through a small state machine into a fixed frame, nothing is
+     * allocated and a command cannot match inside another one's payload. A
+     * complete frame is dispatched through a switch on its opcode and the
+     * binary response is written into the caller's buffer.
+     */
+    class CommandChannel
+    {
+        public:
+        size_t feed(const uint8_t byte, const uint32_t now_ms, uint8_t *response, const size_t response_size);  // Response length, 0 while no frame is complete
+        void reset();
+        const Protocol::CommandStats &stats() const;
+
+        private:
+        enum class State : uint8_t {
+            Start,
+            Opcode,
+            Seq,
+            Length,
+            Payload,
+            Checksum
+        };
+
+        size_t _dispatch(uint8_t *response, const size_t response_size);
+        static size_t _encode(const Protocol::CommandFrame &request, const Protocol::Status status, const uint8_t *payload, const uint8_t length, uint8_t *response, const size_t response_size);
+        static uint8_t _status(uint8_t *payload);
+        static uint8_t _devices(const Protocol::CommandFrame &request, uint8_t *payload);
+        static Protocol::Status _connect(const Protocol::CommandFrame &request);
+        static Protocol::Status _feed(const Protocol::CommandFrame &request, uint8_t *payload);
+
+        State _state = State::Start;
+        Protocol::CommandFrame _frame;
+        uint8_t _received = 0;          // Payload bytes received so far
+        uint32_t _last_byte_ms = 0;
+        Protocol::CommandStats _stats;
+    };
+}
@@ -45,16 +45,51 @@ namespace BluetoothLE
         // Timing delays (milliseconds)
         inline constexpr uint32_t POWER_UP_DELAY_MS = 100;            // Module power-up stabilization time
         inline constexpr uint32_t ROLE_CHANGE_DELAY_MS = 500;         // Delay after changing module role (needs time to stabilize)
+        inline constexpr uint32_t ROLE_REPLY_TIMEOUT_MS = 1000;       // Silence after AT+ROLE<n> before the switch is considered failed
+        inline constexpr uint32_t SLEEP_REPLY_TIMEOUT_MS = 500;       // Silence after AT+SLEEP before the module is considered awake
         inline constexpr uint32_t SERIAL_REINIT_DELAY_MS = 50;        // Delay for serial reinitialization
         inline constexpr uint32_t SERIAL_STABILIZE_DELAY_MS = 50;     // Serial stabilization delay
         inline constexpr uint32_t RESPONSE_TRAILING_DELAY_MS = 50;    // Delay to catch trailing response characters
         inline constexpr uint32_t RESPONSE_POLL_DELAY_MS = 10;        // Polling interval when reading responses
+        inline constexpr uint32_t RESPONSE_IDLE_FLUSH_MS = 20;        // Silence after which an unterminated token is considered complete
 
-        // Data size limits
-        inline constexpr uint8_t MAX_TRANSMISSION_SIZE = 255;         // Maximum size for LED transmission indicator
+        // Baud rates selectable with AT+BAUD<index>, slowest first
+        inline constexpr uint32_t BAUD_RATES[] = { 9600, 19200, 38400, 57600, 115200 };
+        inline constexpr uint8_t BAUD_RATE_COUNT = sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]);
+        inline constexpr size_t COMMAND_BAUD_LENGTH = AT::Set::BAUD.size() + 1 + AT::NEWLINE.size();  // "AT+BAUD" + index + "\r\n", no null
+        inline constexpr uint8_t BAUD_VERIFY_ATTEMPTS = 3;            // Consecutive "AT" round-trips a new baud rate must survive
+        inline constexpr size_t DISCOVERY_LINE_BYTES = 38;            // "OK+DISA:<12 hex>:<10 char name>:-058\r\n"
+
+        // Advertisement data discovery (AT+DISI?)
+        inline constexpr size_t DISI_LINE_LENGTH = 78;                // "OK+DISC:<8 hex>:<32 hex>:<10 hex>:<12 hex>:-058", no line ending
+        inline constexpr uint8_t MAX_BEACON_UUIDS = 8;                // Distinct iBeacon UUIDs per scan, a household rarely has more than one brand
+        inline constexpr int8_t REFERENCE_TX_POWER = -59;             // Measured power at 1 m the RSSI thresholds are calibrated for
+        inline constexpr float PATH_LOSS_EXPONENT = 2.0f;             // Free space, the bowl area is mostly line of sight
+
+        // Connection state, AT-09 STATE line read through the ADC (0-1023)
+        inline constexpr uint16_t STATE_CONNECTED_LEVEL = 700;        // Reading at or above which the link is up
+        inline constexpr uint16_t STATE_DISCONNECTED_LEVEL = 300;     // Reading at or below which the link is down, in between the state holds
+
+        // Sleep between scan windows
+        inline constexpr size_t WAKE_SEQUENCE_LENGTH = 81;            // The module wakes on a string longer than 80 bytes
+        inline constexpr char WAKE_FILLER = 'W';                      // Content of the wake-up string, never a valid command
+        inline constexpr uint32_t WAKE_TIMEOUT_MS = 200;              // Silence after the wake-up string before giving up on OK+WAKE
+        inline constexpr uint32_t WAKE_DEFAULT_LEAD_MS = 100;         // Wake-up lead before the first latency was measured
+        inline constexpr uint8_t SLEEP_MAX_REFUSALS = 3;              // AT+SLEEP answered with an error that many times in a row = unsupported
+
+        // Asynchronous command queue
+        inline constexpr uint8_t AT_QUEUE_SIZE = 8;                   // Commands waiting or running
+        inline constexpr size_t QUEUED_COMMAND_SIZE = 32;             // Longest queued command, "AT+NAME" + 20 chars + "\r\n" fits
+        inline constexpr uint8_t AT_SLICE_MAX_EVENTS = 4;             // Tokens handled by one service() call
+
+        // Names advertised during a scan, interned once per scan
+        inline constexpr size_t NAME_POOL_SIZE = 256;                 // Bytes shared by all the names of a scan
+        inline constexpr uint8_t MAX_INTERNED_NAMES = 32;             // Distinct names per scan
+        inline constexpr size_t MAX_DEVICE_NAME_LENGTH = 31;          // Longer advertised names are cut
 
         // Maximum name length
         inline constexpr size_t MAX_NAME_LENGTH = 20;
+        inline constexpr size_t MAX_VERSION_LENGTH = 23;              // "HMSoft V605" and the longer clone strings
         inline constexpr size_t COMMAND_NAME_LENGTH = (sizeof(AT::Set::NAME) - 1) + MAX_NAME_LENGTH + (sizeof(AT::NEWLINE) - 1) + 1; // "AT+NAME" + name + "\r\n" + null
     }
 }
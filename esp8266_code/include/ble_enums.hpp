@@ -38,4 +38,24 @@ namespace BluetoothLE
         UNKNOWN
     };
 
+    // Where the command at the head of the asynchronous queue stands
+    enum class ATQueuePhase : uint8_t {
+        Idle,       // Nothing sent, the next service() starts the head of the queue
+        Reply,      // Waiting for the reply of a command (or of the role switch of a scan)
+        Settle,     // Role just switched, discovery starts once the module is ready
+        Discovery   // Devices are ingested as their lines arrive
+    };
+
+    // How ScanDutyCycle spaces the scans
+    enum class ScanMode : uint8_t {
+        Fixed,      // One window every interval, whatever is around
+        Adaptive    // Minimum interval while known beacons are around, backs off while the area stays idle
+    };
+
+    // Which discovery command the scans send
+    enum class DiscoveryMode : uint8_t {
+        Names,          // AT+DISC?, the module resolves the device names
+        Advertisement   // AT+DISI?, identifiers and TX power read from the advertisement data
+    };
+
 }
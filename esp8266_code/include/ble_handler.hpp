@@ -32,6 +32,10 @@
 #include "ble_enums.hpp"
 #include "ble_structs.hpp"
 #include "ble_AT_quickies.hpp"
+#include "ble_constants.hpp"
+#include "ble_name_pool.hpp"
+#include "beacon_record.hpp"
+#include "at_response_parser.hpp"
 
 #include "leds.hpp"
 #include "pins.hpp"
@@ -44,6 +48,49 @@
 
 namespace BluetoothLE
 {
+    /**
+     * @brief Called by startScan() for every device as soon as its discovery line ends.
+     *
+     * The device already sits in the scan table when the callback runs.
+     * Returning true stops the ingestion right away so the caller can act on
+     * a known beacon before the scan window closes, the rest of the window is
+     * collected by finishScan() (or automatically before the next command).
+     */
+    typedef bool (*DeviceFoundCallback)(const BLEDevice &device, void *context);
+
+    /**
+     * @brief Tells whether a scanned device must stay in the scan table whatever its RSSI.
+     */
+    typedef bool (*KnownDeviceFilter)(const MacAddress &address, void *context);
+
+    /**
+     * @brief Called by sampleConnection() when a central connects or disconnects.
+     */
+    typedef void (*ConnectionChangeCallback)(bool connected, void *context);
+
+    /**
+     * @brief Called by service() once a queued command or scan is over.
+     *
+     * `response` holds the reply tokens separated by "\r\n" and is only valid
+     * during the call. It is empty for a scan, whose devices are read with
+     * getScannedDevices(). The queue slot is already released, so the
+     * callback may enqueue the next command.
+     */
+    typedef void (*ATCompletionCallback)(ATCommandResult result, const char *response, size_t length, void *context);
+
+    /**
+     * @brief Entry of the asynchronous command queue.
+     */
+    struct ATQueuedCommand {
+        char command[Constants::QUEUED_COMMAND_SIZE];  // Line ending included, not null terminated
+        uint8_t length = 0;
+        bool scan = false;              // Discovery job, command is unused
+        uint32_t timeout_ms = 1000;     // Silence after which the command gives up
+        ATCompletionCallback on_done = nullptr;
+        DeviceFoundCallback on_device = nullptr;  // Scans only, its return value is ignored
+        void *context = nullptr;
+    };
+
     class BLEHandler {
         public:
         BLEHandler(uint32_t baud = 9600);
@@ -52,7 +99,10 @@ namespace BluetoothLE
         void init();            // setup pins and serial
         void enable();          // turn on BLE module
         void disable();         // turn off BLE module
-        bool isConnected() const;   // read BLE_STATE pin
+        bool isConnected() const;   // Cached state, refreshed by sampleConnection()
+        bool sampleConnection(uint32_t now_ms);  // Read BLE_STATE_PIN, at most once per BLE_STATE_SAMPLE_MIN_GAP
+        void setConnectionCallback(ConnectionChangeCallback on_change, void *context = nullptr);
+        const ConnectionStateStats &getConnectionStats() const;
 
         // Send/receive - buffer versions (no heap allocation)
         void send(const char *data, size_t length);  // send char array over BLE
@@ -69,11 +119,37 @@ namespace BluetoothLE
 
         // String versions (for diagnostics/convenience)
         String sendATCommand(const std::string_view &cmd, uint32_t timeout_ms = 1000);
-        String getModuleName();
-        String getModuleAddress();
-        String getVersion();
-        BLERole getRole();
-        bool setRole(BLERole role);
+        String getModuleName();      // From the module info snapshot, refreshed first while unknown
+        String getModuleAddress();   // From the module info snapshot, refreshed first while unknown
+        String getVersion();         // From the module info snapshot, refreshed first while unknown
+        bool refreshModuleInfo();    // Read name, address and version into the snapshot, false if one is missing
+        const ModuleInfo &getModuleInfo() const;
+        BLERole getRole();           // Query the module and refresh the cached role
+        bool setRole(BLERole role);  // No-op when the cached role already matches
+        BLERole getCachedRole() const;
+
+        // Batched configuration: commands are sent back-to-back, each reply is checked before the next one
+        uint8_t runPipeline(ATPipelineStep *steps, uint8_t count);  // Number of steps that succeeded before the first failure
+
+        // Role churn accounting
+        const RoleChurnStats &getRoleChurnStats() const;
+        uint32_t getRoleChurnMsPerHour() const;  // Role churn time scaled to one hour of uptime
+
+        // Asynchronous commands: queued, then advanced a slice at a time by service() from loop()
+        bool enqueueCommand(const std::string_view &cmd, ATCompletionCallback on_done, void *context = nullptr, uint32_t timeout_ms = 1000);
+        bool enqueueScan(uint32_t timeout_ms, DeviceFoundCallback on_device, ATCompletionCallback on_done, void *context = nullptr);
+        void service();                 // Never waits, handles at most Constants::AT_SLICE_MAX_EVENTS tokens
+        bool isQueueBusy() const;       // A command is running or waiting
+        uint8_t getQueueDepth() const;
+        const ATQueueStats &getQueueStats() const;
+
+        // Sleep between scan windows
+        bool sleep();           // Queue AT+SLEEP, false when the module is busy, connected or does not support it
+        bool wake();            // Send the wake-up string now (blocking), true once the module answered or was awake
+        bool isAsleep() const;
+        uint32_t getWakeLeadMs() const;  // How long before a window wake() must be called so the scan starts on time
+        const ModuleSleepStats &getSleepStats() const;
+        uint32_t getRadioOnMsPerHour() const;  // Time the module was awake, scaled to one hour of uptime
 
         // Slave/Peripheral mode configuration
         bool setModuleName(const char *name);                         // Set BLE device name (uses buffer)
@@ -81,13 +157,23 @@ namespace BluetoothLE
         bool setupSlaveMode(const char *device_name = nullptr);       // Configure module for peripheral mode
         bool waitForConnection(uint32_t timeout_ms = 0);              // Wait for incoming connection (0 = no timeout)
         bool hasIncomingData();                                        // Check if data is available to read
-        void monitorConnection();                                      // Check and log connection state changes
+        void monitorConnection();                                      // sampleConnection() at the current time
 
         // Scanning operations
-        bool startScan(uint32_t timeout_ms = 5000);  // Start BLE device discovery
+        bool startScan(uint32_t timeout_ms = 5000, DeviceFoundCallback on_device = nullptr, void *context = nullptr);  // Start BLE device discovery
+        void finishScan(DeviceFoundCallback on_device = nullptr, void *context = nullptr);  // Resume a scan stopped early by its callback
+        bool isScanPending() const;                  // True while the module is still reporting a stopped scan
         const BLEDevice *getScannedDevices() const;  // Get pointer to device array
         uint8_t getDeviceCount() const;              // Get number of devices found
-        uint8_t getOverflowCount() const;            // Get number of devices lost due to overflow
+        uint8_t getOverflowCount() const;            // Devices of the last scan that were evicted or not kept
+        void setKnownDeviceFilter(KnownDeviceFilter filter, void *context = nullptr);  // Known devices are never evicted
+        const ScanRetentionStats &getRetentionStats() const;
+        int8_t getWeakestKeptRssi() const;           // Next eviction threshold of a full table (-127 when nothing is evictable)
+        const char *getDeviceName(const BLEDevice &device) const;  // Advertised name ("" when none)
+        void setDiscoveryMode(DiscoveryMode mode);   // Used from the next scan on
+        DiscoveryMode getDiscoveryMode() const;      // Mode of the next scan, Names once the module refused AT+DISI?
+        bool setBeaconUuidFilter(const char *uuid_hex);  // AT+DISI? scans only keep the iBeacons of that UUID (nullptr or "" = any device)
+        bool getBeaconRecord(const BLEDevice &device, BeaconRecord &record) const;  // False when the device advertised no iBeacon identity
         void clearScannedDevices();                   // Clear the device list
         bool connectToDevice(const char *address);   // Connect by MAC (char array - no allocation)
         bool connectToDevice(const String &address); // Connect by MAC (String - for convenience)
@@ -97,6 +183,11 @@ namespace BluetoothLE
         void reset();           // Reset module to factory defaults
         void printStatus();     // Print module status to Serial
         void changeBaudRate(uint32_t new_baud); // Change baud rate and reinitialize serial
+        uint32_t getBaudRate() const;
+
+        // Baud rate negotiation
+        uint32_t negotiateBaudRate(uint32_t max_baud = BLE_MAX_BAUDRATE);  // Fastest verified baud rate, saved for the next boot (0 = module silent)
+        static uint32_t estimateScanTransferMs(uint32_t baud, uint16_t devices = MAX_BLE_DEVICES);  // Time to receive a full discovery reply
 
         // Diagnostic and testing functions
         void testHardware();    // Print hardware diagnostics (pins, baud rate, basic AT test)
@@ -106,21 +197,88 @@ namespace BluetoothLE
         void printPeriodicScan();      // Run periodic scan and print results with device details
 
         private:
+#ifdef BLE_USE_HARDWARE_UART
+        HardwareSerial &_serial = Serial;  // UART0, swapped onto GPIO13/15 each time it is opened
+#else
         SoftwareSerial _serial;
+#endif
         uint32_t _baud;
         MyUtils::ActiveComponents::Component _ble_component = MyUtils::ActiveComponents::Component::Bluetooth;
         uint16_t _led_index = 0;   // for moving dot animation
         BLEDevice _scanned_devices[MAX_BLE_DEVICES];  // Fixed-size array of discovered devices
+        NamePool _names;                // Names of the devices of the current scan
+        BeaconUuidPool _uuids;          // iBeacon UUIDs of the devices of the current scan
+        DiscoveryMode _discovery_mode = BLE_SCAN_ADVERTISEMENT_DATA ? DiscoveryMode::Advertisement : DiscoveryMode::Names;
+        bool _advertisement_refused = false;  // AT+DISI? answered with an error or silence, scans fall back to AT+DISC?
+        uint8_t _uuid_filter[BeaconRecord::UUID_SIZE] = { 0 };
+        bool _uuid_filter_set = false;
         uint8_t _device_count = 0;      // Number of devices currently stored
-        uint8_t _overflow_count = 0;    // Number of devices lost due to array overflow
+        uint8_t _overflow_count = 0;    // Devices of the current scan evicted or not kept
+        uint8_t _heap[MAX_BLE_DEVICES]; // Min-heap on RSSI of the evictable slots, weakest at the root
+        uint8_t _heap_size = 0;
+        KnownDeviceFilter _known_filter = nullptr;
+        void *_known_context = nullptr;
+        ScanRetentionStats _retention;
         BLERole _current_role = BLERole::Unknown;
-        bool _was_connected = false;    // Track previous connection state for change detection
+        bool _connected = false;        // Filtered STATE line, only sampleConnection() changes it
+        bool _state_sampled = false;    // _state_sampled_ms holds a real sample
+        unsigned long _state_sampled_ms = 0;
+        ConnectionChangeCallback _on_connection_change = nullptr;
+        void *_connection_context = nullptr;
+        ConnectionStateStats _connection_stats;
+        bool _asleep = false;           // AT+SLEEP accepted, the next write must wake the module first
+        bool _sleep_queued = false;     // AT+SLEEP waiting in the command queue
+        uint8_t _sleep_refusals = 0;    // Consecutive AT+SLEEP errors
+        unsigned long _asleep_since_ms = 0;
+        ModuleSleepStats _sleep_stats;
+        ModuleInfo _info;               // Name, address and version last read from or written to the module
+        RoleChurnStats _role_churn;
+        ATResponseParser _parser;       // Tokenizes the module replies as they arrive
+        bool _scan_pending = false;     // A scan was stopped early, the module is still reporting devices
+        uint32_t _scan_timeout_ms = 0;  // Idle timeout of the current scan, reused by finishScan()
+        unsigned long _last_rx_ms = 0;  // Last byte from the module, start of the idle timeout
+        ATQueuedCommand _queue[Constants::AT_QUEUE_SIZE];  // Ring, the head is the running command
+        uint8_t _queue_head = 0;
+        uint8_t _queue_count = 0;
+        ATQueuePhase _job_phase = ATQueuePhase::Idle;
+        bool _job_alt_tried = false;    // Discovery already retried with AT+DISC
+        unsigned long _job_since_ms = 0;  // Start of the current phase
+        char _job_response[Constants::COMMAND_RESPONSE_BUFFER_SIZE] = { '\0' };
+        size_t _job_length = 0;
+        ATQueueStats _queue_stats;
 
         // Helper methods
+        ATEvent _pollEvent();  // Next complete token if the bytes already received hold one, never waits
+        ATEvent _nextEvent(uint32_t idle_timeout_ms);  // Next complete token, ATEvent::None once the line stays silent
+        void _writeCommand(const std::string_view &cmd);  // Drain a pending scan or queued command, then send
+        void _sendRaw(const std::string_view &cmd);       // Flush and send, whatever the module is doing, waking it first
+        static void _onSleepReply(ATCommandResult result, const char *response, size_t length, void *context);
+        void _markAwake();              // Close the current sleep period
+        void _startJob();
+        bool _stepJob();  // False when the running command has nothing to do yet
+        void _onJobEvent(ATEvent event);
+        void _onJobSilence();
+        void _startJobDiscovery(const std::string_view &cmd);
+        std::string_view _discoveryCommand() const;  // AT+DISI? or AT+DISC? depending on the mode
+        bool _refuseAdvertisementData();  // True when the failed discovery was AT+DISI?, later scans use AT+DISC?
+        void _finishJob(ATCommandResult result);
+        void _awaitJob();  // Run the current queued command to completion (blocking)
+        bool _buildNameCommand(const char *name, char *cmd, size_t cmd_size);
+        void _cacheName(const char *name, size_t length);
+        bool _queryValue(const std::string_view &cmd, const std::string_view &prefix, char *value, size_t value_size);  // Copy what follows prefix in the reply
+        ATEvent _ingestDiscovery(uint32_t idle_timeout_ms, DeviceFoundCallback on_device, void *context);
+        const BLEDevice *_commitDevice(const char *line, size_t length);  // Parse a line into a free or evicted slot
+        bool _fillDevice(const BeaconRecord *record, const char *line, size_t length, BLEDevice &device, bool keep_name = true);  // From the record of an AT+DISI? line, else from the line
+        bool _isKnown(const MacAddress &address) const;
+        void _heapSiftUp(uint8_t position);
+        void _heapSiftDown(uint8_t position);
         size_t _readResponseToBuffer(char *buffer, size_t buffer_size, uint32_t timeout_ms);
         String _readResponse(uint32_t timeout_ms);  // String version for convenience
-        BLEDevice _parseDiscoveryLine(const char *line, size_t length);  // Buffer version
-        BLEDevice _parseDiscoveryLine(const String &line);  // String wrapper
+        bool _parseDiscoveryLine(const char *line, size_t length, BLEDevice &device, bool keep_name = true);  // Fills device in place
+        void _openSerial();  // begin() at _baud, plus the UART0 swap in hardware UART mode
+        bool _verifyLink();  // testConnection() succeeds Constants::BAUD_VERIFY_ATTEMPTS times in a row
+        uint32_t _findBaudRate();  // Quiet sweep of Constants::BAUD_RATES, 0 when the module never answers
+        bool _switchModuleBaud(uint8_t index);  // AT+BAUD<index>, then follow the module to its new speed
         void _flushSerial();
     };
 }
@@ -0,0 +1,57 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ble_name_pool.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the pool interning the device names advertised during a scan.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "ble_structs.hpp"
+#include "ble_constants.hpp"
+
+namespace BluetoothLE
+{
+    /**
+     * @brief Fixed buffer storing every distinct device name of a scan once.
+     *
+     * Devices only keep a one byte identifier, most beacons do not advertise a
+     * name and the ones that do often share it (same brand of collar tag), so
+     * the names cost a fraction of a fixed char[32] per device.
+     */
+    class NamePool
+    {
+        public:
+        uint8_t intern(const char *name, size_t length);  // Identifier of the name, BLEDevice::NO_NAME if empty or full
+        const char *get(const uint8_t id) const;          // "" for BLEDevice::NO_NAME or an unknown identifier
+        void clear();
+
+        uint8_t count() const;
+        size_t used_bytes() const;
+        uint16_t rejected() const;  // Names dropped because the pool was full
+
+        private:
+        char _buffer[Constants::NAME_POOL_SIZE];
+        uint16_t _offsets[Constants::MAX_INTERNED_NAMES];
+        uint8_t _count = 0;
+        size_t _used = 0;
+        uint16_t _rejected = 0;
+    };
+}
@@ -0,0 +1,51 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ble_settings.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header for the BLE settings kept in flash across reboots.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+
+namespace BluetoothLE
+{
+    /**
+     * @brief BLE link settings that survive a reboot (EEPROM emulation).
+     *
+     * Only the negotiated baud rate is stored for now, so a restart talks to
+     * the module at the right speed straight away instead of probing for it.
+     */
+    namespace Settings
+    {
+        /**
+         * @brief Record as laid out in flash.
+         */
+        struct BaudRecord {
+            uint16_t magic;
+            uint32_t baud;
+            uint8_t checksum;   // Guards against a half written or foreign sector
+        };
+
+        inline constexpr uint16_t BAUD_RECORD_MAGIC = 0xB1E5;
+
+        uint32_t load_baud_rate();                // 0 when nothing valid was saved
+        bool save_baud_rate(const uint32_t baud); // Skips the flash write when the value is already stored
+    }
+}
@@ -22,28 +22,183 @@
 * +==== END CatFeeder =================+
 */
 #pragma once
+#include <string_view>
 #include <Arduino.h>
+#include "ble_constants.hpp"
 
 namespace BluetoothLE
 {
-    struct BLEDevice {
-        char address[13];    // MAC address (12 hex chars + null terminator)
-        char name[32];       // Device name (max 31 chars + null terminator)
-        int8_t rssi;         // Signal strength in dBm
-        bool valid;          // Whether this entry contains valid data
+    /**
+     * @brief Bluetooth MAC address kept as its 6 raw bytes.
+     *
+     * Comparing and hashing 6 bytes is cheaper than working on the 12 hex
+     * characters, which are only produced at the edges (logs, JSON bodies).
+     */
+    struct MacAddress {
+        static constexpr size_t SIZE = 6;
+        static constexpr size_t HEX_LENGTH = 12;  // to_hex() needs HEX_LENGTH + 1 bytes
+
+        uint8_t bytes[SIZE] = { 0 };
 
-        BLEDevice() : rssi(-127), valid(false)
+        // Read 12 hex digits (either case), false if one of them is not hexadecimal
+        bool parse(const char *hex, size_t length)
         {
-            address[0] = '\0';
-            name[0] = '\0';
+            if (hex == nullptr || length < HEX_LENGTH) {
+                return false;
+            }
+            for (size_t i = 0; i < HEX_LENGTH; ++i) {
+                const char c = hex[i];
+                uint8_t nibble;
+                if (c >= '0' && c <= '9') {
+                    nibble = c - '0';
+                } else if (c >= 'A' && c <= 'F') {
+                    nibble = c - 'A' + 10;
+                } else if (c >= 'a' && c <= 'f') {
+                    nibble = c - 'a' + 10;
+                } else {
+                    return false;
+                }
+                bytes[i / 2] = (i % 2 == 0) ? (nibble << 4) : (bytes[i / 2] | nibble);
+            }
+            return true;
         }
 
-        BLEDevice(const char *addr, const char *n, int8_t r) : rssi(r), valid(true)
+        // Upper case hex, the format the AT-09 reports and the server stores
+        void to_hex(char *out) const
         {
-            strncpy(address, addr, sizeof(address) - 1);
-            address[sizeof(address) - 1] = '\0';
-            strncpy(name, n, sizeof(name) - 1);
-            name[sizeof(name) - 1] = '\0';
+            static const char digits[] = "0123456789ABCDEF";
+            for (size_t i = 0; i < SIZE; ++i) {
+                out[i * 2] = digits[bytes[i] >> 4];
+                out[i * 2 + 1] = digits[bytes[i] & 0x0F];
+            }
+            out[HEX_LENGTH] = '\0';
         }
+
+        // FNV-1a over the raw bytes
+        uint32_t hash() const
+        {
+            uint32_t value = 2166136261u;
+            for (size_t i = 0; i < SIZE; ++i) {
+                value ^= bytes[i];
+                value *= 16777619u;
+            }
+            return value;
+        }
+
+        bool operator==(const MacAddress &other) const { return memcmp(bytes, other.bytes, SIZE) == 0; }
+        bool operator!=(const MacAddress &other) const { return !(*this == other); }
+    };
+
+    // Hex formatting for the logs
+    inline Print &operator<<(Print &out, const MacAddress &address)
+    {
+        char hex[MacAddress::HEX_LENGTH + 1];
+        address.to_hex(hex);
+        out.print(hex);
+        return out;
+    }
+
+    struct BLEDevice {
+        static constexpr uint8_t NO_NAME = 0xFF;
+        static constexpr uint8_t NO_UUID = 0xFF;
+
+        MacAddress address;         // Raw MAC address
+        uint16_t major = 0;         // iBeacon identifiers, AT+DISI? scans only
+        uint16_t minor = 0;
+        int8_t rssi = -127;         // Signal strength in dBm
+        int8_t tx_power = 0;        // Advertised measured power at 1 m in dBm (0 = unknown)
+        uint8_t name_id = NO_NAME;  // Name interned in the scan NamePool (NO_NAME when not advertised)
+        uint8_t uuid_id = NO_UUID;  // UUID interned in the scan BeaconUuidPool (NO_UUID when not an iBeacon)
+        bool valid = false;         // Whether this entry contains valid data
+    };
+
+    /**
+     * @brief Identity of the module, read once instead of on every status dump.
+     *
+     * Filled by refreshModuleInfo() at boot and after reset(), the name is
+     * also updated by a successful setModuleName(). Nothing else changes
+     * these values on the module.
+     */
+    struct ModuleInfo {
+        char name[Constants::MAX_NAME_LENGTH + 1] = { '\0' };
+        char address[MacAddress::HEX_LENGTH + 1] = { '\0' };
+        char version[Constants::MAX_VERSION_LENGTH + 1] = { '\0' };
+        bool name_known = false;      // name mirrors the module
+        bool address_known = false;
+        bool version_known = false;
+        uint32_t refreshes = 0;       // Calls to refreshModuleInfo()
+        uint32_t refreshed_ms = 0;    // millis() at the end of the latest refresh
+        uint32_t refresh_ms = 0;      // Duration of the latest refresh
+    };
+
+    /**
+     * @brief One command of a batched AT pipeline and the outcome of its reply.
+     */
+    struct ATPipelineStep {
+        std::string_view command;       // Full command, line ending included
+        std::string_view expect = "OK"; // Token the reply must contain
+        uint32_t timeout_ms = 1000;     // Silence after which the step is considered failed
+        bool ok = false;                // Filled by runPipeline()
+        uint32_t elapsed_ms = 0;        // Time from sending the command to the end of its reply
+    };
+
+    /**
+     * @brief What happened to the devices that did not fit in the scan table.
+     *
+     * Cumulated over every scan since boot, getOverflowCount() still tells how
+     * many devices the last scan could not keep.
+     */
+    struct ScanRetentionStats {
+        uint32_t evicted = 0;        // Weaker devices replaced by a stronger newcomer
+        uint32_t rejected = 0;       // Newcomers weaker than every evictable device
+        uint32_t known_kept = 0;     // Known devices stored, never candidates for eviction
+        uint32_t known_dropped = 0;  // Known devices lost because the table only held known devices
+        uint32_t identity_filtered = 0;  // Advertisement lines dropped because the beacon UUID did not match the filter
+    };
+
+    /**
+     * @brief Counters of the asynchronous AT command queue.
+     */
+    struct ATQueueStats {
+        uint32_t enqueued = 0;
+        uint32_t rejected = 0;          // Queue full or command too long
+        uint32_t completed = 0;         // Callbacks delivered, whatever the result
+        uint32_t timeouts = 0;
+        uint32_t errors = 0;
+        uint8_t max_depth = 0;
+        uint32_t longest_slice_us = 0;  // Longest single service() call
+    };
+
+    /**
+     * @brief Samples of the STATE line and the connection changes they revealed.
+     */
+    struct ConnectionStateStats {
+        uint32_t samples = 0;       // ADC reads
+        uint32_t rate_limited = 0;  // Sampling requests answered from the cached state
+        uint32_t changes = 0;       // Connections and disconnections
+        uint16_t last_level = 0;    // Latest ADC reading (0-1023)
+    };
+
+    /**
+     * @brief Sleep periods of the module between scan windows.
+     */
+    struct ModuleSleepStats {
+        uint32_t sleeps = 0;         // AT+SLEEP accepted
+        uint32_t refused = 0;        // AT+SLEEP answered with an error or not at all
+        uint32_t wakes = 0;          // Wake-up strings sent
+        uint32_t wake_timeouts = 0;  // Wake-ups that never got OK+WAKE, the module is assumed awake anyway
+        uint32_t last_wake_ms = 0;   // Wake-up string to OK+WAKE, latest
+        uint32_t worst_wake_ms = 0;  // Wake-up string to OK+WAKE, longest
+        uint32_t asleep_ms = 0;      // Completed sleep periods, the current one excluded
+    };
+
+    /**
+     * @brief Time the module spent switching roles instead of scanning or advertising.
+     */
+    struct RoleChurnStats {
+        uint32_t queries = 0;       // AT+ROLE? round-trips
+        uint32_t switches = 0;      // AT+ROLE0/AT+ROLE1 actually sent
+        uint32_t cache_hits = 0;    // Switches avoided because the cached role already matched
+        uint32_t churn_ms = 0;      // Time spent in role queries, switches and their settle delay
     };
 }
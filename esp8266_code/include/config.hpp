@@ -43,6 +43,8 @@ inline constexpr char NTFY_TOPIC[] = "[NTFY_TOPIC]";
 
 // Control server
 inline constexpr char CONTROL_SERVER[] = "[CONTROL_SERVER]";
+inline constexpr char CONTROL_AUTHORIZATION[] = "Bearer [CONTROL_TOKEN]"; // Session token of the feeder owner, checked by the feeder routes of the control server
+inline constexpr unsigned long CONTROL_KEEP_ALIVE_IDLE_MS = 60000; // Idle connections are closed by the feeder before the server's timeout_keep_alive (65 s) does
 
 // Internal server configuration
 inline constexpr int SERVER_PORT = 80;
@@ -76,6 +78,8 @@ inline constexpr int16_t LED_CYCLE_STEP = 1; // Step size for cycle animation
 inline constexpr int16_t LED_COMPONENT_STEP = 0;
 inline constexpr bool LED_COMPONENT_DISABLE_ON_COMPLETE = false;
 inline constexpr uint32_t LED_COMPONENT_INTERVAL_MS = 500;
+inline constexpr uint8_t LED_TRAFFIC_MAX_LEDS = 5; // Height of the traffic bar of a component on the top strip
+inline constexpr uint32_t LED_TRAFFIC_DECAY_MS = 400; // The bar loses one LED every 400 ms once the traffic stops
 
 
 // Motor configs
@@ -89,18 +93,76 @@ inline constexpr uint8_t TOP_STRIP_START = 15;
 inline constexpr uint8_t TOP_STRIP_END = LED_NUMBER - 1; // 29
 
 // Bluethooth Serial
-inline constexpr uint16_t MAX_BLE_DEVICES = 32;
-inline constexpr unsigned long BLUETOOTH_BAUDRATE = 9600;
+inline constexpr uint16_t MAX_BLE_DEVICES = 64; // 16 bytes each (binary MAC, interned name and UUID, major, minor, TX power)
+inline constexpr unsigned long BLUETOOTH_BAUDRATE = 9600; // Factory speed of the module, used until a faster one is negotiated
+#ifdef BLE_USE_HARDWARE_UART
+inline constexpr unsigned long BLE_MAX_BAUDRATE = 115200; // The UART FIFO keeps up with any AT-09 speed
+#else
+inline constexpr unsigned long BLE_MAX_BAUDRATE = 38400; // SoftwareSerial overruns its RX buffer between two loop passes above this
+#endif
 inline constexpr unsigned long BLE_SCAN_INTERVAL = 30000; // Scan every 30 seconds
-inline constexpr unsigned long BLE_PERIODIC_SCAN_DURATION = 3000; // Scan for 3 seconds
-inline constexpr unsigned long BLE_STATUS_CHECK_INTERVAL = 10000; // Check BLE connectivity every 10 seconds
+inline constexpr unsigned long BLE_PERIODIC_SCAN_DURATION = 3000; // Scan window of 3 seconds
+inline constexpr unsigned long BLE_SCAN_MIN_INTERVAL = 10000; // A window every 10 seconds (start to start) while a known beacon is around
+inline constexpr unsigned long BLE_SCAN_MAX_INTERVAL = 60000; // Idle ceiling of the adaptive back-off
+inline constexpr unsigned long BLE_SCAN_ACTIVE_HOLD_MS = 60000; // The interval stays at its minimum that long after a known beacon was seen
+inline constexpr bool BLE_SCAN_ADAPTIVE = true; // false = one window every BLE_SCAN_MIN_INTERVAL whatever is around
+inline constexpr bool BLE_SCAN_ADVERTISEMENT_DATA = false; // true = AT+DISI? scans (iBeacon identifiers, no name resolution), AT+DISC? when the module refuses it
+inline constexpr char BLE_IBEACON_UUID[] = ""; // 32 hex digits, AT+DISI? scans only keep the iBeacons of that UUID ("" = any device)
+inline constexpr unsigned long BLE_SCAN_TICK_INTERVAL = 250; // How often the duty cycle is checked for a due window
+inline constexpr size_t BLE_COMMAND_READ_CHUNK = 64; // Bytes of phone commands read per pass
+inline constexpr bool BLE_SLEEP_BETWEEN_SCANS = true; // AT+SLEEP the module while the next window is far enough
+inline constexpr unsigned long BLE_SLEEP_MIN_GAP_MS = 2000; // Shorter gaps between two windows keep the module awake
+inline constexpr unsigned long BLE_STATE_SAMPLE_INTERVAL = 50; // The STATE pin sits on the ADC, reading it faster disturbs the Wi-Fi
+inline constexpr unsigned long BLE_STATE_SAMPLE_MIN_GAP = BLE_STATE_SAMPLE_INTERVAL * 3 / 4; // Shortest gap between two reads, under the ble_monitor period so a run a few ms early still samples
 inline constexpr int8_t BLE_MIN_VALID_RSSI_VALUE = -60; // Minimum RSSI value (dBm) for valid proximity (~1-2 meters)
 
+// Beacon tracking
+inline constexpr uint8_t BEACON_TRACKER_CAPACITY = 64; // Hash table slots, power of two
+inline constexpr uint8_t BEACON_RSSI_SMOOTHING_SHIFT = 2; // Weight of a new RSSI sample = 1 / 2^shift
+inline constexpr int8_t BEACON_ENTER_RSSI = BLE_MIN_VALID_RSSI_VALUE; // Smoothed RSSI at which a beacon is at the feeder
+inline constexpr int8_t BEACON_LEAVE_RSSI = BLE_MIN_VALID_RSSI_VALUE - 10; // Smoothed RSSI under which a present beacon left
+inline constexpr unsigned long BEACON_LEAVE_TIMEOUT_MS = 3 * BLE_SCAN_MIN_INTERVAL; // Unseen that long = left
+inline constexpr unsigned long BEACON_FORGET_TIMEOUT_MS = 600000; // Slot released after 10 minutes without a sighting
+inline constexpr unsigned long BEACON_REPORT_INTERVAL = 300000; // A beacon that stays is reported to the server every 5 minutes
+inline constexpr unsigned long BEACON_REPORT_RETRY_INTERVAL = 30000; // A feeding decision that failed is asked again after 30 seconds
+inline constexpr uint8_t MAX_DUE_BEACONS = 8; // Beacons of one scan sent together for a single feeding decision
+inline constexpr uint8_t BEACON_ALLOWLIST_CAPACITY = 32; // Beacons of the owner the feeder reports, the others cause no HTTP traffic
+inline constexpr unsigned long BEACON_ALLOWLIST_SYNC_INTERVAL = 600000; // Ask the server whether the allowlist changed every 10 minutes
+inline constexpr uint8_t VISIT_BUFFER_CAPACITY = 12; // Beacons whose visits are coalesced between two uploads, a full buffer is sent right away
+inline constexpr unsigned long VISIT_FLUSH_INTERVAL = 300000; // Buffered visits are sent in one request every 5 minutes
+inline constexpr unsigned long VISIT_FLUSH_CHECK_INTERVAL = 1000; // How often the visit buffer is checked for an upload
+
 // Led render timing
 inline constexpr unsigned long LED_RENDER_INTERVAL = 100; // Render LEDs every 100ms
 
 // Server update settings
 inline constexpr unsigned long SIGNS_OF_LIFE_INTERVAL = 1800000; // update ip to server every 30 minutes
 
+// Task scheduler
+inline constexpr uint8_t MAX_SCHEDULED_TASKS = 16; // Size of the fixed task table
+inline constexpr unsigned long SCHEDULER_STATS_INTERVAL = 300000; // Print task statistics every 5 minutes
+inline constexpr unsigned long TASK_DEADLINE_HTTP_SERVER = 50; // ms allowed to serve one client
+inline constexpr unsigned long TASK_DEADLINE_BLE_MONITOR = 5; // ms allowed to sample the BLE state
+inline constexpr unsigned long TASK_DEADLINE_LED_RENDER = LED_RENDER_INTERVAL; // a frame must be out before the next one is due
+inline constexpr unsigned long TASK_DEADLINE_BLE_SCAN = 200; // ms allowed to wake the module (81 bytes at 9600 baud + OK+WAKE) and queue the next scan
+inline constexpr unsigned long TASK_DEADLINE_BLE_QUEUE = 5; // ms allowed for one slice of the AT command queue
+inline constexpr unsigned long TASK_DEADLINE_BLE_COMMANDS = 5; // ms allowed to answer the phone commands of one read
+inline constexpr unsigned long TASK_DEADLINE_BEACON_REPORTS = 2000; // one feeding decision round-trip for every beacon of a scan
+inline constexpr unsigned long TASK_DEADLINE_SIGN_OF_LIFE = 2000; // ms allowed for the PUT ip round-trip
+inline constexpr unsigned long TASK_DEADLINE_ALLOWLIST_SYNC = 2000; // ms allowed for the allowlist round-trip
+inline constexpr unsigned long TASK_DEADLINE_VISIT_FLUSH = 2000; // ms allowed for the batched visits round-trip
+inline constexpr unsigned long TASK_DEADLINE_BLINKER = 10; // ms allowed to toggle the onboard led
+inline constexpr unsigned long FEEDER_TICK_INTERVAL = 10; // Feeding sequence resolution (ms)
+inline constexpr unsigned long TASK_DEADLINE_FEEDER = 2 * FEEDER_TICK_INTERVAL; // a late tick lengthens the current motor phase
+
+// Loop metrics
+inline constexpr uint8_t LOOP_METRICS_BUCKETS = 24; // log2 buckets, the last one collects passes of 2^22 µs (~4.2 s) and more
+
 // Default feeding amount
 inline constexpr unsigned int MAX_FEEDING_SINGLE_PORTION = 50; // grams
+inline constexpr unsigned int FEEDING_MS_PER_GRAM = 1; // Time the trap stays open per gram to distribute
+inline constexpr float FEEDER_FLAP_DEGREES = 90.0f; // Rotation of the tray and trap motors for each move
+
+// Persistent settings (EEPROM emulation, one flash sector)
+inline constexpr size_t EEPROM_SIZE = 64; // Bytes mirrored in RAM while the settings are read or written
+inline constexpr int EEPROM_BLE_BAUD_ADDRESS = 0; // Negotiated BLE baud rate record
@@ -0,0 +1,86 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: control_link.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the kept-alive connection to the control server.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <string_view>
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#include "config.hpp"
+#include "my_overloads.hpp"
+
+namespace HttpServer
+{
+    /**
+     * @brief Connection reuse and latency of the control server requests.
+     */
+    struct ControlLinkStats {
+        uint32_t requests = 0;
+        uint32_t reused = 0;        // Sent on the connection left open by the previous request
+        uint32_t connects = 0;      // Needed a new TCP connection (first request, closed by the server or for idleness)
+        uint32_t retries = 0;       // Kept connection found dead before the request left (or a GET), sent again on a new one
+        uint32_t failures = 0;      // No HTTP status at all (negative HTTPClient code)
+        uint32_t idle_closes = 0;   // Connections closed after CONTROL_KEEP_ALIVE_IDLE_MS without a request
+        uint32_t last_ms = 0;       // begin() to end() of the latest request
+        uint32_t worst_ms = 0;
+        uint32_t reused_ms = 0;     // Cumulated latency of the reused requests
+        uint32_t connect_ms = 0;    // Cumulated latency of the requests that opened a connection
+    };
+
+    /**
+     * @brief HTTP/1.1 keep-alive connection to the control server.
+     *
+     * Every request used to open its own WiFiClient, so each one paid a TCP
+     * handshake. The link owns a single WiFiClient that outlives the requests
+     * and asks SharedDependencies::webClient to keep its socket open, a
+     * request only reconnects once the server closed it, or after
+     * CONTROL_KEEP_ALIVE_IDLE_MS of silence so a request never races the
+     * server's own idle timeout.
+     */
+    class ControlLink
+    {
+        public:
+        explicit ControlLink(HTTPClient &http);
+
+        bool begin(const char *method, const std::string_view &path);  // Prepare a JSON request to CONTROL_SERVER + path
+        int send(const char *body);  // Send the prepared request, once more on a new connection if it never left the dead kept one
+        void end();                  // Release the request, the connection stays open for the next one
+        bool connected() const;
+
+        uint32_t mean_ms() const;
+        uint32_t mean_reused_ms() const;
+        uint32_t mean_connect_ms() const;
+        const ControlLinkStats &stats() const;
+        void print() const;
+
+        private:
+        HTTPClient &_http;
+        mutable WiFiClient _client;     // Kept between requests, its socket is the one reused (connected() is not const in the core)
+        const char *_method = "GET";
+        std::string_view _path;
+        bool _reused = false;           // The current request started on an open connection
+        int _code = 0;
+        unsigned long _started_ms = 0;
+        unsigned long _last_used_ms = 0;
+        ControlLinkStats _stats;
+    };
+}
@@ -0,0 +1,40 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: debug_serial.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header selecting the UART that carries the debug logs.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @file debug_serial.hpp
+ * @brief Port used by every log line of the firmware.
+ *
+ * With BLE_USE_HARDWARE_UART the AT-09 module takes UART0 (swapped onto
+ * GPIO13/GPIO15), the logs then leave on UART1, which only has a TX line
+ * (GPIO2, shared with the onboard LED). Otherwise the logs stay on UART0 and
+ * the module is driven through SoftwareSerial.
+ */
+#ifdef BLE_USE_HARDWARE_UART
+#define DebugSerial Serial1
+#else
+#define DebugSerial Serial
+#endif
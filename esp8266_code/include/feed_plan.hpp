@@ -0,0 +1,82 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: feed_plan.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the queue of portions decided by the control server for the beacons of one scan.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+#include "ble_structs.hpp"
+#include "my_overloads.hpp"
+
+namespace Feeder
+{
+    /**
+     * @brief One portion the control server granted to a beacon.
+     */
+    struct FeedPortion {
+        BluetoothLE::MacAddress beacon;
+        uint32_t grams = 0;
+    };
+
+    /**
+     * @brief Counters comparing the batched decisions with one exchange per beacon.
+     */
+    struct FeedPlanStats {
+        uint32_t requests = 0;        // Batched decisions that reached the server
+        uint32_t failures = 0;        // Batched decisions that did not reach the server or could not be read
+        uint32_t beacons = 0;         // Beacons sent, across every request
+        uint32_t planned = 0;         // Portions granted by the server
+        uint32_t served = 0;          // Portions handed to the feeding sequence
+        uint32_t dropped = 0;         // Portions that did not fit MAX_DUE_BEACONS
+        uint32_t round_trips_saved = 0;  // visit + fed check per beacon and fed update per portion, minus the batched request
+    };
+
+    /**
+     * @brief Ordered portions of one batched feeding decision.
+     *
+     * The control server receives every beacon of a scan in a single
+     * request and answers with the portions to distribute, the closest pet
+     * first. The portions are served one at a time, each once the previous
+     * feed is over, so a crowded bowl costs one round-trip instead of three
+     * per beacon.
+     */
+    class FeedPlan
+    {
+        public:
+        void begin(const uint8_t beacons);  // A new decision was received, the previous portions are dropped
+        bool add(const BluetoothLE::MacAddress &beacon, const uint32_t grams);  // false when full or for an empty portion
+        void record_failure();
+
+        bool next(FeedPortion &portion);  // Oldest portion not served yet, false when the plan is over
+        uint8_t pending() const;
+
+        const FeedPlanStats &stats() const;
+        void clear();
+        void print() const;
+
+        private:
+        FeedPortion _portions[MAX_DUE_BEACONS];
+        uint8_t _count = 0;
+        uint8_t _served = 0;
+        FeedPlanStats _stats;
+    };
+}
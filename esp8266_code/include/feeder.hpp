@@ -0,0 +1,85 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: feeder.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the non-blocking feeding sequence (tray and trap state machine).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+#include "motors.hpp"
+#include "my_overloads.hpp"
+
+namespace Feeder
+{
+    /**
+     * @brief Steps of a food distribution, in execution order.
+     */
+    enum class FeedPhase : uint8_t {
+        Idle = 0,
+        ClosingTray,    // Left motor hides the bowl while the food falls
+        OpeningTrap,    // Right motor opens the food trap
+        Dispensing,     // Trap stays open for the requested amount
+        ClosingTrap,    // Right motor closes the food trap
+        OpeningTray,    // Left motor presents the bowl again
+        _COUNT
+    };
+
+    const char *phase_name(const FeedPhase phase);
+
+    /**
+     * @brief Dispense sequence driven by repeated calls to tick().
+     *
+     * Every phase starts a motor movement (or a wait) and records when it
+     * started, the following ticks only check whether the phase duration has
+     * elapsed. The caller provides the current time, so the loop keeps
+     * serving HTTP clients and animating the panel during a feed, and the
+     * sequence can be replayed with a fake clock.
+     */
+    class FeedingSequence
+    {
+        public:
+        FeedingSequence(Motors::Motor *tray_motor, Motors::Motor *trap_motor);
+
+        bool start(const uint32_t amount_grams, const uint32_t now_ms);   // false if a feed is already running
+        void tick(const uint32_t now_ms);
+
+        bool is_busy() const;
+        FeedPhase phase() const;
+        uint32_t phase_started_at(const FeedPhase phase) const;  // millis() when the phase started during the latest feed
+        uint32_t phase_duration(const FeedPhase phase) const;    // Planned duration of the phase during the latest feed
+        uint32_t completed_feeds() const;
+        uint32_t last_feed_duration() const;  // Time between start() and the tray reopening (ms)
+
+        private:
+        void _enter(const FeedPhase phase, const uint32_t now_ms);
+        void _finish_motor();
+
+        Motors::Motor *_tray;
+        Motors::Motor *_trap;
+
+        FeedPhase _phase = FeedPhase::Idle;
+        uint32_t _dispense_ms = 0;
+        uint32_t _started_at[static_cast<uint8_t>(FeedPhase::_COUNT)] = {};
+        uint32_t _durations[static_cast<uint8_t>(FeedPhase::_COUNT)] = {};
+        uint32_t _completed_feeds = 0;
+        uint32_t _last_feed_duration = 0;
+    };
+}
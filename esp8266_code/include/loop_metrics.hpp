@@ -0,0 +1,68 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: loop_metrics.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the loop latency histogram (log2 buckets measured with the cpu cycle counter).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+
+namespace MyUtils
+{
+    namespace Metrics
+    {
+        /**
+         * @brief Fixed-bucket histogram of the loop() pass durations.
+         *
+         * Bucket 0 counts passes shorter than 1 µs, bucket i (i > 0) counts the
+         * passes lasting [2^(i-1), 2^i) µs and the last bucket collects
+         * everything longer. Durations come from ESP.getCycleCount(), which
+         * wraps every 2^32 cycles (~26.8 s at 160 MHz), so a single pass longer
+         * than that would be under-reported.
+         */
+        class LoopMetrics
+        {
+            public:
+            static void begin_pass();
+            static void end_pass();
+            static void record(const uint32_t duration_us);
+
+            static uint32_t bucket(const uint8_t index);
+            static uint32_t bucket_upper_us(const uint8_t index);  // Exclusive upper bound, UINT32_MAX_VALUE for the last bucket
+            static uint8_t bucket_count();
+            static uint32_t max_us();
+            static uint32_t last_us();
+            static uint64_t count();
+            static uint64_t total_us();
+            static void reset();
+
+            private:
+            static uint8_t _bucket_index(const uint32_t duration_us);
+
+            static uint32_t _pass_start_cycles;
+            static uint32_t _buckets[LOOP_METRICS_BUCKETS];
+            static uint32_t _max_us;
+            static uint32_t _last_us;
+            static uint64_t _count;
+            static uint64_t _total_us;
+        };
+    }
+}
@@ -47,6 +47,11 @@ namespace Motors
         void turn_left_degrees(float degrees = MOTOR_TURN_DEGREES_DEFAULT);
         void turn_right_degrees(float degrees = MOTOR_TURN_DEGREES_DEFAULT);
 
+        // Non-blocking variants: start the movement and return how long it must last (ms), call end_turn() once elapsed
+        unsigned long begin_turn_left_degrees(float degrees = MOTOR_TURN_DEGREES_DEFAULT);
+        unsigned long begin_turn_right_degrees(float degrees = MOTOR_TURN_DEGREES_DEFAULT);
+        void end_turn();
+
         float degrees_to_delay(int8_t speed = MOTOR_SPEED_DEFAULT, float degrees = MOTOR_TURN_DEGREES_DEFAULT) const;
 
         void calibrate();
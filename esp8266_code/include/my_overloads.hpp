@@ -26,6 +26,7 @@
 #include <Print.h>
 #include <string_view>
 #include <type_traits>
+#include "debug_serial.hpp"
 
 
 // string_view support
@@ -49,13 +49,13 @@ namespace MyUtils
 
     inline void display_percentage(const LED::Colour &fg, const LED::Colour &bg, const int16_t current, const int16_t max_steps)
     {
-        Serial << "Displaying progress for step " << current << " of " << max_steps << endl;
+        DebugSerial << "Displaying progress for step " << current << " of " << max_steps << endl;
         int16_t progress = MyUtils::leds_for_progress<int16_t>(
             current,
             max_steps,
             static_cast<int16_t>(LED_NUMBER)
         );
-        Serial << "Displaying progress: " << progress << " LEDs lit for step " << current << " of " << max_steps << endl;
+        DebugSerial << "Displaying progress: " << progress << " LEDs lit for step " << current << " of " << max_steps << endl;
         LED::led_set_colour(fg, LED_DURATION, progress, bg);
     };
 }
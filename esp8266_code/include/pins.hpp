@@ -31,16 +31,25 @@ namespace Pins
     inline constexpr uint8_t LED_STRIP_PIN = 5;   // D1 = GPIO5
     inline constexpr uint8_t MOTOR1_PIN = 14;  // D5 = GPIO14
     inline constexpr uint8_t MOTOR2_PIN = 16;   // Servo 2 (D0, GPIO16) -> software PWM
+#ifdef BLE_USE_HARDWARE_UART
+    // UART0 after Serial.swap(): GPIO15 must stay low at boot, the module RX input does not pull it up
+    inline constexpr uint8_t BLE_RXD_PIN = 13;  // D7 = GPIO13 (UART0 RX swapped, to AT-09 TX)
+    inline constexpr uint8_t BLE_TXD_PIN = 15;  // D8 = GPIO15 (UART0 TX swapped, to AT-09 RX)
+#else
     inline constexpr uint8_t BLE_RXD_PIN = 12;  // D6 = GPIO12 (SWAPPED - trying RX on GPIO12)
     inline constexpr uint8_t BLE_TXD_PIN = 13;  // D7 = GPIO13 (SWAPPED - trying TX on GPIO13)
+#endif
     inline constexpr uint8_t BLE_EN_PIN = 4;   // D2 = GPIO4
     inline constexpr uint8_t BLE_STATE_PIN = A0;  // ADC0
 
     static inline void init()
     {
         // Set pin modes if necessary
+#ifndef BLE_USE_HARDWARE_UART
+        // GPIO2 is the UART1 TX line carrying the logs in hardware UART mode
         pinMode(LED_PIN, OUTPUT);
         digitalWrite(LED_PIN, HIGH); // LED off (active LOW)
+#endif
         pinMode(LED_STRIP_PIN, OUTPUT);
         pinMode(MOTOR1_PIN, OUTPUT);
         pinMode(MOTOR2_PIN, OUTPUT);
@@ -0,0 +1,89 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: scan_duty_cycle.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the scheduler deciding when the bluetooth module scans and for how long.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+#include "ble_enums.hpp"
+#include "my_overloads.hpp"
+
+namespace BluetoothLE
+{
+    /**
+     * @brief Radio time spent scanning and how the interval moved.
+     */
+    struct ScanDutyCycleStats {
+        uint32_t scans = 0;         // Windows that ran to completion
+        uint32_t active_scans = 0;  // Windows that saw a known beacon
+        uint32_t backoffs = 0;      // Times the interval grew after an idle window
+        uint32_t radio_ms = 0;      // Time the module spent in discovery
+        uint32_t longest_gap_ms = 0;  // Longest start-to-start time between two windows
+    };
+
+    /**
+     * @brief Decides when the next scan starts and how long it listens.
+     *
+     * A scan listens for `window` ms once every `interval` ms (start to start),
+     * the module advertises the rest of the time. In Adaptive mode the
+     * interval drops to its minimum as soon as a window sees a known beacon
+     * and stays there for BLE_SCAN_ACTIVE_HOLD_MS, then doubles after each idle
+     * window up to the maximum: an arriving cat is noticed within one short
+     * interval while an empty room costs a window every max interval.
+     */
+    class ScanDutyCycle
+    {
+        public:
+        ScanDutyCycle(const uint32_t window_ms = BLE_PERIODIC_SCAN_DURATION, const uint32_t min_interval_ms = BLE_SCAN_MIN_INTERVAL, const uint32_t max_interval_ms = BLE_SCAN_MAX_INTERVAL, const ScanMode mode = BLE_SCAN_ADAPTIVE ? ScanMode::Adaptive : ScanMode::Fixed);
+
+        bool configure(const uint32_t window_ms, const uint32_t min_interval_ms, const uint32_t max_interval_ms, const ScanMode mode);  // False when window > min interval or min > max
+        bool due(const uint32_t now_ms) const;
+        void started(const uint32_t now_ms);
+        void finished(const uint32_t now_ms, const bool known_seen);  // Closes the window opened by started()
+        bool running() const;
+
+        uint32_t window_ms() const;
+        uint32_t interval_ms() const;       // Current start-to-start interval
+        uint32_t min_interval_ms() const;
+        uint32_t max_interval_ms() const;
+        ScanMode mode() const;
+        uint32_t next_scan_in_ms(const uint32_t now_ms) const;  // 0 when a window is due or running
+        uint16_t duty_permille() const;     // window / interval of the current setting
+        uint32_t radio_ms_per_hour() const; // Discovery time scaled to one hour of uptime
+
+        const ScanDutyCycleStats &stats() const;
+        void print() const;
+
+        private:
+        uint32_t _window_ms;
+        uint32_t _min_interval_ms;
+        uint32_t _max_interval_ms;
+        uint32_t _interval_ms;
+        ScanMode _mode;
+        bool _running = false;
+        bool _ever_started = false;
+        uint32_t _last_start_ms = 0;
+        uint32_t _last_known_ms = 0;
+        bool _known_ever = false;
+        ScanDutyCycleStats _stats;
+    };
+}
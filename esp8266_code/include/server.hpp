@@ -34,5 +34,7 @@ namespace HttpServer
     void initialize_server();
     void setupServer();
     void handleInfo();
+    void handleMetrics();
     void handleBlink();
+    void handleScanConfig();
 }
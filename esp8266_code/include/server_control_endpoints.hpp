@@ -24,6 +24,9 @@
 #pragma once
 #include <string_view>
 #include "server.hpp"
+#include "beacon_allowlist.hpp"
+#include "feed_plan.hpp"
+#include "visit_buffer.hpp"
 
 namespace HttpServer
 {
@@ -35,6 +38,7 @@ namespace HttpServer
             namespace Get
             {
                 inline constexpr std::string_view FED = "/api/v1/feeder/fed";
+                inline constexpr std::string_view BEACONS = "/api/v1/feeder/beacons";
             } // namespace Get
 
             namespace Post
@@ -42,6 +46,8 @@ namespace HttpServer
                 inline constexpr std::string_view FED = "/api/v1/feeder/fed";
                 inline constexpr std::string_view LOCATION = "/api/v1/feeder/beacon/location";
                 inline constexpr std::string_view VISITS = "/api/v1/feeder/visit";
+                inline constexpr std::string_view VISIT_BATCH = "/api/v1/feeder/visit/batch";
+                inline constexpr std::string_view FEED_PLAN = "/api/v1/feeder/feed_plan";
             } // namespace Post
 
             namespace Put
@@ -71,6 +77,16 @@ namespace HttpServer
                 *   }
                 */
                 bool fed(const char *beacon_mac, long long int *can_distribute);
+
+                /* Refresh the list of beacons the feeder reports, the version held is sent in If-None-Match
+                * Body:
+                *   {
+                *       "feeder_mac": {{sample_feeder}}
+                *   }
+                * Response (200, ETag header): { "resp": { "beacons": ["AABBCCDDEEFF", ...], "version": "<etag>" } }
+                * Response (304): empty, the allowlist is current
+                */
+                bool beacons(BluetoothLE::BeaconAllowlist &allowlist);
             } // namespace Get
 
             namespace Post
@@ -101,6 +117,28 @@ namespace HttpServer
                 *   }
                 */
                 bool visits(const char *beacon_mac);
+
+                /* Send every visit buffered since the last upload in one request, the ages are counted back from the request
+                * Body:
+                *   {
+                *       "feeder_mac": {{sample_feeder}},
+                *       "visits": [ { "mac": {{sample_beacon}}, "first_ms_ago": 240000, "last_ms_ago": 1500, "samples": 12, "rssi": -52 }, ... ]
+                *   }
+                * Response (200): { "resp": { "recorded": 2, "unknown": 0 } }
+                */
+                bool visit_batch(BluetoothLE::VisitBuffer &buffer);
+
+                /* Report every beacon of a scan in one request, the reply lists the portions to distribute in order, the visits go through visit_batch()
+                * Body:
+                *   {
+                *       "feeder_mac": {{sample_feeder}},
+                *       "max_portion": {{feeder_amount}},
+                *       "record_visits": false,
+                *       "beacons": [ { "mac": {{sample_beacon}}, "rssi": -48 }, ... ]
+                *   }
+                * Response (200): { "resp": { "portions": [ { "beacon_mac": "AABBCCDDEEFF", "amount": 50 }, ... ], "visits": 2 } }
+                */
+                bool feed_plan(const BluetoothLE::MacAddress *beacons, const int8_t *rssi, const uint8_t count, Feeder::FeedPlan &plan);
             } // namespace Post
 
             namespace Put
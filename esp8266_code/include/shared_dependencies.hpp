@@ -25,16 +25,32 @@
 #include <ESP8266WiFi.h>
 #include <ESP8266HTTPClient.h>
 #include "leds.hpp"
+#include "feeder.hpp"
+#include "feed_plan.hpp"
 #include "motors.hpp"
 #include "server.hpp"
+#include "control_link.hpp"
 #include "ble_handler.hpp"
+#include "beacon_tracker.hpp"
+#include "beacon_allowlist.hpp"
+#include "visit_buffer.hpp"
+#include "scan_duty_cycle.hpp"
+#include "ble_command_channel.hpp"
 #include "wifi_handler.hpp"
 
 struct SharedDependencies {
     static HTTPClient *webClient;
+    static HttpServer::ControlLink *controlLink;
     static ESP8266WebServer *webServer;
     static Motors::Motor *leftMotor;
     static Motors::Motor *rightMotor;
+    static Feeder::FeedingSequence *feeder;
+    static Feeder::FeedPlan *feedPlan;
     static Wifi::WifiHandler *wifiHandler;
     static BluetoothLE::BLEHandler *bleHandler;
+    static BluetoothLE::BeaconTracker *beaconTracker;
+    static BluetoothLE::BeaconAllowlist *beaconAllowlist;
+    static BluetoothLE::VisitBuffer *visitBuffer;
+    static BluetoothLE::ScanDutyCycle *scanDutyCycle;
+    static BluetoothLE::CommandChannel *commandChannel;
 };
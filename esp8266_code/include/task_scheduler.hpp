@@ -0,0 +1,117 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: task_scheduler.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the cooperative task scheduler driven by the main loop.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+#include "sentinels.hpp"
+#include "my_overloads.hpp"
+
+namespace MyUtils
+{
+    namespace Scheduler
+    {
+        /**
+         * @brief Urgency of a task, lower values are serviced first on every pass.
+         */
+        enum class TaskPriority : uint8_t {
+            Critical = 0,   // Input servicing that must never starve (HTTP, BLE link)
+            High = 1,       // User visible work (LED rendering)
+            Normal = 2,     // Periodic application logic (beacon checks)
+            Low = 3,        // Housekeeping (sign of life, blinker, statistics)
+            _COUNT
+        };
+
+        typedef void (*TaskCallback)();
+
+        /**
+         * @brief Run-time statistics gathered for a single task.
+         *
+         * Jitter is the delay between the moment a task became due and the moment
+         * it actually started. An overrun is a run that finished after its
+         * deadline (release time + deadline), whatever the cause (late start or
+         * long run).
+         */
+        struct TaskStats {
+            uint32_t run_count = 0;       // Number of completed runs
+            uint32_t overrun_count = 0;   // Runs that finished past their deadline
+            uint32_t skipped_count = 0;   // Periods that were missed entirely (task resynchronised)
+            uint32_t last_run_us = 0;     // Duration of the latest run (µs)
+            uint32_t worst_run_us = 0;    // Worst-case observed run time (µs)
+            uint32_t last_jitter_ms = 0;  // Start delay of the latest run (ms)
+            uint32_t worst_jitter_ms = 0; // Largest observed start delay (ms)
+            uint64_t total_run_us = 0;    // Cumulated run time, used to compute the loop budget share
+        };
+
+        /**
+         * @brief Entry of the fixed task table.
+         */
+        struct Task {
+            const char *name = nullptr;
+            TaskCallback callback = nullptr;
+            uint32_t period_ms = 0;       // 0 = run on every scheduler pass
+            uint32_t deadline_ms = 0;     // Relative deadline from release time, 0 = no deadline
+            TaskPriority priority = TaskPriority::Normal;
+            uint32_t next_run_ms = 0;     // Release time of the next run (millis())
+            bool enabled = false;
+            TaskStats stats;
+        };
+
+        /**
+         * @brief Static cooperative scheduler with a fixed task table.
+         *
+         * Tasks are registered once in setup() and run() is called from loop().
+         * Every pass services the due tasks from the most to the least urgent
+         * priority, so a slow housekeeping job can delay, but never starve, the
+         * HTTP server or the LED rendering.
+         */
+        class TaskScheduler
+        {
+            public:
+            static int8_t add(const char *name, TaskCallback callback, const uint32_t period_ms, const uint32_t deadline_ms = 0, const TaskPriority priority = TaskPriority::Normal);
+
+            static void run();  // Execute every due task once, by priority
+
+            static void enable(const int8_t task_id);
+            static void disable(const int8_t task_id);
+            static void set_period(const int8_t task_id, const uint32_t period_ms);
+
+            static uint32_t time_until_next_ms();  // Time before the closest release (0 = something is due)
+            static int8_t next_task();             // Task that will be released first (-1 = none)
+
+            static const Task *get(const int8_t task_id);
+            static uint8_t count();
+            static uint64_t total_run_us();        // Time spent inside tasks since boot (µs)
+            static void reset_stats();
+            static void print_stats();
+
+            private:
+            static bool _valid(const int8_t task_id);
+            static bool _is_due(const Task &task, const uint32_t now);
+            static void _execute(Task &task, const uint32_t now);
+
+            static Task _tasks[MAX_SCHEDULED_TASKS];
+            static uint8_t _task_count;
+        };
+    }
+}
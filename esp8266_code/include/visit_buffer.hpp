@@ -0,0 +1,95 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: visit_buffer.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: Coalesce the visits of the beacons at the feeder so they reach the control server in one batched request.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <Arduino.h>
+#include "config.hpp"
+#include "ble_structs.hpp"
+#include "my_overloads.hpp"
+#include "sentinels.hpp"
+
+namespace BluetoothLE
+{
+    /**
+     * @brief Every sighting of one beacon since the last upload.
+     */
+    struct BeaconVisit {
+        MacAddress beacon;
+        uint32_t first_seen_ms = 0;
+        uint32_t last_seen_ms = 0;
+        uint16_t samples = 0;
+        int32_t rssi_sum = 0;
+
+        int8_t mean_rssi() const { return samples > 0 ? static_cast<int8_t>(rssi_sum / samples) : 0; }
+    };
+
+    /**
+     * @brief Counters comparing the batched uploads with one visit request per sighting.
+     */
+    struct VisitBufferStats {
+        uint32_t sightings = 0;      // Sightings coalesced into a visit
+        uint32_t overflows = 0;      // Sightings of a new beacon dropped while the buffer was full
+        uint32_t uploads = 0;        // Batched requests that reached the server
+        uint32_t failures = 0;       // Batched requests that did not reach the server, the visits are kept
+        uint32_t visits = 0;         // Coalesced visits sent, across every upload
+        uint32_t requests_saved = 0; // One visit request per sighting, minus the batched request
+    };
+
+    /**
+     * @brief Fixed table of the visits not sent to the control server yet.
+     *
+     * Each sighting of a beacon updates its entry: first and last time it
+     * was seen, number of samples and the sum of their RSSI. The table goes
+     * out in a single request every VISIT_FLUSH_INTERVAL, or as soon as a
+     * beacon that has no entry finds it full, so a busy feeder costs one
+     * request per interval instead of one per beacon and per scan. A failed
+     * upload keeps the entries, the next one carries them.
+     */
+    class VisitBuffer
+    {
+        public:
+        bool record(const MacAddress &beacon, const int8_t rssi, const uint32_t now);  // false when a new beacon finds the buffer full
+
+        bool due(const uint32_t now) const;  // Something to send and the interval elapsed, or the buffer is full
+        void sent(const uint32_t now);       // The server has every visit, the buffer starts over
+        void record_failure(const uint32_t now);
+
+        uint8_t count() const;
+        bool full() const;
+        const BeaconVisit *visits() const;
+        static constexpr uint8_t capacity() { return VISIT_BUFFER_CAPACITY; }
+
+        uint32_t requests_saved_per_hour() const;  // requests_saved scaled to one hour of uptime
+        const VisitBufferStats &stats() const;
+        void clear();
+        void print() const;
+
+        private:
+        BeaconVisit _visits[VISIT_BUFFER_CAPACITY];
+        uint8_t _count = 0;
+        uint32_t _pending_sightings = 0;  // Sightings since the last upload
+        uint32_t _window_start_ms = 0;    // Last upload, or last attempt
+        bool _overflowed = false;         // A beacon was turned away since the last upload
+        VisitBufferStats _stats;
+    };
+}
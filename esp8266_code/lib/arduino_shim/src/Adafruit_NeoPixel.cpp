@@ -0,0 +1,68 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: Adafruit_NeoPixel.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the host stand-in for the Adafruit NeoPixel library.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "Adafruit_NeoPixel.h"
+#include "arduino_shim.hpp"
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t count, int16_t pin, neoPixelType type)
+    : _pixels(count, 0), _bytes_per_pixel(((type >> 6) & 0b11) == ((type >> 4) & 0b11) ? 3 : 4)
+{
+}
+
+void Adafruit_NeoPixel::show()
+{
+    _show_count++;
+    // The WS2812 timing is bit-banged with interrupts off for the whole frame
+    ArduinoShim::Interrupts::disable_for_us(show_time_us());
+}
+
+void Adafruit_NeoPixel::clear()
+{
+    for (uint32_t &pixel : _pixels) {
+        pixel = 0;
+    }
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t colour)
+{
+    if (n < _pixels.size()) {
+        _pixels[n] = colour;
+    }
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+    setPixelColor(n, Color(r, g, b, w));
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
+{
+    return (n < _pixels.size()) ? _pixels[n] : 0;
+}
+
+uint32_t Adafruit_NeoPixel::show_time_us() const
+{
+    // 800 kHz: 1.25 µs per bit, then at least 50 µs of low level to latch
+    const uint32_t bits = static_cast<uint32_t>(_pixels.size()) * _bytes_per_pixel * 8;
+    return (bits * 5 + 3) / 4 + 50;
+}
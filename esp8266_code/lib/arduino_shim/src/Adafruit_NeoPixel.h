@@ -0,0 +1,71 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: Adafruit_NeoPixel.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the Adafruit NeoPixel library.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_GRBW ((3 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_RGBW ((3 << 6) | (0 << 4) | (1 << 2) | (2))
+
+typedef uint16_t neoPixelType;
+
+/**
+ * @brief Pixel buffer with the timing of the real driver.
+ *
+ * show() advances the virtual clock by the time the strip takes to latch
+ * the frame (1.25 µs per bit + 50 µs reset), during which the real driver
+ * runs with interrupts disabled.
+ */
+class Adafruit_NeoPixel
+{
+    public:
+    Adafruit_NeoPixel(uint16_t count, int16_t pin, neoPixelType type = NEO_GRB + NEO_KHZ800);
+
+    void begin() {}
+    void show();
+    void clear();
+    void setBrightness(uint8_t brightness) { _brightness = brightness; }
+    uint8_t getBrightness() const { return _brightness; }
+    void setPixelColor(uint16_t n, uint32_t colour);
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0);
+    uint32_t getPixelColor(uint16_t n) const;
+    uint16_t numPixels() const { return static_cast<uint16_t>(_pixels.size()); }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b; }
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w) { return (static_cast<uint32_t>(w) << 24) | Color(r, g, b); }
+
+    // Host only
+    uint32_t show_count() const { return _show_count; }
+    uint32_t show_time_us() const;  // Interrupts-off window of one show()
+
+    private:
+    std::vector<uint32_t> _pixels;
+    uint8_t _bytes_per_pixel;
+    uint8_t _brightness = 0;
+    uint32_t _show_count = 0;
+};
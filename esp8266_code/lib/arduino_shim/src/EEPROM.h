@@ -0,0 +1,118 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: EEPROM.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266 EEPROM emulation (a flash sector mirrored in RAM).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @brief Same contract as the ESP8266 core: begin() copies the sector into a
+ * RAM buffer, read/write/get/put work on that buffer and only commit() makes
+ * the changes survive a reboot.
+ */
+class EEPROMClass
+{
+    public:
+    static constexpr size_t SECTOR_SIZE = 4096;
+
+    EEPROMClass() { wipe(); }  // A never written sector reads as 0xFF
+
+    void begin(size_t size)
+    {
+        _size = (size > SECTOR_SIZE) ? SECTOR_SIZE : size;
+        memcpy(_ram, _flash, _size);
+        _dirty = false;
+    }
+
+    uint8_t read(int const address)
+    {
+        return (address >= 0 && static_cast<size_t>(address) < _size) ? _ram[address] : 0;
+    }
+
+    void write(int const address, uint8_t const value)
+    {
+        if (address >= 0 && static_cast<size_t>(address) < _size && _ram[address] != value) {
+            _ram[address] = value;
+            _dirty = true;
+        }
+    }
+
+    template <typename T>
+    T &get(int const address, T &value)
+    {
+        if (address >= 0 && address + sizeof(T) <= _size) {
+            memcpy(&value, _ram + address, sizeof(T));
+        }
+        return value;
+    }
+
+    template <typename T>
+    const T &put(int const address, const T &value)
+    {
+        if (address >= 0 && address + sizeof(T) <= _size && memcmp(_ram + address, &value, sizeof(T)) != 0) {
+            memcpy(_ram + address, &value, sizeof(T));
+            _dirty = true;
+        }
+        return value;
+    }
+
+    bool commit()
+    {
+        if (_size == 0) {
+            return false;
+        }
+        if (_dirty) {
+            memcpy(_flash, _ram, _size);
+            _dirty = false;
+            _erase_cycles++;
+        }
+        return true;
+    }
+
+    bool end()
+    {
+        const bool committed = commit();
+        _size = 0;
+        return committed;
+    }
+
+    size_t length() const { return _size; }
+
+    // Host only: sector erase/write cycles and a blank chip
+    uint32_t erase_cycles() const { return _erase_cycles; }
+    void wipe()
+    {
+        memset(_flash, 0xFF, sizeof(_flash));
+        _erase_cycles = 0;
+    }
+
+    private:
+    uint8_t _flash[SECTOR_SIZE];  // What survives a reboot
+    uint8_t _ram[SECTOR_SIZE] = {};
+    size_t _size = 0;
+    bool _dirty = false;
+    uint32_t _erase_cycles = 0;
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,83 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ESP8266HTTPClient.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266 HTTPClient, answered by the scripted ArduinoShim::Http server.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "WString.h"
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+enum t_http_codes {
+    HTTP_CODE_OK = 200,
+    HTTP_CODE_NOT_MODIFIED = 304,
+    HTTP_CODE_NOT_FOUND = 404
+};
+
+/**
+ * @brief Request/response client with the connection semantics of the core.
+ *
+ * A request opens a TCP session (one handshake) unless setReuse(true) kept
+ * the previous one open for the same host, and end() closes it unless reuse
+ * was requested. Latencies come from ArduinoShim::Http::set_latency_us().
+ */
+class HTTPClient
+{
+    public:
+    bool begin(WiFiClient &client, const String &url);
+    bool begin(WiFiClient &client, const char *url) { return begin(client, String(url)); }
+    void end();
+
+    void setReuse(bool reuse) { _reuse = reuse; }
+    void setTimeout(uint16_t timeout_ms) {}
+    void addHeader(const String &name, const String &value);
+    void collectHeaders(const char *header_keys[], const size_t count) {}
+    String header(const char *name) const;
+
+    int GET();
+    int POST(const String &payload);
+    int POST(const uint8_t *payload, size_t size);
+    int PUT(const String &payload);
+    int sendRequest(const char *method, const String &payload);
+    int sendRequest(const char *method, const uint8_t *payload, size_t size);
+
+    String getString() const { return _response_body; }
+    int getSize() const { return static_cast<int>(_response_body.length()); }
+    bool connected() const { return _client != nullptr && _client->connected(); }
+
+    private:
+    static String _host_of(const String &url);
+
+    WiFiClient *_client = nullptr;
+    String _url;
+    String _host;
+    String _connected_host;
+    String _if_none_match;
+    String _response_body;
+    String _response_etag;
+    bool _reuse = false;
+};
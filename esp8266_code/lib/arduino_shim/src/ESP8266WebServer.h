@@ -0,0 +1,85 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ESP8266WebServer.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266WebServer, requests are injected from the host side.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "WString.h"
+
+enum HTTPMethod {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+};
+
+class ESP8266WebServer
+{
+    public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit ESP8266WebServer(int port = 80) : _port(port) {}
+
+    void on(const String &uri, HTTPMethod method, THandlerFunction handler);
+    void on(const String &uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void begin() { _started = true; }
+    void handleClient();
+
+    void send(int code, const char *content_type, const String &content);
+    void send(int code, const String &content_type, const String &content) { send(code, content_type.c_str(), content); }
+    bool hasArg(const String &name) const;
+    String arg(const String &name) const;
+    String uri() const { return _current_uri; }
+
+    // Host only: queue a request served by the next handleClient()
+    void inject(HTTPMethod method, const String &uri, const String &body = String());
+    int last_code() const { return _last_code; }
+    const String &last_response() const { return _last_response; }
+
+    private:
+    struct Route {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction handler;
+    };
+    struct PendingRequest {
+        HTTPMethod method;
+        String uri;
+        String body;
+    };
+
+    int _port;
+    bool _started = false;
+    std::vector<Route> _routes;
+    std::vector<PendingRequest> _pending;
+    String _current_uri;
+    String _current_body;
+    bool _has_body = false;
+    int _last_code = 0;
+    String _last_response;
+};
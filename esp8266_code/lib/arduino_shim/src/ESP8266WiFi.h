@@ -0,0 +1,79 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ESP8266WiFi.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266 WiFi station API.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include "WString.h"
+#include "WiFiClient.h"
+
+class IPAddress
+{
+    public:
+    IPAddress() = default;
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{ a, b, c, d } {}
+
+    uint8_t operator[](int index) const { return _octets[index]; }
+    uint8_t &operator[](int index) { return _octets[index]; }
+    String toString() const
+    {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+        return String(buffer);
+    }
+
+    private:
+    uint8_t _octets[4] = { 0, 0, 0, 0 };
+};
+
+enum WiFiMode_t {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+};
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class ESP8266WiFiClass
+{
+    public:
+    bool mode(WiFiMode_t mode) { _mode = mode; return true; }
+    wl_status_t begin(const char *ssid, const char *password = nullptr) { _status = WL_CONNECTED; return _status; }
+    wl_status_t status() const { return _status; }
+    IPAddress localIP() const { return (_status == WL_CONNECTED) ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+    String macAddress() const { return String("5C:CF:7F:00:C0:FE"); }
+    int32_t RSSI() const { return -55; }
+
+    private:
+    WiFiMode_t _mode = WIFI_OFF;
+    wl_status_t _status = WL_DISCONNECTED;
+};
+
+extern ESP8266WiFiClass WiFi;
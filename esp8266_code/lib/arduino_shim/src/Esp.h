@@ -0,0 +1,46 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: Esp.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266 system object (chip information, heap, cycle counter).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include "WString.h"
+
+class EspClass
+{
+    public:
+    uint32_t getChipId() { return 0x00C0FFEE; }
+    uint32_t getFlashChipId() { return 0x001640EF; }
+    uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+    uint32_t getFlashChipSpeed() { return 40000000; }
+    uint8_t getCpuFreqMHz() { return CPU_FREQ_MHZ; }
+    uint32_t getFreeHeap() { return 40000; }
+    uint8_t getHeapFragmentation() { return 0; }
+    const char *getSdkVersion() { return "host-shim"; }
+    String getResetReason() { return String("Power On"); }
+    uint32_t getCycleCount();  // Derived from the virtual clock at CPU_FREQ_MHZ
+    void restart();
+
+    static constexpr uint8_t CPU_FREQ_MHZ = 160;
+};
+
+extern EspClass ESP;
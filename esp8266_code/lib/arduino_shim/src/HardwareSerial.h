@@ -0,0 +1,46 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: HardwareSerial.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266 hardware UARTs (Serial, Serial1).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include "shim_serial_port.h"
+
+class HardwareSerial : public ArduinoShim::SerialPort
+{
+    public:
+    explicit HardwareSerial(const int uart_nr);
+
+    void begin(unsigned long baud);  // Back on the default pins, call swap() again afterwards
+    void begin(unsigned long baud, int config) { begin(baud); }
+    void swap();  // UART0 moves from GPIO1/3 to GPIO15/13 (or back)
+    void setDebugOutput(bool enabled) {}
+    bool isSwapped() const { return _swapped; }
+
+    static constexpr size_t RX_FIFO_SIZE = 256;  // Default software RX buffer of the ESP8266 core
+
+    private:
+    int _uart_nr;
+    bool _swapped = false;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
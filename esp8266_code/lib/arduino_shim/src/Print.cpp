@@ -0,0 +1,107 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: Print.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the host stand-ins for the Arduino Print and Stream classes.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstdarg>
+#include <cstdio>
+#include "Arduino.h"
+#include "Print.h"
+#include "Stream.h"
+
+// ==================== Print ====================
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    for (size_t i = 0; i < size; ++i) {
+        written += write(buffer[i]);
+    }
+    return written;
+}
+
+size_t Print::print(long long value, int base)
+{
+    const String text(value, static_cast<unsigned char>(base));
+    return print(text);
+}
+
+size_t Print::print(unsigned long long value, int base)
+{
+    const String text(value, static_cast<unsigned char>(base));
+    return print(text);
+}
+
+size_t Print::print(double value, int digits)
+{
+    const String text(value, static_cast<unsigned char>(digits));
+    return print(text);
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length <= 0) {
+        return 0;
+    }
+    return write(buffer, (static_cast<size_t>(length) < sizeof(buffer)) ? static_cast<size_t>(length) : sizeof(buffer) - 1);
+}
+
+// ==================== Stream ====================
+
+int Stream::_timed_read()
+{
+    const unsigned long start = millis();
+    do {
+        const int c = read();
+        if (c >= 0) {
+            return c;
+        }
+        yield();
+    } while (millis() - start < _timeout_ms);
+    return -1;
+}
+
+String Stream::readString()
+{
+    String result;
+    int c = _timed_read();
+    while (c >= 0) {
+        result += static_cast<char>(c);
+        c = _timed_read();
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String result;
+    int c = _timed_read();
+    while (c >= 0 && c != terminator) {
+        result += static_cast<char>(c);
+        c = _timed_read();
+    }
+    return result;
+}
@@ -0,0 +1,74 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: Servo.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266 Servo library.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+
+class Servo
+{
+    public:
+    static constexpr int MAX_PINS = 32;
+
+    uint8_t attach(int pin) { _pin = pin; _attached = true; _attach_count++; _mirror(); return 0; }
+    void detach() { _attached = false; _mirror(); }
+    bool attached() const { return _attached; }
+    void write(int value) { _value = value; _mirror(); }
+    int read() const { return _value; }
+
+    // Host only
+    uint32_t attach_count() const { return _attach_count; }
+    // What the servo attached to a pin was last told, lets a test follow motors it cannot reach
+    static int pin_value(int pin) { return (pin >= 0 && pin < MAX_PINS) ? _pin_values[pin] : -1; }
+    static bool pin_attached(int pin) { return pin >= 0 && pin < MAX_PINS && _pin_attached[pin]; }
+    static uint32_t pin_changes(int pin) { return (pin >= 0 && pin < MAX_PINS) ? _pin_changes[pin] : 0; }
+    static void reset_pins()
+    {
+        for (int i = 0; i < MAX_PINS; ++i) {
+            _pin_values[i] = 90;
+            _pin_attached[i] = false;
+            _pin_changes[i] = 0;
+        }
+    }
+
+    private:
+    void _mirror()
+    {
+        if (_pin < 0 || _pin >= MAX_PINS) {
+            return;
+        }
+        if (_pin_values[_pin] != _value) {
+            _pin_changes[_pin]++;
+        }
+        _pin_values[_pin] = _value;
+        _pin_attached[_pin] = _attached;
+    }
+
+    int _pin = -1;
+    int _value = 90;
+    bool _attached = false;
+    uint32_t _attach_count = 0;
+
+    static inline int _pin_values[MAX_PINS] = {};
+    static inline bool _pin_attached[MAX_PINS] = {};
+    static inline uint32_t _pin_changes[MAX_PINS] = {};
+};
@@ -0,0 +1,43 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: SoftwareSerial.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the EspSoftwareSerial library.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include "shim_serial_port.h"
+
+class SoftwareSerial : public ArduinoShim::SerialPort
+{
+    public:
+    SoftwareSerial(const uint8_t rx_pin, const uint8_t tx_pin)
+        : SerialPort(rx_pin, tx_pin, RX_BUFFER_SIZE, true)
+    {
+    }
+
+    bool listen() { return true; }
+    bool isListening() const { return true; }
+    bool overflow() { const bool lost = rx_overflow_count() != _reported_overflows; _reported_overflows = rx_overflow_count(); return lost; }
+
+    static constexpr size_t RX_BUFFER_SIZE = 64;  // Default receive buffer of EspSoftwareSerial
+
+    private:
+    uint32_t _reported_overflows = 0;
+};
@@ -0,0 +1,42 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: Stream.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the Arduino Stream base class.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include "Print.h"
+
+class Stream : public Print
+{
+    public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout_ms) { _timeout_ms = timeout_ms; }
+    String readString();
+    String readStringUntil(char terminator);
+
+    protected:
+    int _timed_read();
+
+    unsigned long _timeout_ms = 1000;
+};
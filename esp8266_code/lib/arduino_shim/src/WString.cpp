@@ -0,0 +1,108 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: WString.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the host stand-in for the Arduino String class.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cctype>
+#include <cstdio>
+#include "WString.h"
+
+String::String(double value, unsigned char decimals)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(decimals), value);
+    _data = buffer;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    if (suffix._data.size() > _data.size()) {
+        return false;
+    }
+    return _data.compare(_data.size() - suffix._data.size(), suffix._data.size(), suffix._data) == 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to) {
+        const unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from >= _data.size()) {
+        return String();
+    }
+    if (to > _data.size()) {
+        to = static_cast<unsigned int>(_data.size());
+    }
+    return String(_data.substr(from, to - from));
+}
+
+void String::trim()
+{
+    size_t start = 0;
+    while (start < _data.size() && isspace(static_cast<unsigned char>(_data[start]))) {
+        start++;
+    }
+    size_t end = _data.size();
+    while (end > start && isspace(static_cast<unsigned char>(_data[end - 1]))) {
+        end--;
+    }
+    _data = _data.substr(start, end - start);
+}
+
+void String::toUpperCase()
+{
+    for (char &c : _data) {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+}
+
+void String::toLowerCase()
+{
+    for (char &c : _data) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+}
+
+std::string String::_format(unsigned long long value, unsigned char base)
+{
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    char buffer[65];
+    size_t pos = sizeof(buffer) - 1;
+    buffer[pos] = '\0';
+    do {
+        const unsigned digit = static_cast<unsigned>(value % base);
+        buffer[--pos] = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    return std::string(&buffer[pos]);
+}
+
+std::string String::_format(long long value, unsigned char base)
+{
+    if (value < 0 && base == 10) {
+        return "-" + _format(static_cast<unsigned long long>(-(value + 1)) + 1, base);
+    }
+    return _format(static_cast<unsigned long long>(value), base);
+}
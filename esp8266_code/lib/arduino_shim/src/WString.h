@@ -0,0 +1,124 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: WString.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the Arduino String class, backed by std::string.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+class String
+{
+    public:
+    String() = default;
+    String(const char *str) : _data(str ? str : "") {}
+    String(const char *str, size_t length) : _data(str ? std::string(str, length) : std::string()) {}
+    String(const std::string &str) : _data(str) {}
+    explicit String(char c) : _data(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) : _data(_format(value, base)) {}
+    explicit String(int value, unsigned char base = 10) : _data(_format(value, base)) {}
+    explicit String(unsigned int value, unsigned char base = 10) : _data(_format(value, base)) {}
+    explicit String(long value, unsigned char base = 10) : _data(_format(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = 10) : _data(_format(value, base)) {}
+    explicit String(long long value, unsigned char base = 10) : _data(_format(value, base)) {}
+    explicit String(unsigned long long value, unsigned char base = 10) : _data(_format(value, base)) {}
+    explicit String(double value, unsigned char decimals = 2);
+
+    const char *c_str() const { return _data.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(_data.size()); }
+    bool isEmpty() const { return _data.empty(); }
+    bool reserve(unsigned int size) { _data.reserve(size); return true; }
+
+    char charAt(unsigned int index) const { return index < _data.size() ? _data[index] : '\0'; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    bool concat(const String &str) { _data += str._data; return true; }
+    bool concat(const char *str) { if (str) { _data += str; } return true; }
+    bool concat(const char *str, unsigned int length) { if (str) { _data.append(str, length); } return true; }
+    bool concat(char c) { _data += c; return true; }
+
+    String &operator+=(const String &str) { concat(str); return *this; }
+    String &operator+=(const char *str) { concat(str); return *this; }
+    String &operator+=(char c) { concat(c); return *this; }
+
+    int indexOf(char c, unsigned int from = 0) const { return _index(_data.find(c, from)); }
+    int indexOf(const char *str, unsigned int from = 0) const { return _index(_data.find(str, from)); }
+    int indexOf(const String &str, unsigned int from = 0) const { return _index(_data.find(str._data, from)); }
+    int lastIndexOf(char c) const { return _index(_data.rfind(c)); }
+
+    bool startsWith(const String &prefix) const { return _data.compare(0, prefix._data.size(), prefix._data) == 0; }
+    bool endsWith(const String &suffix) const;
+
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    void trim();
+    void toUpperCase();
+    void toLowerCase();
+    long toInt() const { return std::strtol(_data.c_str(), nullptr, 10); }
+
+    bool equals(const String &other) const { return _data == other._data; }
+    bool operator==(const String &other) const { return _data == other._data; }
+    bool operator==(const char *other) const { return other && _data == other; }
+    bool operator!=(const String &other) const { return _data != other._data; }
+    bool operator!=(const char *other) const { return !(*this == other); }
+
+    private:
+    static int _index(const size_t pos) { return (pos == std::string::npos) ? -1 : static_cast<int>(pos); }
+    static std::string _format(unsigned long long value, unsigned char base);
+    static std::string _format(long long value, unsigned char base);
+    static std::string _format(unsigned long value, unsigned char base) { return _format(static_cast<unsigned long long>(value), base); }
+    static std::string _format(long value, unsigned char base) { return _format(static_cast<long long>(value), base); }
+    static std::string _format(unsigned int value, unsigned char base) { return _format(static_cast<unsigned long long>(value), base); }
+    static std::string _format(int value, unsigned char base) { return _format(static_cast<long long>(value), base); }
+    static std::string _format(unsigned char value, unsigned char base) { return _format(static_cast<unsigned long long>(value), base); }
+
+    std::string _data;
+};
+
+inline String operator+(const String &lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const String &lhs, const char *rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const String &lhs, char rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
@@ -0,0 +1,42 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: WiFiClient.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host stand-in for the ESP8266 WiFiClient (a connection slot used by HTTPClient).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+
+class WiFiClient
+{
+    public:
+    bool connected() const;  // Also false once the scripted server closed the idle session
+    void stop() { _connected = false; }
+    void setNoDelay(bool enabled) {}
+    void keepAlive(uint16_t idle_s = 7200, uint16_t interval_s = 75, uint8_t count = 9) {}
+
+    // Host only: HTTPClient tracks whether the TCP session is still open
+    void _set_connected(const bool connected) { _connected = connected; }
+    void _touch(const uint64_t now_us) { _last_used_us = now_us; }
+
+    private:
+    bool _connected = false;
+    uint64_t _last_used_us = 0;     // End of the latest request, start of the server's keep-alive timeout
+};
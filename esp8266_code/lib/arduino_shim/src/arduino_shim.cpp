@@ -0,0 +1,303 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: arduino_shim.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the arduino shim core (virtual clock, gpio, wiring and entry point).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "arduino_shim.hpp"
+
+EspClass ESP;
+EEPROMClass EEPROM;
+
+namespace
+{
+    uint64_t clock_us = 0;
+    uint32_t auto_advance_us = 1;
+
+    bool digital_state[ArduinoShim::Pins::COUNT] = {};
+    uint16_t analog_state[ArduinoShim::Pins::COUNT] = {};
+    uint8_t pin_mode[ArduinoShim::Pins::COUNT] = {};
+    uint32_t analog_reads[ArduinoShim::Pins::COUNT] = {};
+
+    ArduinoShim::SerialPeer *peers[ArduinoShim::Pins::COUNT] = {};
+
+    std::mt19937 random_engine(0);
+
+    // Recent interrupt-free windows, a deliver() only looks a few frames back
+    constexpr size_t MASKED_WINDOWS = 32;
+    uint64_t masked_from[MASKED_WINDOWS] = {};
+    uint64_t masked_to[MASKED_WINDOWS] = {};
+    size_t masked_next = 0;
+    uint32_t masked_windows = 0;
+    uint64_t masked_us = 0;
+
+    uint64_t loop_limit = 0;
+}
+
+// ==================== Virtual clock ====================
+
+uint64_t ArduinoShim::Clock::now_us()
+{
+    return clock_us;
+}
+
+void ArduinoShim::Clock::advance_us(const uint64_t us)
+{
+    clock_us += us;
+}
+
+void ArduinoShim::Clock::advance_ms(const uint32_t ms)
+{
+    clock_us += static_cast<uint64_t>(ms) * 1000;
+}
+
+void ArduinoShim::Clock::reset(const uint64_t start_us)
+{
+    clock_us = start_us;
+}
+
+void ArduinoShim::Clock::set_auto_advance_us(const uint32_t us)
+{
+    auto_advance_us = us;
+}
+
+unsigned long millis()
+{
+    clock_us += auto_advance_us;
+    return static_cast<unsigned long>(static_cast<uint32_t>(clock_us / 1000));
+}
+
+unsigned long micros()
+{
+    clock_us += auto_advance_us;
+    return static_cast<unsigned long>(static_cast<uint32_t>(clock_us));
+}
+
+void delay(unsigned long ms)
+{
+    ArduinoShim::Clock::advance_ms(ms);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    ArduinoShim::Clock::advance_us(us);
+}
+
+void yield()
+{
+}
+
+uint32_t EspClass::getCycleCount()
+{
+    clock_us += auto_advance_us;
+    return static_cast<uint32_t>(clock_us * CPU_FREQ_MHZ);
+}
+
+void EspClass::restart()
+{
+    fprintf(stderr, "[shim] ESP.restart() requested, exiting\n");
+    std::exit(0);
+}
+
+// ==================== GPIO ====================
+
+void ArduinoShim::Pins::set_digital(const uint8_t pin, const bool high)
+{
+    if (pin < COUNT) {
+        digital_state[pin] = high;
+    }
+}
+
+void ArduinoShim::Pins::set_analog(const uint8_t pin, const uint16_t value)
+{
+    if (pin < COUNT) {
+        analog_state[pin] = value;
+    }
+}
+
+bool ArduinoShim::Pins::digital(const uint8_t pin)
+{
+    return (pin < COUNT) ? digital_state[pin] : false;
+}
+
+uint16_t ArduinoShim::Pins::analog(const uint8_t pin)
+{
+    return (pin < COUNT) ? analog_state[pin] : 0;
+}
+
+uint8_t ArduinoShim::Pins::mode(const uint8_t pin)
+{
+    return (pin < COUNT) ? pin_mode[pin] : 0;
+}
+
+uint32_t ArduinoShim::Pins::analog_read_count(const uint8_t pin)
+{
+    return (pin < COUNT) ? analog_reads[pin] : 0;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < ArduinoShim::Pins::COUNT) {
+        pin_mode[pin] = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    ArduinoShim::Pins::set_digital(pin, value != LOW);
+}
+
+int digitalRead(uint8_t pin)
+{
+    // The firmware reads A0 as a digital pin for the BLE STATE line
+    if (pin == A0) {
+        return ArduinoShim::Pins::analog(A0) > 512 ? HIGH : LOW;
+    }
+    return ArduinoShim::Pins::digital(pin) ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+    if (pin >= ArduinoShim::Pins::COUNT) {
+        return 0;
+    }
+    analog_reads[pin]++;
+    // The ADC conversion takes about 100 µs on the ESP8266
+    ArduinoShim::Clock::advance_us(100);
+    return analog_state[pin];
+}
+
+// ==================== Interrupts ====================
+
+void ArduinoShim::Interrupts::disable_for_us(const uint32_t us)
+{
+    masked_from[masked_next] = clock_us;
+    masked_to[masked_next] = clock_us + us;
+    masked_next = (masked_next + 1) % MASKED_WINDOWS;
+    masked_windows++;
+    masked_us += us;
+    clock_us += us;
+}
+
+bool ArduinoShim::Interrupts::masked_at(const uint64_t at_us)
+{
+    for (size_t i = 0; i < MASKED_WINDOWS; ++i) {
+        if (masked_to[i] > masked_from[i] && at_us >= masked_from[i] && at_us < masked_to[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t ArduinoShim::Interrupts::masked_count()
+{
+    return masked_windows;
+}
+
+uint64_t ArduinoShim::Interrupts::masked_total_us()
+{
+    return masked_us;
+}
+
+void ArduinoShim::Interrupts::reset()
+{
+    for (size_t i = 0; i < MASKED_WINDOWS; ++i) {
+        masked_from[i] = 0;
+        masked_to[i] = 0;
+    }
+    masked_next = 0;
+    masked_windows = 0;
+    masked_us = 0;
+}
+
+// ==================== Serial wiring ====================
+
+void ArduinoShim::Wiring::connect(const uint8_t rx_pin, SerialPeer *peer)
+{
+    if (rx_pin < Pins::COUNT) {
+        peers[rx_pin] = peer;
+    }
+}
+
+void ArduinoShim::Wiring::disconnect(const uint8_t rx_pin)
+{
+    connect(rx_pin, nullptr);
+}
+
+ArduinoShim::SerialPeer *ArduinoShim::Wiring::peer_on(const uint8_t rx_pin)
+{
+    return (rx_pin < Pins::COUNT) ? peers[rx_pin] : nullptr;
+}
+
+// ==================== Math helpers ====================
+
+long random(long max_value)
+{
+    return (max_value <= 0) ? 0 : random(0, max_value);
+}
+
+long random(long min_value, long max_value)
+{
+    if (min_value >= max_value) {
+        return min_value;
+    }
+    std::uniform_int_distribution<long> distribution(min_value, max_value - 1);
+    return distribution(random_engine);
+}
+
+void randomSeed(unsigned long seed)
+{
+    random_engine.seed(seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    if (in_max == in_min) {
+        return out_min;
+    }
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// ==================== Entry point ====================
+
+void ArduinoShim::set_loop_limit(const uint64_t iterations)
+{
+    loop_limit = iterations;
+}
+
+#if !defined(PIO_UNIT_TESTING) && !defined(ARDUINO_SHIM_NO_MAIN)
+int main(int argc, char **argv)
+{
+    // Optional first argument: number of loop() passes before exiting
+    if (argc > 1) {
+        loop_limit = std::strtoull(argv[1], nullptr, 10);
+    }
+    setup();
+    for (uint64_t i = 0; loop_limit == 0 || i < loop_limit; ++i) {
+        loop();
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,150 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: arduino_shim.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host side control panel of the arduino shim (virtual clock, pins and serial wiring).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @file arduino_shim.hpp
+ * @brief Knobs that only exist on the host build.
+ *
+ * The firmware never includes this file, it is meant for the native entry
+ * points (benchmarks, emulators, smoke runs) that need to drive time, pins
+ * and the wires between the ESP8266 and its peripherals.
+ */
+
+namespace ArduinoShim
+{
+    class SerialPort;
+
+    /**
+     * @brief Virtual clock behind millis(), micros(), delay() and ESP.getCycleCount().
+     *
+     * Time only moves when the firmware waits (delay) or reads the clock, so a
+     * run is fully deterministic and a 3 second scan costs no wall time.
+     */
+    namespace Clock
+    {
+        uint64_t now_us();
+        void advance_us(const uint64_t us);
+        void advance_ms(const uint32_t ms);
+        void reset(const uint64_t start_us = 0);
+        // Time added by every millis()/micros() call so busy-wait loops still progress (default 1 µs)
+        void set_auto_advance_us(const uint32_t us);
+    }
+
+    /**
+     * @brief Windows during which the firmware ran with interrupts disabled.
+     *
+     * Bit-banged receivers (SoftwareSerial) sample every bit from a pin change
+     * interrupt, so the bits of a frame falling in such a window are misread.
+     * Hardware UARTs keep shifting bytes into their FIFO meanwhile.
+     */
+    namespace Interrupts
+    {
+        void disable_for_us(const uint32_t us);     // Advance the clock with interrupts off
+        bool masked_at(const uint64_t at_us);       // Were interrupts off at that (recent) instant
+        uint32_t masked_count();                    // Windows since the last reset
+        uint64_t masked_total_us();
+        void reset();
+    }
+
+    /**
+     * @brief State of the GPIO pins as seen by digitalRead()/analogRead().
+     */
+    namespace Pins
+    {
+        inline constexpr uint8_t COUNT = 18;  // GPIO0-16 + A0 (17)
+        void set_digital(const uint8_t pin, const bool high);
+        void set_analog(const uint8_t pin, const uint16_t value);
+        bool digital(const uint8_t pin);
+        uint16_t analog(const uint8_t pin);
+        uint8_t mode(const uint8_t pin);
+        uint32_t analog_read_count(const uint8_t pin);  // How often the firmware sampled the pin
+    }
+
+    /**
+     * @brief Device sitting at the other end of a serial link (a BLE module, a console...).
+     */
+    class SerialPeer
+    {
+        public:
+        virtual ~SerialPeer() = default;
+        // The firmware wrote `byte` on the link at `now_us`
+        virtual void on_host_byte(const uint8_t byte, const uint64_t now_us) = 0;
+        // Push every byte that should have reached the firmware by `now_us` with port.deliver()
+        virtual void service(SerialPort &port, const uint64_t now_us) = 0;
+        // The firmware (re)opened the port at a new baud rate
+        virtual void on_host_baud(const uint32_t baud) {}
+    };
+
+    /**
+     * @brief Physical wiring between firmware UART pins and emulated peripherals.
+     *
+     * A peer connected on a RX pin is bound to whichever serial port listens
+     * on that pin, which mirrors how SoftwareSerial or a swapped hardware UART
+     * would see the module.
+     */
+    namespace Wiring
+    {
+        void connect(const uint8_t rx_pin, SerialPeer *peer);
+        void disconnect(const uint8_t rx_pin);
+        SerialPeer *peer_on(const uint8_t rx_pin);
+    }
+
+    /**
+     * @brief Scripted HTTP control server used by HTTPClient.
+     */
+    namespace Http
+    {
+        struct Request {
+            const char *method;
+            const char *url;
+            const char *body;
+            size_t body_length;
+            const char *if_none_match;  // Value of the If-None-Match header ("" when absent)
+        };
+
+        struct Response {
+            int code = -1;            // HTTPC_ERROR_CONNECTION_REFUSED unless a handler answers
+            const char *body = "";
+            const char *etag = "";
+        };
+
+        typedef Response (*Handler)(const Request &request, void *context);
+
+        void set_handler(Handler handler, void *context = nullptr);
+        void set_latency_us(const uint32_t handshake_us, const uint32_t round_trip_us);
+        void set_keep_alive_timeout_us(const uint64_t timeout_us);  // Idle sessions closed by the server (0 = never)
+        uint32_t request_count();
+        uint32_t handshake_count();   // TCP connections opened
+        void reset_counters();
+    }
+
+    // Silence the firmware logs (Serial/Serial1) during benchmarks
+    void set_console_echo(const bool enabled);
+
+    // Number of loop() iterations run by the shim entry point (0 = forever)
+    void set_loop_limit(const uint64_t iterations);
+}
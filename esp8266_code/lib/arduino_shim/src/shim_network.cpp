@@ -0,0 +1,236 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: shim_network.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the host WiFi, HTTPClient and ESP8266WebServer stand-ins.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstring>
+#include "arduino_shim.hpp"
+#include "ESP8266WiFi.h"
+#include "ESP8266HTTPClient.h"
+#include "ESP8266WebServer.h"
+
+ESP8266WiFiClass WiFi;
+
+namespace
+{
+    ArduinoShim::Http::Handler http_handler = nullptr;
+    void *http_context = nullptr;
+    uint32_t http_handshake_us = 0;
+    uint32_t http_round_trip_us = 0;
+    uint64_t http_keep_alive_us = 0;
+    uint32_t http_requests = 0;
+    uint32_t http_handshakes = 0;
+}
+
+// ==================== Scripted control server ====================
+
+void ArduinoShim::Http::set_handler(Handler handler, void *context)
+{
+    http_handler = handler;
+    http_context = context;
+}
+
+void ArduinoShim::Http::set_latency_us(const uint32_t handshake_us, const uint32_t round_trip_us)
+{
+    http_handshake_us = handshake_us;
+    http_round_trip_us = round_trip_us;
+}
+
+void ArduinoShim::Http::set_keep_alive_timeout_us(const uint64_t timeout_us)
+{
+    http_keep_alive_us = timeout_us;
+}
+
+uint32_t ArduinoShim::Http::request_count()
+{
+    return http_requests;
+}
+
+uint32_t ArduinoShim::Http::handshake_count()
+{
+    return http_handshakes;
+}
+
+void ArduinoShim::Http::reset_counters()
+{
+    http_requests = 0;
+    http_handshakes = 0;
+}
+
+// ==================== WiFiClient ====================
+
+bool WiFiClient::connected() const
+{
+    if (!_connected) {
+        return false;
+    }
+    return http_keep_alive_us == 0 || ArduinoShim::Clock::now_us() - _last_used_us <= http_keep_alive_us;
+}
+
+// ==================== HTTPClient ====================
+
+bool HTTPClient::begin(WiFiClient &client, const String &url)
+{
+    _client = &client;
+    _url = url;
+    _host = _host_of(url);
+    _if_none_match = "";
+    _response_body = "";
+    _response_etag = "";
+    return true;
+}
+
+void HTTPClient::end()
+{
+    if (_client == nullptr) {
+        return;
+    }
+    if (!_reuse) {
+        _client->_set_connected(false);
+        _connected_host = "";
+    }
+    _client = nullptr;
+}
+
+void HTTPClient::addHeader(const String &name, const String &value)
+{
+    if (strcasecmp(name.c_str(), "If-None-Match") == 0) {
+        _if_none_match = value;
+    }
+}
+
+String HTTPClient::header(const char *name) const
+{
+    if (strcasecmp(name, "ETag") == 0) {
+        return _response_etag;
+    }
+    return String();
+}
+
+int HTTPClient::GET()
+{
+    return sendRequest("GET", nullptr, 0);
+}
+
+int HTTPClient::POST(const String &payload)
+{
+    return sendRequest("POST", payload);
+}
+
+int HTTPClient::POST(const uint8_t *payload, size_t size)
+{
+    return sendRequest("POST", payload, size);
+}
+
+int HTTPClient::PUT(const String &payload)
+{
+    return sendRequest("PUT", payload);
+}
+
+int HTTPClient::sendRequest(const char *method, const String &payload)
+{
+    return sendRequest(method, reinterpret_cast<const uint8_t *>(payload.c_str()), payload.length());
+}
+
+int HTTPClient::sendRequest(const char *method, const uint8_t *payload, size_t size)
+{
+    if (_client == nullptr) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    // A new TCP session is needed unless this client still holds one to the same host
+    if (!_client->connected() || _connected_host != _host) {
+        http_handshakes++;
+        ArduinoShim::Clock::advance_us(http_handshake_us);
+        _client->_set_connected(true);
+        _connected_host = _host;
+    }
+    http_requests++;
+    ArduinoShim::Clock::advance_us(http_round_trip_us);
+    if (http_handler == nullptr) {
+        _client->_set_connected(false);
+        _connected_host = "";
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    const String body(reinterpret_cast<const char *>(payload), payload ? size : 0);
+    const ArduinoShim::Http::Request request = { method, _url.c_str(), body.c_str(), body.length(), _if_none_match.c_str() };
+    const ArduinoShim::Http::Response response = http_handler(request, http_context);
+    _response_body = response.body ? response.body : "";
+    _response_etag = response.etag ? response.etag : "";
+    _client->_touch(ArduinoShim::Clock::now_us());
+    return response.code;
+}
+
+String HTTPClient::_host_of(const String &url)
+{
+    int start = url.indexOf("://");
+    start = (start < 0) ? 0 : start + 3;
+    const int end = url.indexOf('/', start);
+    return (end < 0) ? url.substring(start) : url.substring(start, end);
+}
+
+// ==================== ESP8266WebServer ====================
+
+void ESP8266WebServer::on(const String &uri, HTTPMethod method, THandlerFunction handler)
+{
+    _routes.push_back({ uri, method, handler });
+}
+
+void ESP8266WebServer::handleClient()
+{
+    if (!_started || _pending.empty()) {
+        return;
+    }
+    // One request per call, like the real server
+    const PendingRequest request = _pending.front();
+    _pending.erase(_pending.begin());
+    _current_uri = request.uri;
+    _current_body = request.body;
+    _has_body = request.body.length() > 0;
+    for (const Route &route : _routes) {
+        if (route.uri == request.uri && (route.method == HTTP_ANY || route.method == request.method)) {
+            route.handler();
+            return;
+        }
+    }
+    send(404, "text/plain", "Not found");
+}
+
+void ESP8266WebServer::send(int code, const char *content_type, const String &content)
+{
+    _last_code = code;
+    _last_response = content;
+}
+
+bool ESP8266WebServer::hasArg(const String &name) const
+{
+    return name == "plain" && _has_body;
+}
+
+String ESP8266WebServer::arg(const String &name) const
+{
+    return (name == "plain") ? _current_body : String();
+}
+
+void ESP8266WebServer::inject(HTTPMethod method, const String &uri, const String &body)
+{
+    _pending.push_back({ method, uri, body });
+}
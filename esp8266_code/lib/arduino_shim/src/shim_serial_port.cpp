@@ -0,0 +1,217 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: shim_serial_port.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the host UART model and of the Serial/Serial1 instances.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstdio>
+#include "HardwareSerial.h"
+#include "shim_serial_port.h"
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+
+// ==================== SerialPort ====================
+
+ArduinoShim::SerialPort::SerialPort(const uint8_t rx_pin, const uint8_t tx_pin, const size_t rx_capacity, const bool bit_banged)
+    : _rx_pin(rx_pin), _tx_pin(tx_pin), _rx_capacity(rx_capacity < MAX_RX_CAPACITY ? rx_capacity : MAX_RX_CAPACITY), _bit_banged(bit_banged)
+{
+}
+
+void ArduinoShim::SerialPort::begin(unsigned long baud)
+{
+    _baud = baud;
+    _open = true;
+    SerialPeer *peer = Wiring::peer_on(_rx_pin);
+    if (peer != nullptr) {
+        peer->on_host_baud(baud);
+    }
+}
+
+void ArduinoShim::SerialPort::end()
+{
+    _open = false;
+    _rx_head = 0;
+    _rx_count = 0;
+}
+
+int ArduinoShim::SerialPort::available()
+{
+    _service();
+    return static_cast<int>(_rx_count);
+}
+
+int ArduinoShim::SerialPort::read()
+{
+    _service();
+    if (_rx_count == 0) {
+        return -1;
+    }
+    const uint8_t byte = _rx[_rx_head];
+    _rx_head = (_rx_head + 1) % _rx_capacity;
+    _rx_count--;
+    _bytes_read++;
+    return byte;
+}
+
+int ArduinoShim::SerialPort::peek()
+{
+    _service();
+    if (_rx_count == 0) {
+        return -1;
+    }
+    return _rx[_rx_head];
+}
+
+size_t ArduinoShim::SerialPort::write(uint8_t byte)
+{
+    _bytes_written++;
+    SerialPeer *peer = Wiring::peer_on(_rx_pin);
+    if (_bit_banged && _baud > 0) {
+        // The bit-banged transmitter holds the CPU for the whole frame
+        Clock::advance_us(byte_time_us());
+    }
+    if (peer != nullptr) {
+        peer->on_host_byte(byte, Clock::now_us());
+    } else if (_echo) {
+        fputc(byte, stdout);
+    }
+    return 1;
+}
+
+size_t ArduinoShim::SerialPort::write(const uint8_t *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        write(buffer[i]);
+    }
+    return size;
+}
+
+bool ArduinoShim::SerialPort::deliver(const uint8_t byte)
+{
+    return deliver(byte, Clock::now_us());
+}
+
+bool ArduinoShim::SerialPort::deliver(const uint8_t byte, const uint64_t stop_bit_us)
+{
+    if (!_open) {
+        return false;
+    }
+    uint8_t value = byte;
+    if (_bit_banged && _baud > 0) {
+        // Bits are timed from the start bit edge interrupt, then sampled in the middle of each bit
+        const uint64_t bit_us = 1000000ULL / _baud;
+        const uint64_t frame_start = (stop_bit_us > 10 * bit_us) ? stop_bit_us - 10 * bit_us : 0;
+        if (Interrupts::masked_at(frame_start)) {
+            // Start bit edge missed, the frame is lost (or read from a data bit, as garbage)
+            _rx_corrupted++;
+            return false;
+        }
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            if (Interrupts::masked_at(frame_start + bit_us + bit * bit_us + bit_us / 2)) {
+                value |= (1 << bit);  // No edge seen, the level is read as idle (high)
+            }
+        }
+        if (value != byte) {
+            _rx_corrupted++;
+        }
+    }
+    if (_rx_count >= _rx_capacity) {
+        _rx_overflows++;
+        return false;
+    }
+    _rx[(_rx_head + _rx_count) % _rx_capacity] = byte;
+    _rx_count++;
+    return true;
+}
+
+uint32_t ArduinoShim::SerialPort::byte_time_us() const
+{
+    if (_baud == 0) {
+        return 0;
+    }
+    // 8N1: start bit + 8 data bits + stop bit
+    return static_cast<uint32_t>((10ULL * 1000000ULL + _baud - 1) / _baud);
+}
+
+void ArduinoShim::SerialPort::_set_pins(const uint8_t rx_pin, const uint8_t tx_pin)
+{
+    _rx_pin = rx_pin;
+    _tx_pin = tx_pin;
+}
+
+void ArduinoShim::SerialPort::set_echo(const bool echo)
+{
+    _echo = echo;
+}
+
+void ArduinoShim::SerialPort::_service()
+{
+    if (!_open) {
+        return;
+    }
+    SerialPeer *peer = Wiring::peer_on(_rx_pin);
+    if (peer != nullptr) {
+        peer->service(*this, Clock::now_us());
+    }
+}
+
+void ArduinoShim::set_console_echo(const bool enabled)
+{
+    Serial.set_echo(enabled);
+    Serial1.set_echo(enabled);
+}
+
+// ==================== HardwareSerial ====================
+
+HardwareSerial::HardwareSerial(const int uart_nr)
+    : SerialPort(uart_nr == 0 ? 3 : ArduinoShim::NO_PIN, uart_nr == 0 ? 1 : 2, RX_FIFO_SIZE, false), _uart_nr(uart_nr)
+{
+    // Unwired hardware ports are the console
+    set_echo(true);
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    // Like uart_init(), (re)opening the port puts it back on its default pins
+    if (_uart_nr == 0 && _swapped) {
+        _swapped = false;
+        _set_pins(3, 1);
+    }
+    SerialPort::begin(baud);
+}
+
+void HardwareSerial::swap()
+{
+    if (_uart_nr != 0) {
+        return;
+    }
+    _swapped = !_swapped;
+    if (_swapped) {
+        _set_pins(13, 15);
+    } else {
+        _set_pins(3, 1);
+    }
+    // The peripheral on the new pins now hears the port
+    ArduinoShim::SerialPeer *peer = ArduinoShim::Wiring::peer_on(rx_pin());
+    if (*this && peer != nullptr) {
+        peer->on_host_baud(baud());
+    }
+}
@@ -0,0 +1,99 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: shim_serial_port.h
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the host model of a UART (receive FIFO, transmit timing and peripheral wiring).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Stream.h"
+#include "arduino_shim.hpp"
+
+namespace ArduinoShim
+{
+    inline constexpr uint8_t NO_PIN = 255;
+
+    /**
+     * @brief Serial port shared by HardwareSerial and SoftwareSerial.
+     *
+     * Bytes written by the firmware go to the peer wired on the RX pin (see
+     * Wiring), or to stdout when nothing is wired. Bytes sent by the peer land
+     * in a receive FIFO of the same size as on the chip, and are dropped (and
+     * counted) when the firmware does not drain it fast enough. A bit-banged
+     * port also blocks the CPU while sending and misreads the bits sampled
+     * while interrupts were off (see Interrupts).
+     */
+    class SerialPort : public Stream
+    {
+        public:
+        SerialPort(const uint8_t rx_pin, const uint8_t tx_pin, const size_t rx_capacity, const bool bit_banged);
+
+        void begin(unsigned long baud);
+        void end();
+
+        int available() override;
+        int read() override;
+        int peek() override;
+        size_t write(uint8_t byte) override;
+        size_t write(const uint8_t *buffer, size_t size) override;
+        using Print::write;
+        void flush() override {}
+        explicit operator bool() const { return _open; }
+
+        // Called by the peer: false if the byte was lost (FIFO full or start bit missed)
+        bool deliver(const uint8_t byte);
+        bool deliver(const uint8_t byte, const uint64_t stop_bit_us);  // Frame that ended at stop_bit_us
+
+        unsigned long baud() const { return _baud; }
+        uint8_t rx_pin() const { return _rx_pin; }
+        uint32_t rx_overflow_count() const { return _rx_overflows; }
+        uint32_t rx_corrupted_count() const { return _rx_corrupted; }  // Frames misread with interrupts off
+        uint64_t bytes_written() const { return _bytes_written; }
+        uint64_t bytes_read() const { return _bytes_read; }
+        uint32_t byte_time_us() const;  // Time to shift one 8N1 frame at the current baud rate
+        void set_echo(const bool echo);  // Copy output to stdout when no peer is wired
+
+        protected:
+        void _set_pins(const uint8_t rx_pin, const uint8_t tx_pin);
+
+        private:
+        void _service();
+
+        static constexpr size_t MAX_RX_CAPACITY = 256;
+
+        uint8_t _rx_pin;
+        uint8_t _tx_pin;
+        size_t _rx_capacity;
+        bool _bit_banged;   // Bit-banged ports keep the CPU busy while sending and sample RX from interrupts
+        bool _echo = false;
+        bool _open = false;
+        unsigned long _baud = 0;
+
+        uint8_t _rx[MAX_RX_CAPACITY] = {};
+        size_t _rx_head = 0;
+        size_t _rx_count = 0;
+
+        uint32_t _rx_overflows = 0;
+        uint32_t _rx_corrupted = 0;
+        uint64_t _bytes_written = 0;
+        uint64_t _bytes_read = 0;
+    };
+}
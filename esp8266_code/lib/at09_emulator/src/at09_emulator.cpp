@@ -0,0 +1,427 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: at09_emulator.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the AT-09 BLE module emulator used by the native benchmarks.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "at09_emulator.hpp"
+#include "shim_serial_port.h"
+
+namespace
+{
+    // HM-10 style AT+BAUD<n> indexes
+    const uint32_t BAUD_TABLE[] = { 9600, 19200, 38400, 57600, 115200, 4800, 2400, 1200, 230400 };
+    const uint8_t BAUD_TABLE_SIZE = sizeof(BAUD_TABLE) / sizeof(BAUD_TABLE[0]);
+
+    bool starts_with(const char *text, const char *prefix)
+    {
+        return strncmp(text, prefix, strlen(prefix)) == 0;
+    }
+}
+
+const char *BluetoothLE::Emulation::dialect_name(const Dialect dialect)
+{
+    switch (dialect) {
+        case Dialect::HMSoft:
+            return "HMSoft";
+        case Dialect::CC41:
+            return "CC41";
+        case Dialect::Extended:
+            return "Extended";
+        default:
+            return "Unknown";
+    }
+}
+
+BluetoothLE::Emulation::AT09Emulator::AT09Emulator(const EmulatorConfig &config)
+    : _config(config)
+{
+    strncpy(_name, config.name, sizeof(_name) - 1);
+}
+
+// ==================== SerialPeer ====================
+
+void BluetoothLE::Emulation::AT09Emulator::on_host_byte(const uint8_t byte, const uint64_t now_us)
+{
+    _stats.bytes_from_host++;
+    if (!_powered() || now_us < _busy_until_us || _host_baud != _config.baud) {
+        _stats.bytes_ignored++;
+        return;
+    }
+    if (_asleep) {
+        // Only a string longer than 80 bytes wakes the module, what it carries is discarded
+        if (++_wake_bytes > 80) {
+            _asleep = false;
+            _stats.wakes++;
+            _stats.asleep_us += now_us - _asleep_since_us;
+            _reply_at("OK+WAKE", now_us + static_cast<uint64_t>(_config.wake_latency_ms) * 1000);
+        }
+        return;
+    }
+    if (byte == '\r') {
+        return;
+    }
+    if (byte == '\n') {
+        _command[_command_length] = '\0';
+        if (_command_length > 0) {
+            _handle_command(_command, now_us);
+        }
+        _command_length = 0;
+        return;
+    }
+    if (_command_length < sizeof(_command) - 1) {
+        _command[_command_length++] = static_cast<char>(byte);
+    }
+}
+
+void BluetoothLE::Emulation::AT09Emulator::service(ArduinoShim::SerialPort &port, const uint64_t now_us)
+{
+    if (_link_up_at_us != 0 && now_us >= _link_up_at_us) {
+        _link_up_at_us = 0;
+        _set_link(true);
+    }
+    while (!_output.empty() && _output.front().at_us <= now_us) {
+        // A receiver running at another speed only sees framing garbage
+        const uint8_t value = (_host_baud == _output.front().baud) ? _output.front().value : '?';
+        const uint64_t at_us = _output.front().at_us;
+        _output.pop_front();
+        if (port.deliver(value, at_us)) {
+            _stats.bytes_to_host++;
+        } else {
+            _stats.bytes_dropped++;
+        }
+    }
+}
+
+void BluetoothLE::Emulation::AT09Emulator::on_host_baud(const uint32_t baud)
+{
+    _host_baud = baud;
+    _command_length = 0;
+}
+
+// ==================== Device population ====================
+
+void BluetoothLE::Emulation::AT09Emulator::add_beacon(const char *address, const char *name, const int8_t rssi, const uint32_t found_after_ms)
+{
+    add_ibeacon(address, name, rssi, found_after_ms, nullptr, 0, 0, 0);
+}
+
+void BluetoothLE::Emulation::AT09Emulator::add_ibeacon(const char *address, const char *name, const int8_t rssi, const uint32_t found_after_ms,
+    const char *uuid, const uint16_t major, const uint16_t minor, const int8_t tx_power)
+{
+    EmulatedBeacon beacon = {};
+    strncpy(beacon.address, address, sizeof(beacon.address) - 1);
+    strncpy(beacon.name, name ? name : "", sizeof(beacon.name) - 1);
+    beacon.rssi = rssi;
+    beacon.found_after_ms = found_after_ms;
+    // A device that is not an iBeacon is reported with a zeroed identity
+    const bool ibeacon = uuid != nullptr && tx_power != 0;
+    if (ibeacon) {
+        strncpy(beacon.uuid, uuid, sizeof(beacon.uuid) - 1);
+    } else {
+        memset(beacon.uuid, '0', sizeof(beacon.uuid) - 1);
+    }
+    beacon.major = ibeacon ? major : 0;
+    beacon.minor = ibeacon ? minor : 0;
+    beacon.tx_power = ibeacon ? tx_power : 0;
+    // The name is resolved somewhere in the window, the advertising packets were heard from the first period on
+    beacon.advertised_after_ms = (_config.advertising_interval_ms > 0) ? found_after_ms % _config.advertising_interval_ms : found_after_ms;
+    // Keep the population ordered by discovery time so replies stay monotonic
+    auto position = std::upper_bound(_beacons.begin(), _beacons.end(), beacon, [](const EmulatedBeacon &a, const EmulatedBeacon &b) {
+        return a.found_after_ms < b.found_after_ms;
+    });
+    _beacons.insert(position, beacon);
+}
+
+void BluetoothLE::Emulation::AT09Emulator::populate(const uint16_t count, const uint32_t seed, const int8_t rssi_min, const int8_t rssi_max)
+{
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> rssi(rssi_min, rssi_max);
+    std::uniform_int_distribution<uint32_t> found_after(0, (_config.scan_window_ms > 1) ? _config.scan_window_ms - 1 : 0);
+    std::uniform_int_distribution<uint32_t> octet(0, 255);
+    for (uint16_t i = 0; i < count; ++i) {
+        char address[13];
+        snprintf(address, sizeof(address), "%02X%02X%02X%02X%02X%02X", octet(engine), octet(engine), octet(engine), octet(engine), octet(engine), octet(engine));
+        char name[32];
+        snprintf(name, sizeof(name), "Beacon-%03u", static_cast<unsigned>(i));
+        add_ibeacon(address, name, static_cast<int8_t>(rssi(engine)), found_after(engine), _config.ibeacon_uuid, 1, i, _config.ibeacon_tx_power);
+    }
+}
+
+void BluetoothLE::Emulation::AT09Emulator::clear_beacons()
+{
+    _beacons.clear();
+}
+
+const std::vector<BluetoothLE::Emulation::EmulatedBeacon> &BluetoothLE::Emulation::AT09Emulator::beacons() const
+{
+    return _beacons;
+}
+
+BluetoothLE::Emulation::EmulatorConfig &BluetoothLE::Emulation::AT09Emulator::config()
+{
+    return _config;
+}
+
+const BluetoothLE::Emulation::EmulatorStats &BluetoothLE::Emulation::AT09Emulator::stats() const
+{
+    return _stats;
+}
+
+void BluetoothLE::Emulation::AT09Emulator::reset_stats()
+{
+    _stats = EmulatorStats();
+}
+
+uint8_t BluetoothLE::Emulation::AT09Emulator::role() const
+{
+    return _config.role;
+}
+
+uint32_t BluetoothLE::Emulation::AT09Emulator::module_baud() const
+{
+    return _config.baud;
+}
+
+bool BluetoothLE::Emulation::AT09Emulator::pending_output() const
+{
+    return !_output.empty();
+}
+
+bool BluetoothLE::Emulation::AT09Emulator::asleep() const
+{
+    return _asleep;
+}
+
+// ==================== Command handling ====================
+
+void BluetoothLE::Emulation::AT09Emulator::_handle_command(const char *command, const uint64_t now_us)
+{
+    _stats.commands++;
+    char reply[96];
+
+    if (strcmp(command, "AT") == 0) {
+        if (_linked) {
+            _set_link(false);
+            _reply("OK+LOST", now_us);
+        } else {
+            _reply("OK", now_us);
+        }
+    } else if (strcmp(command, "AT+ROLE?") == 0) {
+        _answer_role(true, _config.role, now_us);
+    } else if (starts_with(command, "AT+ROLE") && (command[7] == '0' || command[7] == '1') && command[8] == '\0') {
+        const uint8_t role = static_cast<uint8_t>(command[7] - '0');
+        if (role != _config.role) {
+            _stats.role_changes++;
+        }
+        _config.role = role;
+        _answer_role(false, role, now_us);
+    } else if (strcmp(command, "AT+DISC?") == 0) {
+        if (_config.dialect == Dialect::CC41 || _config.role != 1) {
+            _reply("ERROR", now_us);
+        } else {
+            _start_discovery(now_us);
+        }
+    } else if (strcmp(command, "AT+DISI?") == 0) {
+        if (_config.dialect == Dialect::CC41 || _config.role != 1) {
+            _reply("ERROR", now_us);
+        } else {
+            _start_advertisement_discovery(now_us);
+        }
+    } else if (strcmp(command, "AT+DISC") == 0) {
+        if (_config.dialect == Dialect::HMSoft || _config.role != 1) {
+            _reply("ERROR", now_us);
+        } else {
+            _start_discovery(now_us);
+        }
+    } else if (strcmp(command, "AT+NAME?") == 0) {
+        snprintf(reply, sizeof(reply), "OK+NAME:%s", _name);
+        _reply(reply, now_us);
+    } else if (starts_with(command, "AT+NAME")) {
+        strncpy(_name, command + 7, sizeof(_name) - 1);
+        _name[sizeof(_name) - 1] = '\0';
+        snprintf(reply, sizeof(reply), (_config.dialect == Dialect::CC41) ? "+NAME=%s\r\nOK" : "OK+Set:%s", _name);
+        _reply(reply, now_us);
+    } else if (strcmp(command, "AT+ADDR?") == 0) {
+        snprintf(reply, sizeof(reply), "OK+ADDR:%s", _config.address);
+        _reply(reply, now_us);
+    } else if (strcmp(command, "AT+VERS?") == 0) {
+        snprintf(reply, sizeof(reply), "OK+VERS:%s", _config.version);
+        _reply(reply, now_us);
+    } else if (strcmp(command, "AT+BAUD?") == 0) {
+        uint8_t index = 0;
+        while (index < BAUD_TABLE_SIZE && BAUD_TABLE[index] != _config.baud) {
+            index++;
+        }
+        snprintf(reply, sizeof(reply), "OK+Get:%u", static_cast<unsigned>(index));
+        _reply(reply, now_us);
+    } else if (starts_with(command, "AT+BAUD") && command[7] >= '0' && command[7] < '0' + BAUD_TABLE_SIZE && command[8] == '\0') {
+        snprintf(reply, sizeof(reply), "OK+Set:%c", command[7]);
+        // The confirmation still goes out at the old speed
+        _reply(reply, now_us);
+        _config.baud = BAUD_TABLE[command[7] - '0'];
+    } else if (starts_with(command, "AT+CON") && strlen(command) == 6 + 12) {
+        _reply("OK+CONNA", now_us);
+        const char *target = command + 6;
+        const bool known = std::any_of(_beacons.begin(), _beacons.end(), [target](const EmulatedBeacon &beacon) {
+            return strcmp(beacon.address, target) == 0;
+        });
+        const uint64_t done_us = now_us + static_cast<uint64_t>(_config.connect_latency_ms) * 1000;
+        _reply_at(known ? "OK+CONN" : "OK+CONNF", done_us);
+        if (known) {
+            _link_up_at_us = done_us;
+        }
+    } else if (strcmp(command, "AT+RESET") == 0) {
+        _set_link(false);
+        _reply("OK+RESET", now_us);
+        _busy_until_us = _output_end_us + static_cast<uint64_t>(_config.reset_time_ms) * 1000;
+    } else if (strcmp(command, "AT+SLEEP") == 0) {
+        _reply("OK+SLEEP", now_us);
+        _asleep = true;
+        _asleep_since_us = now_us;
+        _wake_bytes = 0;
+        _stats.sleeps++;
+    } else if (strcmp(command, "AT+PASS?") == 0) {
+        _reply("OK+Get:000000", now_us);
+    } else if (strcmp(command, "AT+TYPE?") == 0) {
+        _reply("OK+Get:0", now_us);
+    } else {
+        _stats.unknown_commands++;
+        _reply("ERROR", now_us);
+    }
+}
+
+void BluetoothLE::Emulation::AT09Emulator::_start_discovery(const uint64_t now_us)
+{
+    _stats.discoveries++;
+    const uint64_t window_start_us = now_us + _config.reply_latency_us;
+    if (_config.dialect != Dialect::CC41) {
+        _reply("OK+DISCS", now_us);
+    }
+
+    char line[96];
+    for (const EmulatedBeacon &beacon : _beacons) {
+        if (beacon.found_after_ms >= _config.scan_window_ms) {
+            continue;
+        }
+        switch (_config.dialect) {
+            case Dialect::HMSoft:
+                snprintf(line, sizeof(line), "OK+DIS0:%s", beacon.address);
+                break;
+            case Dialect::CC41:
+                snprintf(line, sizeof(line), "OK+DISC:%s:%04d", beacon.address, beacon.rssi);
+                break;
+            default:
+                snprintf(line, sizeof(line), "OK+DISA:%s:%s:%04d", beacon.address, beacon.name, beacon.rssi);
+                break;
+        }
+        _reply_at(line, window_start_us + static_cast<uint64_t>(beacon.found_after_ms) * 1000);
+    }
+
+    const uint64_t window_end_us = window_start_us + static_cast<uint64_t>(_config.scan_window_ms) * 1000;
+    _reply_at((_config.dialect == Dialect::CC41) ? "OK" : "OK+DISCE", window_end_us);
+}
+
+void BluetoothLE::Emulation::AT09Emulator::_start_advertisement_discovery(const uint64_t now_us)
+{
+    _stats.discoveries++;
+    _stats.advertisement_discoveries++;
+    const uint64_t window_start_us = now_us + _config.reply_latency_us;
+    _reply("OK+DISIS", now_us);
+
+    // The population is ordered by name resolution time, the packets arrive in another order
+    std::vector<const EmulatedBeacon *> heard;
+    for (const EmulatedBeacon &beacon : _beacons) {
+        if (beacon.advertised_after_ms < _config.scan_window_ms) {
+            heard.push_back(&beacon);
+        }
+    }
+    std::stable_sort(heard.begin(), heard.end(), [](const EmulatedBeacon *a, const EmulatedBeacon *b) {
+        return a->advertised_after_ms < b->advertised_after_ms;
+    });
+
+    char line[96];
+    for (const EmulatedBeacon *beacon : heard) {
+        const bool ibeacon = beacon->tx_power != 0;
+        snprintf(line, sizeof(line), "OK+DISC:%s:%s:%04X%04X%02X:%s:%04d", ibeacon ? "4C000215" : "00000000", beacon->uuid,
+            static_cast<unsigned>(beacon->major), static_cast<unsigned>(beacon->minor), static_cast<unsigned>(static_cast<uint8_t>(beacon->tx_power)),
+            beacon->address, beacon->rssi);
+        _reply_at(line, window_start_us + static_cast<uint64_t>(beacon->advertised_after_ms) * 1000);
+    }
+
+    const uint64_t window_end_us = window_start_us + static_cast<uint64_t>(_config.scan_window_ms) * 1000;
+    _reply_at("OK+DISCE", window_end_us);
+}
+
+void BluetoothLE::Emulation::AT09Emulator::_answer_role(const bool query, const uint8_t role, const uint64_t now_us)
+{
+    char reply[32];
+    switch (_config.dialect) {
+        case Dialect::CC41:
+            snprintf(reply, sizeof(reply), "+ROLE=%u\r\nOK", static_cast<unsigned>(role));
+            break;
+        case Dialect::Extended:
+            snprintf(reply, sizeof(reply), query ? "+Get:%u" : "OK+Set:%u", static_cast<unsigned>(role));
+            break;
+        default:
+            snprintf(reply, sizeof(reply), query ? "OK+Get:%u" : "OK+Set:%u", static_cast<unsigned>(role));
+            break;
+    }
+    _reply(reply, now_us);
+}
+
+void BluetoothLE::Emulation::AT09Emulator::_reply(const char *text, const uint64_t now_us)
+{
+    _reply_at(text, now_us + _config.reply_latency_us);
+}
+
+void BluetoothLE::Emulation::AT09Emulator::_reply_at(const char *text, const uint64_t at_us)
+{
+    // Bytes leave one after the other at the module baud rate, never overlapping a previous reply
+    uint64_t t = (at_us > _output_end_us) ? at_us : _output_end_us;
+    const uint32_t byte_time = _byte_time_us();
+    const size_t length = strlen(text);
+    for (size_t i = 0; i < length + 2 + 2 * static_cast<size_t>(_config.trailing_bytes); ++i) {
+        const uint8_t value = (i < length) ? static_cast<uint8_t>(text[i]) : (((i - length) % 2 == 0) ? '\r' : '\n');
+        t += byte_time;
+        _output.push_back({ t, value, _config.baud });
+    }
+    _output_end_us = t;
+}
+
+void BluetoothLE::Emulation::AT09Emulator::_set_link(const bool up)
+{
+    _linked = up;
+    ArduinoShim::Pins::set_analog(_config.state_pin, up ? 1024 : 0);
+}
+
+bool BluetoothLE::Emulation::AT09Emulator::_powered() const
+{
+    return _config.enable_pin == 255 || ArduinoShim::Pins::digital(_config.enable_pin);
+}
+
+uint32_t BluetoothLE::Emulation::AT09Emulator::_byte_time_us() const
+{
+    return static_cast<uint32_t>((10ULL * 1000000ULL + _config.baud - 1) / _config.baud);
+}
@@ -0,0 +1,165 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: at09_emulator.hpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the header of the AT-09 BLE module emulator used by the native benchmarks.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "arduino_shim.hpp"
+
+namespace BluetoothLE
+{
+    namespace Emulation
+    {
+        /**
+         * @brief Firmware families found on AT-09 / HM-10 style boards.
+         *
+         * They answer the same commands with different wording, which is
+         * what the handler's parsing has to cope with.
+         */
+        enum class Dialect : uint8_t {
+            HMSoft,     // OK+Get:1, AT+DISC? -> OK+DISCS / OK+DIS0:<addr> / OK+DISCE
+            CC41,       // +ROLE=1 then OK, AT+DISC? and AT+DISI? rejected, AT+DISC -> OK+DISC:<addr>:<rssi> ... OK
+            Extended    // +Get:1, AT+DISC? -> OK+DISCS / OK+DISA:<addr>:<name>:<rssi> / OK+DISCE
+            // HMSoft and Extended answer AT+DISI? with OK+DISIS / OK+DISC:<factory>:<uuid>:<ids>:<addr>:<rssi> / OK+DISCE
+        };
+
+        const char *dialect_name(const Dialect dialect);
+
+        struct EmulatorConfig {
+            Dialect dialect = Dialect::HMSoft;
+            uint32_t baud = 9600;                  // UART speed the module is configured for
+            uint32_t reply_latency_us = 4000;      // Command terminator to first reply byte
+            uint32_t scan_window_ms = 3000;        // Length of a discovery
+            uint32_t advertising_interval_ms = 1000;  // Beacon advertising period, AT+DISI? reports a beacon on its first packet
+            uint32_t connect_latency_ms = 800;     // AT+CON to OK+CONN
+            uint32_t reset_time_ms = 600;          // Module deaf after AT+RESET
+            uint32_t wake_latency_ms = 5;          // End of the wake-up string to OK+WAKE
+            uint8_t role = 0;                      // Role at power-up (0 = slave, 1 = master)
+            uint8_t trailing_bytes = 0;            // Extra "\r\n" pairs some boards append after a reply
+            uint8_t state_pin = 17;                // A0, driven high while a link is up
+            uint8_t enable_pin = 255;              // Module only answers while this pin is high (255 = always powered)
+            const char *name = "AT-09";
+            const char *address = "B0B448C0FFEE";
+            const char *version = "HMSoft V605";
+            const char *ibeacon_uuid = "74278BDAB64445208F0C720EAF059935";  // UUID given to the populate() beacons
+            int8_t ibeacon_tx_power = -59;         // Measured power given to the populate() beacons
+        };
+
+        struct EmulatedBeacon {
+            char address[13];
+            char name[32];
+            int8_t rssi;
+            uint32_t found_after_ms;  // When the beacon is reported inside the scan window
+            char uuid[33];            // iBeacon identity, zeroed (tx_power 0) for the other devices
+            uint16_t major;
+            uint16_t minor;
+            int8_t tx_power;
+            uint32_t advertised_after_ms;  // When AT+DISI? reports it: first advertising packet, no name to resolve
+        };
+
+        struct EmulatorStats {
+            uint64_t bytes_to_host = 0;
+            uint64_t bytes_from_host = 0;
+            uint64_t bytes_dropped = 0;        // Lost in the host receive FIFO
+            uint64_t bytes_ignored = 0;        // Received while unpowered, busy or at the wrong baud rate
+            uint32_t commands = 0;
+            uint32_t unknown_commands = 0;
+            uint32_t discoveries = 0;
+            uint32_t advertisement_discoveries = 0;  // AT+DISI? windows, also counted in discoveries
+            uint32_t role_changes = 0;
+            uint32_t sleeps = 0;
+            uint32_t wakes = 0;
+            uint64_t asleep_us = 0;            // Completed sleep periods
+        };
+
+        /**
+         * @brief Behavioural model of the AT-09 module on the far end of the BLE UART.
+         *
+         * Replies are serialised at the configured baud rate (10 bits per byte)
+         * and released to the firmware as the virtual clock advances, so the
+         * reading code sees the same partial lines, pauses and FIFO pressure as
+         * on the board. Discovery lines are spread over the scan window.
+         */
+        class AT09Emulator : public ArduinoShim::SerialPeer
+        {
+            public:
+            explicit AT09Emulator(const EmulatorConfig &config = EmulatorConfig());
+
+            // ArduinoShim::SerialPeer
+            void on_host_byte(const uint8_t byte, const uint64_t now_us) override;
+            void service(ArduinoShim::SerialPort &port, const uint64_t now_us) override;
+            void on_host_baud(const uint32_t baud) override;
+
+            // Device population
+            void add_beacon(const char *address, const char *name, const int8_t rssi, const uint32_t found_after_ms);
+            void add_ibeacon(const char *address, const char *name, const int8_t rssi, const uint32_t found_after_ms,
+                const char *uuid, const uint16_t major, const uint16_t minor, const int8_t tx_power);
+            void populate(const uint16_t count, const uint32_t seed, const int8_t rssi_min = -95, const int8_t rssi_max = -40);
+            void clear_beacons();
+            const std::vector<EmulatedBeacon> &beacons() const;
+
+            EmulatorConfig &config();
+            const EmulatorStats &stats() const;
+            void reset_stats();
+            uint8_t role() const;
+            uint32_t module_baud() const;
+            bool pending_output() const;
+            bool asleep() const;
+
+            private:
+            struct TimedByte {
+                uint64_t at_us;
+                uint8_t value;
+                uint32_t baud;  // Speed the byte is shifted out at
+            };
+
+            void _handle_command(const char *command, const uint64_t now_us);
+            void _start_discovery(const uint64_t now_us);
+            void _start_advertisement_discovery(const uint64_t now_us);
+            void _answer_role(const bool query, const uint8_t role, const uint64_t now_us);
+            void _reply(const char *text, const uint64_t now_us);
+            void _reply_at(const char *text, const uint64_t at_us);
+            void _set_link(const bool up);
+            bool _powered() const;
+            uint32_t _byte_time_us() const;
+
+            EmulatorConfig _config;
+            EmulatorStats _stats;
+            std::vector<EmulatedBeacon> _beacons;
+            std::deque<TimedByte> _output;
+            uint64_t _output_end_us = 0;     // When the last queued byte finishes shifting out
+            uint64_t _busy_until_us = 0;
+            uint64_t _link_up_at_us = 0;     // Pending OK+CONN (0 = none)
+            uint32_t _host_baud = 0;
+            char _name[21] = {};
+            char _command[64] = {};
+            size_t _command_length = 0;
+            bool _linked = false;
+            bool _asleep = false;
+            uint64_t _asleep_since_us = 0;
+            size_t _wake_bytes = 0;          // Bytes of the wake-up string received so far
+        };
+    }
+}
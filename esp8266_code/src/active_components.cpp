@@ -35,7 +35,8 @@
  * Key features:
  * - Persistent base frame with configurable background
  * - Transient node overlays that don't modify the base frame
- * - Temporary command system for activity indicators and data transmission
+ * - Temporary command system for activity indicators
+ * - Per-component traffic meter drawn as a decaying bar graph on the top strip
  * - Automatic expiration of temporary commands
  * - Safe bounds checking and overflow protection
  */
@@ -44,6 +45,9 @@
  // NOTE: direct struct assignment is safe for `LED::Colour` so helper removed
 
 int16_t MyUtils::ActiveComponents::Panel::_led_position = 0;
+uint16_t MyUtils::ActiveComponents::Panel::_traffic_bytes[] = {};
+uint8_t MyUtils::ActiveComponents::Panel::_traffic_level[] = {};
+uint32_t MyUtils::ActiveComponents::Panel::_traffic_decayed_ms = 0;
 MyUtils::ActiveComponents::LEDCommand MyUtils::ActiveComponents::_led_commands[LED_TOTAL_CMDS] = {};
 MyUtils::ActiveComponents::LEDCommand MyUtils::ActiveComponents::LED_DEFAULT_BACKGROUND = MyUtils::ActiveComponents::LEDCommand(
     0,
@@ -107,7 +111,7 @@ LED::ColourPos &MyUtils::ActiveComponents::Panel::get(Component c)
 {
     size_t idx = static_cast<size_t>(c);
     if (idx >= static_cast<size_t>(Component::_COUNT)) {
-        Serial << "CRITICAL: Invalid component index: " << idx << endl;
+        DebugSerial << "CRITICAL: Invalid component index: " << idx << endl;
         return _nodes[0]; // Return first node as fallback
     }
     return _nodes[idx];
@@ -148,7 +152,7 @@ void MyUtils::ActiveComponents::Panel::activity(const Component c, const bool ac
     // Map component to buffer slot (or find first inactive slot)
     LEDCommand *cmd = allocate_led_command();
     if (!cmd) {
-        Serial << "WARNING: LED command buffer full" << endl;
+        DebugSerial << "WARNING: LED command buffer full" << endl;
         return; // buffer full, drop ping
     }
 
@@ -158,72 +162,48 @@ void MyUtils::ActiveComponents::Panel::activity(const Component c, const bool ac
     cmd->startTime = millis();
     cmd->active = true;
 
-    Serial << "Component activity set at LED pos: " << pos << endl;
+    DebugSerial << "Component activity set at LED pos: " << pos << endl;
 }
 
 /**
- * @brief Display data transmission status on the top LED strip.
+ * @brief Raise the traffic bar of a component to a given height.
  *
- * Maps the component's position from the bottom strip (LEDs 0-14) to the corresponding
- * position in the top strip (LEDs 15-29), accounting for the physical U-shaped wiring
- * that flips the top strip. Shows up to 5 LEDs indicating transmission activity.
+ * The bar is drawn by render() and drains by one LED every LED_TRAFFIC_DECAY_MS,
+ * no command slot is used.
  *
- * Physical mapping:
- * - Bottom position 0 -> Top position 29 (rightmost)
- * - Bottom position 14 -> Top position 15 (leftmost)
- *
- * @param comp Component whose position determines the starting point
- * @param size Number of LEDs to illuminate (max 5), representing data transmission amount
+ * @param comp Component whose bar is raised
+ * @param size Number of LEDs to illuminate (max LED_TRAFFIC_MAX_LEDS)
  */
 void MyUtils::ActiveComponents::Panel::data_transmission(const Component comp, const uint8_t size)
 {
-    constexpr uint8_t BOTTOM_STRIP_SIZE = 15;  // LEDs 0-14
-    constexpr uint8_t TOP_STRIP_START = 15;    // LEDs 15-29
-    constexpr uint8_t MAX_TRANSMISSION_LEDS = 5;
-
-    // Get the component's current position in the bottom strip
-    LED::ColourPos &component_node = get(comp);
-    uint16_t bottom_pos = component_node.pos;
-
-    // Validate bottom position is in bottom strip
-    if (bottom_pos >= BOTTOM_STRIP_SIZE) {
-        Serial << "ERROR: Component position " << bottom_pos << " not in bottom strip" << endl;
+    const size_t idx = static_cast<size_t>(comp);
+    if (idx >= static_cast<size_t>(Component::_COUNT)) {
         return;
     }
+    const uint8_t level = static_cast<uint8_t>(min(size, LED_TRAFFIC_MAX_LEDS) * 16);
+    if (level > _traffic_level[idx]) {
+        _traffic_level[idx] = level;
+    }
+}
 
-    // Map to top strip position (accounting for physical flip: bottom pos 0 -> top pos 29, bottom pos 14 -> top pos 15)
-    const uint16_t top_start = TOP_STRIP_START + (BOTTOM_STRIP_SIZE - 1 - bottom_pos);
-
-    // Limit size to maximum allowed
-    const uint8_t shown = min(size, MAX_TRANSMISSION_LEDS);
-
-    LED::Colour &colour = component_node.colour;
-
-    for (uint8_t i = 0; i < MAX_TRANSMISSION_LEDS; ++i) {
-        // Calculate LED position (moving left from start position due to flip)
-        const uint16_t led_pos = top_start - i;
-
-        // Validate position is within top strip bounds
-        if (led_pos < TOP_STRIP_START || led_pos >= LED_NUMBER) {
-            break; // Out of top strip bounds
-        }
-
-        LEDCommand *cmd = allocate_led_command();
-        if (!cmd) {
-            Serial << "WARNING: LED command buffer full in data_transmission" << endl;
-            return; // buffer full, drop remaining
-        }
-
-        cmd->pos = led_pos;
-        if (i < shown) {
-            cmd->colour = colour;  // Show data transmission
-        } else {
-            cmd->colour = ActiveComponents::LED_DEFAULT_BACKGROUND.colour;  // Clear remaining
-        }
-        cmd->duration = 2000; // long duration to keep state visible
-        cmd->startTime = millis();
-        cmd->active = true;
+/**
+ * @brief Count bytes moved by a component.
+ *
+ * Cheap enough to be called for every chunk (or byte) of a transfer: the
+ * bytes are only added up here, the next render() turns them into the bar
+ * height (one LED for 1 byte, then one more each time the count doubles).
+ *
+ * @param comp Component that sent or received the bytes
+ * @param bytes Number of bytes
+ */
+void MyUtils::ActiveComponents::Panel::traffic(const Component comp, const size_t bytes)
+{
+    const size_t idx = static_cast<size_t>(comp);
+    if (idx >= static_cast<size_t>(Component::_COUNT)) {
+        return;
     }
+    const uint32_t total = _traffic_bytes[idx] + bytes;
+    _traffic_bytes[idx] = total > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(total);
 }
 
 
@@ -272,7 +252,7 @@ void MyUtils::ActiveComponents::Panel::render()
     for (uint16_t i = 0; i < LED_NUMBER; ++i) {
         // CRITICAL: Validate base frame access
         if (i >= LED_TOTAL_CMDS) {
-            Serial << "CRITICAL ERROR: Base frame index out of bounds: " << i << endl;
+            DebugSerial << "CRITICAL ERROR: Base frame index out of bounds: " << i << endl;
             continue;
         }
         LED::led_set_led_position(i, _led_commands[i].colour, 0, false);
@@ -287,12 +267,12 @@ void MyUtils::ActiveComponents::Panel::render()
 
         // Validate position before accessing arrays
         if (n.pos >= LED_NUMBER) {
-            Serial << "ERROR: Node[" << node_idx << "] position out of bounds: " << n.pos << endl;
+            DebugSerial << "ERROR: Node[" << node_idx << "] position out of bounds: " << n.pos << endl;
             continue;
         }
 
         if (n.pos >= LED_TOTAL_CMDS) {
-            Serial << "CRITICAL: Node[" << node_idx << "] position exceeds command buffer: " << n.pos << endl;
+            DebugSerial << "CRITICAL: Node[" << node_idx << "] position exceeds command buffer: " << n.pos << endl;
             continue;
         }
 
@@ -300,7 +280,13 @@ void MyUtils::ActiveComponents::Panel::render()
         LED::led_set_led_position(n.pos, n.colour, 0, false);
     }
 
-    // Step 3: Apply temporary commands (activity + data_transmission)
+    // Step 3: Traffic bars on the top strip, fed by traffic() and data_transmission()
+    _update_traffic(now);
+    for (size_t node_idx = 0; node_idx < static_cast<size_t>(Component::_COUNT); ++node_idx) {
+        _draw_traffic(node_idx);
+    }
+
+    // Step 4: Apply temporary commands (activity pings)
     // Start from LED_NUMBER to skip base frame slots
     for (uint16_t i = LED_NUMBER; i < LED_TOTAL_CMDS; ++i) {
         LEDCommand &cmd = _led_commands[i];
@@ -316,7 +302,7 @@ void MyUtils::ActiveComponents::Panel::render()
 
         // Validate position before accessing array
         if (cmd.pos >= LED_NUMBER) {
-            Serial << "ERROR: Command position out of bounds: " << cmd.pos << endl;
+            DebugSerial << "ERROR: Command position out of bounds: " << cmd.pos << endl;
             cmd.active = false; // Deactivate corrupt command
             continue;
         }
@@ -351,16 +337,16 @@ void MyUtils::ActiveComponents::Panel::debug_print_commands()
 {
     uint16_t base_count = 0;
     uint16_t temp_count = 0;
-    Serial << "=== LED Command Buffer Debug ===" << endl;
-    Serial << "Base Frame (0-" << (LED_NUMBER - 1) << "):" << endl;
+    DebugSerial << "=== LED Command Buffer Debug ===" << endl;
+    DebugSerial << "Base Frame (0-" << (LED_NUMBER - 1) << "):" << endl;
     for (uint16_t i = 0; i < LED_NUMBER; i++) {
         if (_led_commands[i].active) base_count++;
     }
-    Serial << "  Active: " << base_count << "/" << LED_NUMBER << endl;
+    DebugSerial << "  Active: " << base_count << "/" << LED_NUMBER << endl;
 
-    Serial << "Temporary Commands (" << LED_NUMBER << "-" << LED_TOTAL_CMDS - 1 << "):" << endl;
-    Serial << "Total active: " << base_count + temp_count << "/" << LED_TOTAL_CMDS << endl;
-    Serial << "=================================" << endl;
+    DebugSerial << "Temporary Commands (" << LED_NUMBER << "-" << LED_TOTAL_CMDS - 1 << "):" << endl;
+    DebugSerial << "Total active: " << base_count + temp_count << "/" << LED_TOTAL_CMDS << endl;
+    DebugSerial << "=================================" << endl;
 }
 
 void MyUtils::ActiveComponents::initialise_active_components()
@@ -368,40 +354,88 @@ void MyUtils::ActiveComponents::initialise_active_components()
     unsigned long artificial_delay = 50;
     Panel::build_base_frame();
     int16_t max_steps = component_id(Component::_COUNT);
-    Serial << "Total steps: " << max_steps << endl;
+    DebugSerial << "Total steps: " << max_steps << endl;
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 0, max_steps);
     delay(artificial_delay);
     Panel::initialize_clock();
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 1, max_steps);
-    Serial << "Clock animation set up" << endl;
+    DebugSerial << "Clock animation set up" << endl;
     delay(artificial_delay);
     Panel::initialize_component_status(Component::WifiStatus, false);
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 2, max_steps);
-    Serial << "Component status animations set up" << endl;
+    DebugSerial << "Component status animations set up" << endl;
     delay(artificial_delay);
     Panel::initialize_component_status(Component::Bluetooth, false);
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 3, max_steps);
-    Serial << " - Bluetooth: success" << endl;
+    DebugSerial << " - Bluetooth: success" << endl;
     delay(artificial_delay);
     Panel::initialize_component_status(Component::MotorLeft, false);
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 4, max_steps);
-    Serial << " - MotorLeft: success" << endl;
+    DebugSerial << " - MotorLeft: success" << endl;
     delay(artificial_delay);
     Panel::initialize_component_status(Component::MotorRight, false);
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 5, max_steps);
-    Serial << " - MotorRight: success" << endl;
+    DebugSerial << " - MotorRight: success" << endl;
     delay(artificial_delay);
     Panel::initialize_component_status(Component::Server, false);
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 6, max_steps);
-    Serial << " - Server: success" << endl;
+    DebugSerial << " - Server: success" << endl;
     delay(artificial_delay);
     Panel::initialize_component_status(Component::Error, false);
     MyUtils::display_percentage(LED::dark_blue, LED::green_colour, 7, max_steps);
-    Serial << " - Error: success" << endl;
+    DebugSerial << " - Error: success" << endl;
     Panel::build_base_frame();
 
     // Force a render to clear any artifacts from display_percentage calls
     delay(artificial_delay);
     Panel::render();
-    Serial << "Active components initialized - render complete" << endl;
+    DebugSerial << "Active components initialized - render complete" << endl;
+}
+
+// ==================== Private Helper Methods ====================
+
+void MyUtils::ActiveComponents::Panel::_update_traffic(const uint32_t now)
+{
+    // Linear decay in 1/16 LED steps, the remainder of the elapsed time is kept for the next frame
+    const uint32_t steps = ((now - _traffic_decayed_ms) * 16) / LED_TRAFFIC_DECAY_MS;
+    if (steps > 0) {
+        _traffic_decayed_ms += (steps * LED_TRAFFIC_DECAY_MS) / 16;
+    }
+    for (size_t idx = 0; idx < static_cast<size_t>(Component::_COUNT); ++idx) {
+        uint8_t level = (_traffic_level[idx] > steps) ? static_cast<uint8_t>(_traffic_level[idx] - steps) : 0;
+        uint16_t bytes = _traffic_bytes[idx];
+        if (bytes > 0) {
+            uint8_t leds = 0;
+            while (bytes > 0 && leds < LED_TRAFFIC_MAX_LEDS) {
+                leds++;
+                bytes >>= 1;
+            }
+            if (leds * 16 > level) {
+                level = static_cast<uint8_t>(leds * 16);
+            }
+            _traffic_bytes[idx] = 0;
+        }
+        _traffic_level[idx] = level;
+    }
+}
+
+void MyUtils::ActiveComponents::Panel::_draw_traffic(const size_t node_idx)
+{
+    const uint8_t lit = (_traffic_level[node_idx] + 15) / 16;
+    if (lit == 0) {
+        return;
+    }
+    const LED::ColourPos &n = _nodes[node_idx];
+    if (n.pos >= BOTTOM_STRIP_SIZE) {
+        return;
+    }
+    // The top strip is wired backwards: bottom pos 0 -> top pos 29, bottom pos 14 -> top pos 15
+    const uint16_t top_start = TOP_STRIP_START + (BOTTOM_STRIP_SIZE - 1 - n.pos);
+    for (uint8_t i = 0; i < lit; ++i) {
+        const uint16_t led_pos = top_start - i;
+        if (led_pos < TOP_STRIP_START || led_pos >= LED_NUMBER) {
+            break;
+        }
+        LED::led_set_led_position(led_pos, n.colour, 0, false);
+    }
 }
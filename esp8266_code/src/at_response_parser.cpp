@@ -0,0 +1,191 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: at_response_parser.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the byte-at-a-time parser for the AT-09 responses.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstring>
+#include "at_response_parser.hpp"
+#include "ble_constants.hpp"
+
+BluetoothLE::ATEvent BluetoothLE::ATResponseParser::feed(const uint8_t byte)
+{
+    if (_emitted) {
+        _begin_token();
+    }
+    if (byte == '\r' || byte == '\n' || byte == '\0') {
+        return _emit();
+    }
+    if (byte == 'O' && _length > 0 && _is_complete_token()) {
+        _carry = 'O';
+        return _emit();
+    }
+    if (_length < LINE_BUFFER_SIZE - 1) {
+        _buffer[_length++] = static_cast<char>(byte);
+    } else {
+        _truncated = true;
+    }
+    return ATEvent::None;
+}
+
+BluetoothLE::ATEvent BluetoothLE::ATResponseParser::flush()
+{
+    if (_emitted) {
+        _begin_token();
+    }
+    return _emit();
+}
+
+void BluetoothLE::ATResponseParser::reset()
+{
+    _length = 0;
+    _emitted = false;
+    _truncated = false;
+    _carry = '\0';
+    _event = ATEvent::None;
+    _buffer[0] = '\0';
+}
+
+bool BluetoothLE::ATResponseParser::pending() const
+{
+    return (!_emitted && _length > 0) || _carry != '\0';
+}
+
+const char *BluetoothLE::ATResponseParser::line() const
+{
+    return _buffer;
+}
+
+size_t BluetoothLE::ATResponseParser::length() const
+{
+    return _emitted ? _length : 0;
+}
+
+bool BluetoothLE::ATResponseParser::truncated() const
+{
+    return _truncated;
+}
+
+BluetoothLE::ATEvent BluetoothLE::ATResponseParser::last_event() const
+{
+    return _event;
+}
+
+bool BluetoothLE::ATResponseParser::is_terminal(const ATEvent event)
+{
+    switch (event) {
+        case ATEvent::Ok:
+        case ATEvent::Error:
+        case ATEvent::DiscoveryEnd:
+        case ATEvent::Connected:
+        case ATEvent::ConnectFailed:
+        case ATEvent::Lost:
+        case ATEvent::Value:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ==================== Private Helper Methods ====================
+
+void BluetoothLE::ATResponseParser::_begin_token()
+{
+    _length = 0;
+    _emitted = false;
+    _truncated = false;
+    if (_carry != '\0') {
+        _buffer[_length++] = _carry;
+        _carry = '\0';
+    }
+}
+
+BluetoothLE::ATEvent BluetoothLE::ATResponseParser::_emit()
+{
+    if (_length == 0) {
+        return ATEvent::None;
+    }
+    _buffer[_length] = '\0';
+    _emitted = true;
+    _event = _classify();
+    return _event;
+}
+
+bool BluetoothLE::ATResponseParser::_is_complete_token() const
+{
+    namespace Ok = AT::Responses::Ok;
+    if (_is(Ok::OK) || _is(Ok::DISCS) || _is(Ok::DISIS) || _is(Ok::DISCE) || _is(Ok::LOST) ||
+        _is(Ok::CONN) || _is(Ok::CONN_ACCEPTED) || _is(Ok::CONN_FAILED)) {
+        return true;
+    }
+    // A full AT+DISI? line, its fields have a fixed width
+    if (_length == Constants::DISI_LINE_LENGTH && _starts_with(Ok::DISC) && _buffer[Ok::DISC.size() + 8] == ':') {
+        return true;
+    }
+    // OK+DIS<x>:<12 hex digits>, the HMSoft discovery line without name nor RSSI
+    return _length == Ok::DIS.size() + 2 + Constants::BLE_ADDRESS_LENGTH &&
+        _starts_with(Ok::DIS) && _buffer[Ok::DIS.size() + 1] == ':';
+}
+
+bool BluetoothLE::ATResponseParser::_is(const std::string_view &token) const
+{
+    return _length == token.size() && memcmp(_buffer, token.data(), token.size()) == 0;
+}
+
+bool BluetoothLE::ATResponseParser::_starts_with(const std::string_view &prefix) const
+{
+    return _length >= prefix.size() && memcmp(_buffer, prefix.data(), prefix.size()) == 0;
+}
+
+BluetoothLE::ATEvent BluetoothLE::ATResponseParser::_classify() const
+{
+    namespace Ok = AT::Responses::Ok;
+    if (_is(Ok::OK)) {
+        return ATEvent::Ok;
+    }
+    if (_starts_with(AT::Responses::Error::ERROR)) {
+        return ATEvent::Error;
+    }
+    if (_is(Ok::DISCS) || _is(Ok::DISIS)) {
+        return ATEvent::DiscoveryStart;
+    }
+    if (_is(Ok::DISCE)) {
+        return ATEvent::DiscoveryEnd;
+    }
+    if (_starts_with(Ok::DIS)) {
+        return ATEvent::Device;
+    }
+    if (_is(Ok::CONN_ACCEPTED)) {
+        return ATEvent::Accepted;
+    }
+    if (_is(Ok::CONN_FAILED)) {
+        return ATEvent::ConnectFailed;
+    }
+    if (_starts_with(Ok::CONN)) {
+        return ATEvent::Connected;
+    }
+    if (_starts_with(Ok::LOST)) {
+        return ATEvent::Lost;
+    }
+    if (_starts_with("OK+") || _buffer[0] == '+') {
+        return ATEvent::Value;
+    }
+    return ATEvent::Line;
+}
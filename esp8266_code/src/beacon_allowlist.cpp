@@ -0,0 +1,164 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: beacon_allowlist.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the list of beacons the feeder is allowed to report.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstring>
+#include "beacon_allowlist.hpp"
+
+bool BluetoothLE::BeaconAllowlist::contains(const MacAddress &address) const
+{
+    uint8_t low = 0;
+    uint8_t high = _count;
+    while (low < high) {
+        const uint8_t middle = low + (high - low) / 2;
+        const int order = _compare(_entries[middle], address);
+        if (order == 0) {
+            return true;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
+
+bool BluetoothLE::BeaconAllowlist::allows(const MacAddress &address)
+{
+    if (_synced && !contains(address)) {
+        _stats.filtered++;
+        return false;
+    }
+    _stats.allowed++;
+    return true;
+}
+
+/**
+ * @brief Swap in the list received from the control server.
+ *
+ * @param addresses Beacons of the owner, in any order, duplicates allowed
+ * @param count Number of entries in addresses, at most BEACON_ALLOWLIST_CAPACITY are kept
+ * @param version ETag of the list, sent back by the next sync
+ * @param received Beacons the server listed (0 = count), the surplus is reported as truncated
+ * @return true The list changed
+ * @return false The server sent the list already held
+ */
+bool BluetoothLE::BeaconAllowlist::replace(const MacAddress *addresses, const uint8_t count, const char *version, const uint32_t received)
+{
+    MacAddress fresh[BEACON_ALLOWLIST_CAPACITY];
+    uint8_t fresh_count = 0;
+    const uint8_t kept = count < BEACON_ALLOWLIST_CAPACITY ? count : BEACON_ALLOWLIST_CAPACITY;
+
+    // Insertion sort, the list is small and usually arrives sorted already
+    for (uint8_t i = 0; i < kept; ++i) {
+        uint8_t position = fresh_count;
+        while (position > 0 && _compare(fresh[position - 1], addresses[i]) > 0) {
+            position--;
+        }
+        if (position > 0 && fresh[position - 1] == addresses[i]) {
+            continue;
+        }
+        memmove(fresh + position + 1, fresh + position, (fresh_count - position) * sizeof(fresh[0]));
+        fresh[position] = addresses[i];
+        fresh_count++;
+    }
+
+    const uint32_t listed = received > count ? received : count;
+    _stats.truncated = listed - kept;
+    _stats.syncs++;
+    _synced = true;
+    strncpy(_version, version != nullptr ? version : "", VERSION_SIZE - 1);
+    _version[VERSION_SIZE - 1] = '\0';
+
+    const bool changed = fresh_count != _count || memcmp(fresh, _entries, fresh_count * sizeof(fresh[0])) != 0;
+    memcpy(_entries, fresh, fresh_count * sizeof(fresh[0]));
+    _count = fresh_count;
+    return changed;
+}
+
+void BluetoothLE::BeaconAllowlist::confirm()
+{
+    _stats.syncs++;
+    _stats.not_modified++;
+}
+
+void BluetoothLE::BeaconAllowlist::record_failure()
+{
+    _stats.failures++;
+}
+
+bool BluetoothLE::BeaconAllowlist::synced() const
+{
+    return _synced;
+}
+
+const char *BluetoothLE::BeaconAllowlist::version() const
+{
+    return _version;
+}
+
+uint8_t BluetoothLE::BeaconAllowlist::count() const
+{
+    return _count;
+}
+
+const BluetoothLE::MacAddress *BluetoothLE::BeaconAllowlist::entries() const
+{
+    return _entries;
+}
+
+const BluetoothLE::BeaconAllowlistStats &BluetoothLE::BeaconAllowlist::stats() const
+{
+    return _stats;
+}
+
+void BluetoothLE::BeaconAllowlist::clear()
+{
+    _count = 0;
+    _synced = false;
+    _version[0] = '\0';
+    _stats = BeaconAllowlistStats();
+}
+
+void BluetoothLE::BeaconAllowlist::print() const
+{
+    DebugSerial << "========== Beacon Allowlist ==========" << endl;
+    if (!_synced) {
+        DebugSerial << "Not synced yet, every beacon is reported" << endl;
+    } else {
+        DebugSerial << "Version " << _version << ", " << _count << "/" << BEACON_ALLOWLIST_CAPACITY << " beacons" << endl;
+        for (uint8_t i = 0; i < _count; ++i) {
+            DebugSerial << "  " << _entries[i] << endl;
+        }
+    }
+    DebugSerial << "Syncs: " << _stats.syncs << " (" << _stats.not_modified << " unchanged), failures: " << _stats.failures << endl;
+    DebugSerial << "Allowed: " << _stats.allowed << ", filtered: " << _stats.filtered << endl;
+    DebugSerial << "======================================" << endl;
+}
+
+// ==================== Private Helper Methods ====================
+
+int BluetoothLE::BeaconAllowlist::_compare(const MacAddress &left, const MacAddress &right)
+{
+    return memcmp(left.bytes, right.bytes, MacAddress::SIZE);
+}
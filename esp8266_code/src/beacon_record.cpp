@@ -0,0 +1,197 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: beacon_record.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the iBeacon record read from the AT+DISI? discovery lines.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "beacon_record.hpp"
+
+namespace
+{
+    constexpr uint32_t IBEACON_FACTORY_ID = 0x4C000215;  // Apple company id, iBeacon type and length
+    constexpr size_t FACTORY_OFFSET = BluetoothLE::AT::Responses::Ok::DISC.size();
+    constexpr size_t UUID_OFFSET = FACTORY_OFFSET + 8 + 1;
+    constexpr size_t IDS_OFFSET = UUID_OFFSET + BluetoothLE::BeaconRecord::UUID_HEX_LENGTH + 1;  // major, minor, TX power
+    constexpr size_t MAC_OFFSET = IDS_OFFSET + 10 + 1;
+    constexpr size_t RSSI_OFFSET = MAC_OFFSET + BluetoothLE::Constants::BLE_ADDRESS_LENGTH + 1;
+
+    int8_t hex_value(const char c)
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    bool read_hex(const char *hex, const size_t digits, uint32_t &value)
+    {
+        value = 0;
+        for (size_t i = 0; i < digits; ++i) {
+            const int8_t nibble = hex_value(hex[i]);
+            if (nibble < 0) {
+                return false;
+            }
+            value = (value << 4) | static_cast<uint32_t>(nibble);
+        }
+        return true;
+    }
+}
+
+bool BluetoothLE::BeaconRecord::parse(const char *line, size_t length)
+{
+    if (!is_advertisement_line(line, length)) {
+        return false;
+    }
+    uint32_t factory = 0;
+    uint32_t major_value = 0;
+    uint32_t minor_value = 0;
+    uint32_t tx_value = 0;
+    if (!read_hex(line + FACTORY_OFFSET, 8, factory) ||
+        !parse_uuid(line + UUID_OFFSET, UUID_HEX_LENGTH, uuid) ||
+        !read_hex(line + IDS_OFFSET, 4, major_value) ||
+        !read_hex(line + IDS_OFFSET + 4, 4, minor_value) ||
+        !read_hex(line + IDS_OFFSET + 8, 2, tx_value) ||
+        !address.parse(line + MAC_OFFSET, Constants::BLE_ADDRESS_LENGTH)) {
+        return false;
+    }
+    ibeacon = factory == IBEACON_FACTORY_ID;
+    major = static_cast<uint16_t>(major_value);
+    minor = static_cast<uint16_t>(minor_value);
+    // The measured power is a two's complement byte, 0xC5 = -59 dBm
+    tx_power = ibeacon ? static_cast<int8_t>(tx_value) : 0;
+    rssi = static_cast<int8_t>(atoi(line + RSSI_OFFSET));
+    return true;
+}
+
+bool BluetoothLE::BeaconRecord::matches(const uint8_t *filter_uuid, int32_t filter_major, int32_t filter_minor) const
+{
+    if (!ibeacon) {
+        return false;
+    }
+    if (filter_uuid != nullptr && memcmp(uuid, filter_uuid, UUID_SIZE) != 0) {
+        return false;
+    }
+    return (filter_major < 0 || filter_major == major) && (filter_minor < 0 || filter_minor == minor);
+}
+
+uint16_t BluetoothLE::BeaconRecord::distance_cm() const
+{
+    return estimate_distance_cm(rssi, tx_power);
+}
+
+bool BluetoothLE::BeaconRecord::is_advertisement_line(const char *line, size_t length)
+{
+    // The name based lines have the MAC address right after the prefix, no separator 8 characters in
+    return line != nullptr && length > RSSI_OFFSET &&
+        memcmp(line, AT::Responses::Ok::DISC.data(), FACTORY_OFFSET) == 0 &&
+        line[UUID_OFFSET - 1] == ':' && line[IDS_OFFSET - 1] == ':' && line[MAC_OFFSET - 1] == ':' && line[RSSI_OFFSET - 1] == ':';
+}
+
+bool BluetoothLE::BeaconRecord::parse_uuid(const char *hex, size_t length, uint8_t *uuid)
+{
+    if (hex == nullptr || uuid == nullptr) {
+        return false;
+    }
+    size_t digits = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (hex[i] == '-') {
+            continue;
+        }
+        const int8_t nibble = hex_value(hex[i]);
+        if (nibble < 0 || digits >= UUID_HEX_LENGTH) {
+            return false;
+        }
+        uuid[digits / 2] = (digits % 2 == 0) ? (nibble << 4) : (uuid[digits / 2] | nibble);
+        digits++;
+    }
+    return digits == UUID_HEX_LENGTH;
+}
+
+int8_t BluetoothLE::BeaconRecord::normalise_rssi(int8_t rssi, int8_t tx_power)
+{
+    if (tx_power == 0) {
+        return rssi;
+    }
+    // A tag advertising a weaker measured power is closer than its raw RSSI suggests
+    const int16_t normalised = static_cast<int16_t>(rssi) + (Constants::REFERENCE_TX_POWER - tx_power);
+    if (normalised < -127) {
+        return -127;
+    }
+    return (normalised > 0) ? 0 : static_cast<int8_t>(normalised);
+}
+
+uint16_t BluetoothLE::BeaconRecord::estimate_distance_cm(int8_t rssi, int8_t tx_power)
+{
+    if (tx_power == 0 || rssi == 0) {
+        return 0;
+    }
+    // d = 10 ^ ((TX power - RSSI) / (10 * n)), in meters
+    const float meters = powf(10.0f, static_cast<float>(tx_power - rssi) / (10.0f * Constants::PATH_LOSS_EXPONENT));
+    const float centimeters = meters * 100.0f;
+    return (centimeters >= 65535.0f) ? 65535 : static_cast<uint16_t>(centimeters + 0.5f);
+}
+
+uint8_t BluetoothLE::BeaconUuidPool::intern(const uint8_t *uuid)
+{
+    if (uuid == nullptr) {
+        return BLEDevice::NO_UUID;
+    }
+    for (uint8_t id = 0; id < _count; ++id) {
+        if (memcmp(_uuids[id], uuid, BeaconRecord::UUID_SIZE) == 0) {
+            return id;
+        }
+    }
+    if (_count >= Constants::MAX_BEACON_UUIDS) {
+        _rejected++;
+        return BLEDevice::NO_UUID;
+    }
+    memcpy(_uuids[_count], uuid, BeaconRecord::UUID_SIZE);
+    return _count++;
+}
+
+const uint8_t *BluetoothLE::BeaconUuidPool::get(const uint8_t id) const
+{
+    return (id < _count) ? _uuids[id] : nullptr;
+}
+
+void BluetoothLE::BeaconUuidPool::clear()
+{
+    _count = 0;
+    _rejected = 0;
+}
+
+uint8_t BluetoothLE::BeaconUuidPool::count() const
+{
+    return _count;
+}
+
+uint16_t BluetoothLE::BeaconUuidPool::rejected() const
+{
+    return _rejected;
+}
@@ -0,0 +1,256 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: beacon_tracker.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the table tracking the beacons seen around the feeder across scans.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "beacon_tracker.hpp"
+
+int8_t BluetoothLE::TrackedBeacon::rssi() const
+{
+    // Round to nearest, arithmetic shift keeps the sign of negative values
+    return static_cast<int8_t>((rssi_x16 + 8) >> 4);
+}
+
+/**
+ * @brief Feed one scan sample to the table.
+ *
+ * @param address MAC address reported by the scan
+ * @param rssi Raw signal strength of the sample (dBm)
+ * @param now_ms Time of the sample (millis())
+ * @param entry Receives the beacon entry (nullptr when the table is full)
+ * @return BeaconTransition Presence change caused by the sample
+ */
+BluetoothLE::BeaconTransition BluetoothLE::BeaconTracker::observe(const MacAddress &address, const int8_t rssi, const uint32_t now_ms, const TrackedBeacon **entry)
+{
+    if (entry != nullptr) {
+        *entry = nullptr;
+    }
+    _stats.observations++;
+
+    uint8_t probes = 0;
+    int16_t index = _lookup(address, &probes);
+    _stats.probes += probes;
+
+    if (index < 0) {
+        if (_count >= MAX_TRACKED) {
+            _stats.dropped++;
+            return BeaconTransition::None;
+        }
+        // The lookup stopped on the first free slot of the chain, start from the hash again to claim it
+        uint8_t free_slot = _hash(address);
+        while (_slots[free_slot].used) {
+            free_slot = (free_slot + 1) & (BEACON_TRACKER_CAPACITY - 1);
+        }
+        TrackedBeacon &fresh = _slots[free_slot];
+        fresh = TrackedBeacon();
+        fresh.address = address;
+        fresh.used = true;
+        fresh.first_seen_ms = now_ms;
+        fresh.rssi_x16 = static_cast<int16_t>(rssi * 16);  // The first sample seeds the average
+        _count++;
+        index = free_slot;
+    } else {
+        TrackedBeacon &known = _slots[index];
+        known.rssi_x16 += static_cast<int16_t>((rssi * 16 - known.rssi_x16) / (1 << BEACON_RSSI_SMOOTHING_SHIFT));
+    }
+
+    TrackedBeacon &beacon = _slots[index];
+    beacon.last_rssi = rssi;
+    beacon.last_seen_ms = now_ms;
+    if (beacon.sightings < UINT16_MAX) {
+        beacon.sightings++;
+    }
+    if (entry != nullptr) {
+        *entry = &beacon;
+    }
+
+    const int8_t smoothed = beacon.rssi();
+    if (!beacon.present && smoothed >= BEACON_ENTER_RSSI) {
+        beacon.present = true;
+        beacon.entered_ms = now_ms;
+        beacon.last_reported_ms = 0;
+        _stats.entered++;
+        DebugSerial << "[Beacons] " << beacon.address << " entered (" << smoothed << " dBm smoothed)" << endl;
+        return BeaconTransition::Entered;
+    }
+    if (beacon.present && smoothed < BEACON_LEAVE_RSSI) {
+        return _leave(beacon, now_ms, "signal");
+    }
+    return BeaconTransition::None;
+}
+
+uint8_t BluetoothLE::BeaconTracker::expire(const uint32_t now_ms)
+{
+    uint8_t left = 0;
+    uint8_t index = 0;
+    while (index < BEACON_TRACKER_CAPACITY) {
+        TrackedBeacon &beacon = _slots[index];
+        if (!beacon.used) {
+            index++;
+            continue;
+        }
+        const uint32_t silent_ms = now_ms - beacon.last_seen_ms;
+        if (beacon.present && silent_ms >= BEACON_LEAVE_TIMEOUT_MS) {
+            _leave(beacon, now_ms, "timeout");
+            left++;
+        }
+        if (silent_ms >= BEACON_FORGET_TIMEOUT_MS) {
+            _stats.forgotten++;
+            // The shift may move another entry into this slot, inspect it again
+            _remove(index);
+            continue;
+        }
+        index++;
+    }
+    return left;
+}
+
+const BluetoothLE::TrackedBeacon *BluetoothLE::BeaconTracker::find(const MacAddress &address) const
+{
+    const int16_t index = _lookup(address);
+    return (index < 0) ? nullptr : &_slots[index];
+}
+
+bool BluetoothLE::BeaconTracker::mark_reported(const MacAddress &address, const uint32_t now_ms)
+{
+    const int16_t index = _lookup(address);
+    if (index < 0) {
+        return false;
+    }
+    // 0 means "never reported", avoid it right after millis() wraps
+    _slots[index].last_reported_ms = (now_ms == 0) ? 1 : now_ms;
+    return true;
+}
+
+bool BluetoothLE::BeaconTracker::retry_report(const MacAddress &address, const uint32_t now_ms)
+{
+    // Ages like a report made BEACON_REPORT_INTERVAL - BEACON_REPORT_RETRY_INTERVAL ago
+    return mark_reported(address, now_ms - (BEACON_REPORT_INTERVAL - BEACON_REPORT_RETRY_INTERVAL));
+}
+
+uint8_t BluetoothLE::BeaconTracker::count() const
+{
+    return _count;
+}
+
+uint8_t BluetoothLE::BeaconTracker::present_count() const
+{
+    uint8_t present = 0;
+    for (uint8_t i = 0; i < BEACON_TRACKER_CAPACITY; ++i) {
+        if (_slots[i].used && _slots[i].present) {
+            present++;
+        }
+    }
+    return present;
+}
+
+const BluetoothLE::TrackedBeacon *BluetoothLE::BeaconTracker::slot(const uint8_t index) const
+{
+    if (index >= BEACON_TRACKER_CAPACITY) {
+        return nullptr;
+    }
+    return &_slots[index];
+}
+
+const BluetoothLE::BeaconTrackerStats &BluetoothLE::BeaconTracker::stats() const
+{
+    return _stats;
+}
+
+void BluetoothLE::BeaconTracker::clear()
+{
+    for (uint8_t i = 0; i < BEACON_TRACKER_CAPACITY; ++i) {
+        _slots[i] = TrackedBeacon();
+    }
+    _count = 0;
+}
+
+void BluetoothLE::BeaconTracker::print() const
+{
+    const uint32_t now = millis();
+    DebugSerial << "========== Tracked Beacons ==========" << endl;
+    DebugSerial << "Tracked: " << _count << "/" << MAX_TRACKED << ", present: " << present_count() << endl;
+    for (uint8_t i = 0; i < BEACON_TRACKER_CAPACITY; ++i) {
+        const TrackedBeacon &beacon = _slots[i];
+        if (!beacon.used) {
+            continue;
+        }
+        DebugSerial << "  " << beacon.address << (beacon.present ? " [present]" : "") << " RSSI " << beacon.rssi() << " dBm (last " << beacon.last_rssi << ")";
+        DebugSerial << ", seen " << beacon.sightings << "x, last " << (now - beacon.last_seen_ms) << " ms ago" << endl;
+    }
+    DebugSerial << "Entered: " << _stats.entered << ", left: " << _stats.left << ", forgotten: " << _stats.forgotten << ", dropped: " << _stats.dropped << endl;
+    DebugSerial << "=====================================" << endl;
+}
+
+// ==================== Private Helper Methods ====================
+
+uint8_t BluetoothLE::BeaconTracker::_hash(const MacAddress &address)
+{
+    return static_cast<uint8_t>(address.hash() & (BEACON_TRACKER_CAPACITY - 1));
+}
+
+int16_t BluetoothLE::BeaconTracker::_lookup(const MacAddress &address, uint8_t *probes) const
+{
+    uint8_t index = _hash(address);
+    // At least one slot is always free (load factor < 1), so the chain ends
+    for (uint8_t probe = 1; probe <= BEACON_TRACKER_CAPACITY; ++probe) {
+        const TrackedBeacon &beacon = _slots[index];
+        if (!beacon.used || beacon.address == address) {
+            if (probes != nullptr) {
+                *probes = probe;
+            }
+            return beacon.used ? index : -1;
+        }
+        index = (index + 1) & (BEACON_TRACKER_CAPACITY - 1);
+    }
+    return -1;
+}
+
+void BluetoothLE::BeaconTracker::_remove(uint8_t index)
+{
+    constexpr uint8_t mask = BEACON_TRACKER_CAPACITY - 1;
+    _slots[index] = TrackedBeacon();
+    _count--;
+
+    // Pull back the following entries of the chain that would no longer be reachable
+    uint8_t hole = index;
+    uint8_t next = (index + 1) & mask;
+    while (_slots[next].used) {
+        const uint8_t home = _hash(_slots[next].address);
+        // Distance travelled from the home slot, for the entry and for the hole
+        const uint8_t entry_distance = (next - home) & mask;
+        const uint8_t hole_distance = (next - hole) & mask;
+        if (entry_distance >= hole_distance) {
+            _slots[hole] = _slots[next];
+            _slots[next] = TrackedBeacon();
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+BluetoothLE::BeaconTransition BluetoothLE::BeaconTracker::_leave(TrackedBeacon &beacon, const uint32_t now_ms, const char *reason)
+{
+    beacon.present = false;
+    _stats.left++;
+    DebugSerial << "[Beacons] " << beacon.address << " left (" << reason << ", stayed " << (now_ms - beacon.entered_ms) << " ms)" << endl;
+    return BeaconTransition::Left;
+}
@@ -0,0 +1,265 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ble_command_channel.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the framed binary command protocol spoken with a phone paired over bluetooth.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstring>
+#include <Arduino.h>
+#include "config.hpp"
+#include "my_overloads.hpp"
+#include "shared_dependencies.hpp"
+#include "ble_command_channel.hpp"
+
+namespace
+{
+    void put_u16(uint8_t *out, const uint16_t value)
+    {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void put_u32(uint8_t *out, const uint32_t value)
+    {
+        put_u16(out, static_cast<uint16_t>(value));
+        put_u16(out + 2, static_cast<uint16_t>(value >> 16));
+    }
+}
+
+uint8_t BluetoothLE::Protocol::crc8(const uint8_t *data, const size_t length, uint8_t crc)
+{
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Feed one byte received from the phone.
+ *
+ * @param byte Byte read from the module
+ * @param now_ms Time of the byte (millis()), used to drop frames cut in the middle
+ * @param response Receives the frame to send back
+ * @param response_size Size of response, Protocol::MAX_RESPONSE_SIZE always fits
+ * @return size_t Length of the response to send, 0 while the request is incomplete
+ */
+size_t BluetoothLE::CommandChannel::feed(const uint8_t byte, const uint32_t now_ms, uint8_t *response, const size_t response_size)
+{
+    if (_state != State::Start && now_ms - _last_byte_ms > Protocol::FRAME_TIMEOUT_MS) {
+        _stats.timeouts++;
+        _state = State::Start;
+    }
+    _last_byte_ms = now_ms;
+
+    switch (_state) {
+        case State::Start:
+            if (byte == Protocol::REQUEST_START) {
+                _state = State::Opcode;
+            } else {
+                _stats.stray_bytes++;
+            }
+            return 0;
+        case State::Opcode:
+            _frame.opcode = byte;
+            _state = State::Seq;
+            return 0;
+        case State::Seq:
+            _frame.seq = byte;
+            _state = State::Length;
+            return 0;
+        case State::Length:
+            _frame.length = byte;
+            _received = 0;
+            if (byte > Protocol::MAX_PAYLOAD) {
+                // The payload cannot be stored, answer now and resynchronise on the next start byte
+                _state = State::Start;
+                _stats.rejected++;
+                _frame.length = 0;
+                return _encode(_frame, Protocol::Status::BadLength, nullptr, 0, response, response_size);
+            }
+            _state = (byte == 0) ? State::Checksum : State::Payload;
+            return 0;
+        case State::Payload:
+            _frame.payload[_received++] = byte;
+            if (_received == _frame.length) {
+                _state = State::Checksum;
+            }
+            return 0;
+        case State::Checksum: {
+            _state = State::Start;
+            const uint8_t header[3] = { _frame.opcode, _frame.seq, _frame.length };
+            const uint8_t crc = Protocol::crc8(_frame.payload, _frame.length, Protocol::crc8(header, sizeof(header)));
+            if (crc != byte) {
+                _stats.bad_checksum++;
+                _stats.rejected++;
+                return _encode(_frame, Protocol::Status::BadChecksum, nullptr, 0, response, response_size);
+            }
+            const uint32_t start_us = micros();
+            const size_t length = _dispatch(response, response_size);
+            _stats.last_dispatch_us = micros() - start_us;
+            if (_stats.last_dispatch_us > _stats.worst_dispatch_us) {
+                _stats.worst_dispatch_us = _stats.last_dispatch_us;
+            }
+            return length;
+        }
+    }
+    return 0;
+}
+
+void BluetoothLE::CommandChannel::reset()
+{
+    _state = State::Start;
+    _received = 0;
+}
+
+const BluetoothLE::Protocol::CommandStats &BluetoothLE::CommandChannel::stats() const
+{
+    return _stats;
+}
+
+// ==================== Private Helper Methods ====================
+
+size_t BluetoothLE::CommandChannel::_dispatch(uint8_t *response, const size_t response_size)
+{
+    using Protocol::Opcode;
+    using Protocol::Status;
+
+    uint8_t payload[Protocol::MAX_PAYLOAD];
+    uint8_t length = 0;
+    Status status = Status::Ok;
+
+    switch (static_cast<Opcode>(_frame.opcode)) {
+        case Opcode::Ping:
+            memcpy(payload, _frame.payload, _frame.length);
+            length = _frame.length;
+            break;
+        case Opcode::Status:
+            length = _status(payload);
+            break;
+        case Opcode::Devices:
+            if (_frame.length != 1) {
+                status = Status::BadLength;
+                break;
+            }
+            length = _devices(_frame, payload);
+            break;
+        case Opcode::Connect:
+            status = _connect(_frame);
+            break;
+        case Opcode::Feed:
+            status = _feed(_frame, payload);
+            length = (status == Status::Ok) ? 2 : 0;
+            break;
+        case Opcode::Hello:
+            length = static_cast<uint8_t>(min(strlen(BOARD_NAME), static_cast<size_t>(Protocol::MAX_PAYLOAD)));
+            memcpy(payload, BOARD_NAME, length);
+            break;
+        default:
+            status = Status::UnknownOpcode;
+            break;
+    }
+    if (status == Status::Ok) {
+        _stats.frames++;
+    } else {
+        _stats.rejected++;
+    }
+    return _encode(_frame, status, payload, length, response, response_size);
+}
+
+size_t BluetoothLE::CommandChannel::_encode(const Protocol::CommandFrame &request, const Protocol::Status status, const uint8_t *payload, const uint8_t length, uint8_t *response, const size_t response_size)
+{
+    const size_t total = 5 + length + 1;
+    if (response == nullptr || response_size < total) {
+        return 0;
+    }
+    response[0] = Protocol::RESPONSE_START;
+    response[1] = request.opcode;
+    response[2] = request.seq;
+    response[3] = static_cast<uint8_t>(status);
+    response[4] = length;
+    if (length > 0) {
+        memcpy(response + 5, payload, length);
+    }
+    response[5 + length] = Protocol::crc8(response + 1, 4 + length);
+    return total;
+}
+
+uint8_t BluetoothLE::CommandChannel::_status(uint8_t *payload)
+{
+    put_u32(payload, millis());
+    put_u32(payload + 4, ESP.getFreeHeap());
+    payload[8] = static_cast<uint8_t>(SharedDependencies::bleHandler->getCachedRole());
+    payload[9] = SharedDependencies::bleHandler->getDeviceCount();
+    payload[10] = SharedDependencies::beaconTracker->present_count();
+    payload[11] = SharedDependencies::feeder->is_busy() ? 1 : 0;
+    payload[12] = SharedDependencies::beaconAllowlist->count();
+    return 13;
+}
+
+uint8_t BluetoothLE::CommandChannel::_devices(const Protocol::CommandFrame &request, uint8_t *payload)
+{
+    const uint8_t total = SharedDependencies::bleHandler->getDeviceCount();
+    const BLEDevice *devices = SharedDependencies::bleHandler->getScannedDevices();
+    const uint8_t offset = request.payload[0];
+    payload[0] = total;
+    payload[1] = offset;
+    uint8_t length = 2;
+    for (uint8_t i = offset; i < total && i - offset < Protocol::DEVICES_PER_PAGE; ++i) {
+        memcpy(payload + length, devices[i].address.bytes, MacAddress::SIZE);
+        payload[length + MacAddress::SIZE] = static_cast<uint8_t>(devices[i].rssi);
+        length += MacAddress::SIZE + 1;
+    }
+    return length;
+}
+
+BluetoothLE::Protocol::Status BluetoothLE::CommandChannel::_connect(const Protocol::CommandFrame &request)
+{
+    if (request.length != MacAddress::SIZE) {
+        return Protocol::Status::BadLength;
+    }
+    MacAddress address;
+    memcpy(address.bytes, request.payload, MacAddress::SIZE);
+    char hex[MacAddress::HEX_LENGTH + 1];
+    address.to_hex(hex);
+    return SharedDependencies::bleHandler->connectToDevice(hex) ? Protocol::Status::Ok : Protocol::Status::Failed;
+}
+
+BluetoothLE::Protocol::Status BluetoothLE::CommandChannel::_feed(const Protocol::CommandFrame &request, uint8_t *payload)
+{
+    if (request.length != 2) {
+        return Protocol::Status::BadLength;
+    }
+    uint16_t grams = static_cast<uint16_t>(request.payload[0] | (request.payload[1] << 8));
+    if (grams == 0) {
+        return Protocol::Status::Failed;
+    }
+    if (grams > MAX_FEEDING_SINGLE_PORTION) {
+        grams = MAX_FEEDING_SINGLE_PORTION;
+    }
+    if (!SharedDependencies::feeder->start(grams, millis())) {
+        return Protocol::Status::Busy;
+    }
+    DebugSerial << "[Command] Feeding " << grams << " g requested over bluetooth" << endl;
+    put_u16(payload, grams);
+    return Protocol::Status::Ok;
+}
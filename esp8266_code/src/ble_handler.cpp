@@ -25,10 +25,17 @@
 #include "ble_handler.hpp"
 #include "ble_AT_quickies.hpp"
 #include "ble_constants.hpp"
+#include "ble_settings.hpp"
+#include "my_utils.hpp"
 
 BluetoothLE::BLEHandler::BLEHandler(uint32_t baud)
+#ifdef BLE_USE_HARDWARE_UART
+    : _baud(baud)
+#else
     : _serial(Pins::BLE_RXD_PIN, Pins::BLE_TXD_PIN), _baud(baud)
+#endif
 {
+    setBeaconUuidFilter(BLE_IBEACON_UUID);
 }
 
 void BluetoothLE::BLEHandler::init()
@@ -41,9 +48,10 @@ void BluetoothLE::BLEHandler::init()
 
 void BluetoothLE::BLEHandler::enable()
 {
-    _serial.begin(_baud);  // Initialize serial communication
+    _openSerial();  // Initialize serial communication
     digitalWrite(Pins::BLE_EN_PIN, HIGH);
     delay(Constants::POWER_UP_DELAY_MS);  // let the module power up and stabilize
+    _markAwake();  // A module that just powered up is awake
     MyUtils::ActiveComponents::Panel::enable(_ble_component);
     _flushSerial();
 }
@@ -60,16 +68,147 @@ void BluetoothLE::BLEHandler::changeBaudRate(uint32_t new_baud)
     _baud = new_baud;
     _serial.end();  // Close current serial connection
     delay(Constants::SERIAL_REINIT_DELAY_MS);      // Small delay for cleanup
-    _serial.begin(_baud);  // Reinitialize at new baud rate
+    _openSerial();  // Reinitialize at new baud rate
     delay(Constants::SERIAL_STABILIZE_DELAY_MS);      // Let it stabilize
     _flushSerial(); // Clear any garbage
 }
 
+uint32_t BluetoothLE::BLEHandler::getBaudRate() const
+{
+    return _baud;
+}
+
+// ==================== Baud Rate Negotiation ====================
+
+uint32_t BluetoothLE::BLEHandler::negotiateBaudRate(uint32_t max_baud)
+{
+    const uint32_t saved = Settings::load_baud_rate();
+    if (saved != 0 && saved != _baud) {
+        changeBaudRate(saved);
+    }
+    if (saved != 0 && _verifyLink()) {
+        DebugSerial << "[BLE] Using saved baud rate " << saved << ", full scan reply: " << estimateScanTransferMs(saved) << " ms" << endl;
+        return saved;
+    }
+
+    // Nothing saved, or the module was reset to another speed since
+    uint32_t current = (saved == 0 && _verifyLink()) ? _baud : _findBaudRate();
+    if (current == 0) {
+        DebugSerial << "[BLE] Module silent at every baud rate, staying at " << BLUETOOTH_BAUDRATE << endl;
+        changeBaudRate(BLUETOOTH_BAUDRATE);
+        return 0;
+    }
+    const uint32_t initial = current;
+
+    // Fastest first, so the first speed that holds is the one kept
+    for (uint8_t i = Constants::BAUD_RATE_COUNT; i-- > 0;) {
+        const uint32_t target = Constants::BAUD_RATES[i];
+        if (target <= current) {
+            break;
+        }
+        if (target > max_baud) {
+            continue;
+        }
+        DebugSerial << "[BLE] Trying " << target << " baud..." << endl;
+        if (_switchModuleBaud(i)) {
+            current = target;
+            break;
+        }
+        // Make sure both ends agree again before trying a slower speed
+        if (!_verifyLink()) {
+            current = _findBaudRate();
+            if (current == 0) {
+                DebugSerial << "[BLE] Lost the module while changing baud rate" << endl;
+                changeBaudRate(BLUETOOTH_BAUDRATE);
+                return 0;
+            }
+        }
+    }
+
+    if (!Settings::save_baud_rate(current)) {
+        DebugSerial << "[BLE] WARNING: could not save the baud rate, the next boot will probe again" << endl;
+    }
+    DebugSerial << "[BLE] Baud rate " << initial << " -> " << current
+        << ", full scan reply (" << MAX_BLE_DEVICES << " devices): " << estimateScanTransferMs(initial)
+        << " ms -> " << estimateScanTransferMs(current) << " ms" << endl;
+    return current;
+}
+
+uint32_t BluetoothLE::BLEHandler::estimateScanTransferMs(uint32_t baud, uint16_t devices)
+{
+    if (baud == 0) {
+        return 0;
+    }
+    // 8N1: 10 bits on the wire per byte
+    const uint64_t bits = static_cast<uint64_t>(devices) * Constants::DISCOVERY_LINE_BYTES * 10;
+    return static_cast<uint32_t>((bits * 1000 + baud - 1) / baud);
+}
+
 bool BluetoothLE::BLEHandler::isConnected() const
 {
-    const bool status = digitalRead(Pins::BLE_STATE_PIN) == HIGH;
-    MyUtils::ActiveComponents::Panel::activity(_ble_component, status);
-    return status;
+    return _connected;
+}
+
+/**
+ * @brief Refresh the cached connection state from the STATE line.
+ *
+ * BLE_STATE_PIN is the ADC input, the ble_monitor task reads it every
+ * BLE_STATE_SAMPLE_INTERVAL and the other callers get the cached state if
+ * the last read is less than BLE_STATE_SAMPLE_MIN_GAP old. The gap is
+ * shorter than the task period so scheduler jitter is not rate-limited.
+ * The reading goes through two thresholds, a level between them keeps the previous
+ * state so a slow or noisy edge does not toggle the link back and forth.
+ *
+ * @param now_ms Current millis()
+ * @return true A central is connected
+ */
+bool BluetoothLE::BLEHandler::sampleConnection(uint32_t now_ms)
+{
+    if (_state_sampled && now_ms - _state_sampled_ms < BLE_STATE_SAMPLE_MIN_GAP) {
+        _connection_stats.rate_limited++;
+        return _connected;
+    }
+    _state_sampled = true;
+    _state_sampled_ms = now_ms;
+    const uint16_t level = analogRead(Pins::BLE_STATE_PIN);
+    _connection_stats.samples++;
+    _connection_stats.last_level = level;
+
+    bool connected = _connected;
+    if (level >= Constants::STATE_CONNECTED_LEVEL) {
+        connected = true;
+    } else if (level <= Constants::STATE_DISCONNECTED_LEVEL) {
+        connected = false;
+    }
+    if (connected == _connected) {
+        return _connected;
+    }
+
+    _connected = connected;
+    _connection_stats.changes++;
+    if (connected) {
+        _markAwake();  // A central only connects to an awake module
+        DebugSerial << "[BLE] Device connected" << endl;
+        MyUtils::ActiveComponents::Panel::enable(_ble_component);
+    } else {
+        DebugSerial << "[BLE] Device disconnected" << endl;
+        MyUtils::ActiveComponents::Panel::disable(_ble_component);
+    }
+    if (_on_connection_change != nullptr) {
+        _on_connection_change(connected, _connection_context);
+    }
+    return _connected;
+}
+
+void BluetoothLE::BLEHandler::setConnectionCallback(ConnectionChangeCallback on_change, void *context)
+{
+    _on_connection_change = on_change;
+    _connection_context = context;
+}
+
+const BluetoothLE::ConnectionStateStats &BluetoothLE::BLEHandler::getConnectionStats() const
+{
+    return _connection_stats;
 }
 
 // ==================== Send/Receive Operations ====================
@@ -79,10 +218,7 @@ void BluetoothLE::BLEHandler::send(const char *data, size_t length)
 {
     MyUtils::ActiveComponents::Panel::activity(_ble_component, true);
     _serial.write(reinterpret_cast<const uint8_t *>(data), length);
-
-    // flash a dot to indicate sending
-    uint8_t size = (length > Constants::MAX_TRANSMISSION_SIZE) ? Constants::MAX_TRANSMISSION_SIZE : static_cast<uint8_t>(length);
-    MyUtils::ActiveComponents::Panel::data_transmission(_ble_component, size);
+    MyUtils::ActiveComponents::Panel::traffic(_ble_component, length);
     MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
 }
 
@@ -101,9 +237,9 @@ size_t BluetoothLE::BLEHandler::receive(char *buffer, size_t buffer_size)
     while (_serial.available() && bytes_read < buffer_size - 1) {  // Leave room for null terminator
         buffer[bytes_read] = _serial.read();
         bytes_read++;
-        MyUtils::ActiveComponents::Panel::data_transmission(_ble_component, 1);
     }
     buffer[bytes_read] = '\0';  // Null terminate
+    MyUtils::ActiveComponents::Panel::traffic(_ble_component, bytes_read);
 
     MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
     return bytes_read;
@@ -117,8 +253,8 @@ String BluetoothLE::BLEHandler::receive()
     while (_serial.available()) {
         char c = _serial.read();
         received += c;
-        MyUtils::ActiveComponents::Panel::data_transmission(_ble_component, 1);
     }
+    MyUtils::ActiveComponents::Panel::traffic(_ble_component, received.length());
     MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
     return received;
 }
@@ -129,16 +265,12 @@ String BluetoothLE::BLEHandler::receive()
 size_t BluetoothLE::BLEHandler::sendATCommand(const std::string_view &cmd, char *response_buffer, size_t buffer_size, uint32_t timeout_ms)
 {
     MyUtils::ActiveComponents::Panel::activity(_ble_component, true);
-    _flushSerial();
-
-    // Commands already include \r\n in constants
-    _serial.write(cmd.data(), cmd.size());
-    Serial << "[BLE] Sent: " << cmd << endl;
+    _writeCommand(cmd);
 
     size_t bytes_read = _readResponseToBuffer(response_buffer, buffer_size, timeout_ms);
 
     // Log response (safe to print - buffer is null-terminated)
-    Serial << "[BLE] Response: " << response_buffer << endl;
+    DebugSerial << "[BLE] Response: " << response_buffer << endl;
 
     MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
     return bytes_read;
@@ -148,14 +280,10 @@ size_t BluetoothLE::BLEHandler::sendATCommand(const std::string_view &cmd, char
 String BluetoothLE::BLEHandler::sendATCommand(const std::string_view &cmd, uint32_t timeout_ms)
 {
     MyUtils::ActiveComponents::Panel::activity(_ble_component, true);
-    _flushSerial();
-
-    // Commands already include \r\n in constants
-    _serial.write(cmd.data(), cmd.size());
-    Serial << "[BLE] Sent: " << cmd << endl;
+    _writeCommand(cmd);
 
     String response = _readResponse(timeout_ms);
-    Serial << "[BLE] Response: " << response << endl;
+    DebugSerial << "[BLE] Response: " << response << endl;
 
     MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
     return response;
@@ -185,52 +313,64 @@ BluetoothLE::ATCommandResult BluetoothLE::BLEHandler::testConnection()
 
 String BluetoothLE::BLEHandler::getModuleName()
 {
-    String response = sendATCommand(AT::Query::NAME, 1000);
-    // Response format: "OK+NAME:DeviceName"
-    int nameStart = response.indexOf(AT::Responses::Ok::NAME.data());
-    if (nameStart >= 0) {
-        nameStart += Constants::RESPONSE_PREFIX_NAME_LENGTH; // Skip "NAME:"
-        int nameEnd = response.indexOf('\r', nameStart);
-        if (nameEnd < 0) nameEnd = response.indexOf('\n', nameStart);
-        if (nameEnd < 0) nameEnd = response.length();
-        return response.substring(nameStart, nameEnd);
+    if (!_info.name_known) {
+        refreshModuleInfo();
     }
-    return "";
+    return String(_info.name);
 }
 
 String BluetoothLE::BLEHandler::getModuleAddress()
 {
-    String response = sendATCommand(AT::Query::ADDR, 1000);
-    // Response format: "OK+ADDR:001122334455"
-    int addrStart = response.indexOf(AT::Responses::Ok::ADDR.data());
-    if (addrStart >= 0) {
-        addrStart += Constants::RESPONSE_PREFIX_ADDR_LENGTH; // Skip "ADDR:"
-        int addrEnd = response.indexOf('\r', addrStart);
-        if (addrEnd < 0) addrEnd = response.indexOf('\n', addrStart);
-        if (addrEnd < 0) addrEnd = response.length();
-        return response.substring(addrStart, addrEnd);
+    if (!_info.address_known) {
+        refreshModuleInfo();
     }
-    return "";
+    return String(_info.address);
 }
 
 String BluetoothLE::BLEHandler::getVersion()
 {
-    String response = sendATCommand(AT::Query::VERSION, 1000);
-    // Response format: "OK+VERS:HMSoft V523"
-    int versStart = response.indexOf(AT::Responses::Ok::VERS.data());
-    if (versStart >= 0) {
-        versStart += Constants::RESPONSE_PREFIX_VERS_LENGTH;
-        int versEnd = response.indexOf('\r', versStart);
-        if (versEnd < 0) versEnd = response.indexOf('\n', versStart);
-        if (versEnd < 0) versEnd = response.length();
-        return response.substring(versStart, versEnd);
+    if (!_info.version_known) {
+        refreshModuleInfo();
     }
-    return "";
+    return String(_info.version);
+}
+
+/**
+ * @brief Read the identity of the module into the snapshot.
+ *
+ * Each query returns as soon as its value arrived instead of waiting out a
+ * fixed timeout, and the values land in fixed buffers. Status dumps read
+ * the snapshot, so only boot and reset() pay for these round-trips.
+ *
+ * @return true Name, address and version were all read
+ * @return false At least one query went unanswered, its field stays unknown
+ */
+bool BluetoothLE::BLEHandler::refreshModuleInfo()
+{
+    const unsigned long started = millis();
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, true);
+    _info.name_known = _queryValue(AT::Query::NAME, AT::Responses::Ok::NAME, _info.name, sizeof(_info.name));
+    _info.address_known = _queryValue(AT::Query::ADDR, AT::Responses::Ok::ADDR, _info.address, sizeof(_info.address));
+    _info.version_known = _queryValue(AT::Query::VERSION, AT::Responses::Ok::VERS, _info.version, sizeof(_info.version));
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
+    _info.refreshes++;
+    _info.refreshed_ms = millis();
+    _info.refresh_ms = _info.refreshed_ms - started;
+    DebugSerial << "[BLE] Module info refreshed in " << _info.refresh_ms << " ms" << endl;
+    return _info.name_known && _info.address_known && _info.version_known;
+}
+
+const BluetoothLE::ModuleInfo &BluetoothLE::BLEHandler::getModuleInfo() const
+{
+    return _info;
 }
 
 BluetoothLE::BLERole BluetoothLE::BLEHandler::getRole()
 {
+    const unsigned long started = millis();
     String response = sendATCommand(AT::Query::ROLE, 1000);
+    _role_churn.queries++;
+    _role_churn.churn_ms += millis() - started;
     // Response format varies: "OK+Get:0", "+Get:0", or may return ERROR
     // Check for Slave (Role 0)
     if (response.indexOf(AT::Responses::Ok::Role::SLAVE.data()) >= 0 ||
@@ -253,75 +393,300 @@ BluetoothLE::BLERole BluetoothLE::BLEHandler::getRole()
         return BLERole::Master;
     }
 
-    Serial << "[BLE] Unable to determine role from response: " << response << endl;
+    DebugSerial << "[BLE] Unable to determine role from response: " << response << endl;
     _current_role = BLERole::Unknown;
     return BLERole::Unknown;
 }
 
 bool BluetoothLE::BLEHandler::setRole(BLERole role)
 {
-    // Use compile-time constants to avoid string allocation
-    const std::string_view cmd = (role == BLERole::Master) ? AT::Set::ROLE_MASTER : AT::Set::ROLE_SLAVE;
-    String response = sendATCommand(cmd, 1000);
-
-    // Check for various success responses: "OK", "+ROLE=1", "+ROLE=0"
-    bool success = false;
-    if (role == BLERole::Master) {
-        success = (response.indexOf(AT::Responses::Ok::OK.data()) >= 0 ||
-            response.indexOf(AT::Responses::Ok::Role::SET_MASTER.data()) >= 0);
-    } else {
-        success = (response.indexOf(AT::Responses::Ok::OK.data()) >= 0 ||
-            response.indexOf(AT::Responses::Ok::Role::SET_SLAVE.data()) >= 0);
+    // The role survives power cycles, only talk to the module when it really changes
+    if (role == _current_role) {
+        _role_churn.cache_hits++;
+        return true;
     }
 
-    if (success) {
-        _current_role = role;
-        Serial << "[BLE] Role set to: " << ((role == BLERole::Master) ? "Master" : "Slave") << endl;
+    // Use compile-time constants to avoid string allocation
+    ATPipelineStep step;
+    step.command = (role == BLERole::Master) ? AT::Set::ROLE_MASTER : AT::Set::ROLE_SLAVE;
+    const unsigned long started = millis();
+    runPipeline(&step, 1);
 
-        // Some modules require reset after role change for discovery to work
-        Serial << "[BLE] Module may need reset for role change to take effect..." << endl;
-        Serial << "[BLE] Firmware version: " << getVersion() << endl;
+    if (step.ok) {
+        _current_role = role;
+        _role_churn.switches++;
+        DebugSerial << "[BLE] Role set to: " << ((role == BLERole::Master) ? "Master" : "Slave") << endl;
 
-        // Module may need reset after role change
+        // Module may need time after a role change for discovery to work
         delay(Constants::ROLE_CHANGE_DELAY_MS);
+        _role_churn.churn_ms += millis() - started;
         return true;
     }
 
-    Serial << "[BLE] Failed to set role. Response: " << response << endl;
+    _role_churn.churn_ms += millis() - started;
+    _current_role = BLERole::Unknown;  // The module state is no longer known for sure
+    DebugSerial << "[BLE] Failed to set role" << endl;
     return false;
 }
 
+BluetoothLE::BLERole BluetoothLE::BLEHandler::getCachedRole() const
+{
+    return _current_role;
+}
+
+uint8_t BluetoothLE::BLEHandler::runPipeline(ATPipelineStep *steps, uint8_t count)
+{
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, true);
+    uint8_t succeeded = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        ATPipelineStep &step = steps[i];
+        const unsigned long started = millis();
+        step.ok = false;
+        _writeCommand(step.command);
+
+        // Move on as soon as the reply is complete instead of waiting for trailing bytes
+        bool done = false;
+        while (!done) {
+            const ATEvent event = _nextEvent(step.timeout_ms);
+            if (event == ATEvent::None) {
+                break;
+            }
+            if (!step.expect.empty() && std::string_view(_parser.line(), _parser.length()).find(step.expect) != std::string_view::npos) {
+                step.ok = true;
+            }
+            if (event == ATEvent::Error) {
+                step.ok = false;
+                done = true;
+            } else if (ATResponseParser::is_terminal(event)) {
+                // "+ROLE=1" style values are followed by a separate "OK"
+                done = !(event == ATEvent::Value && _parser.line()[0] == '+');
+            }
+        }
+        step.elapsed_ms = millis() - started;
+        DebugSerial << "[BLE] Pipeline step " << (i + 1) << "/" << count << (step.ok ? " ok" : " failed") << " in " << step.elapsed_ms << " ms" << endl;
+        if (!step.ok) {
+            break;
+        }
+        succeeded++;
+    }
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
+    return succeeded;
+}
+
+const BluetoothLE::RoleChurnStats &BluetoothLE::BLEHandler::getRoleChurnStats() const
+{
+    return _role_churn;
+}
+
+uint32_t BluetoothLE::BLEHandler::getRoleChurnMsPerHour() const
+{
+    const uint32_t uptime_ms = millis();
+    if (uptime_ms == 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>((static_cast<uint64_t>(_role_churn.churn_ms) * 3600000ULL) / uptime_ms);
+}
+
+// ==================== Sleep Between Scan Windows ====================
+
+/**
+ * @brief Put the module to sleep until the next write.
+ *
+ * AT+SLEEP goes through the command queue, so the call never waits. The
+ * module keeps sleeping until _sendRaw() has something to send, which
+ * wakes it first, or until wake() is called ahead of the next scan window.
+ *
+ * @return true AT+SLEEP was queued (or the module already sleeps)
+ * @return false The module is busy, connected, or refused AT+SLEEP too often
+ */
+bool BluetoothLE::BLEHandler::sleep()
+{
+    if (_asleep || _sleep_queued) {
+        return true;
+    }
+    if (_connected || _scan_pending || isQueueBusy() || _sleep_refusals >= Constants::SLEEP_MAX_REFUSALS) {
+        return false;
+    }
+    _sleep_queued = enqueueCommand(AT::Action::SLEEP, _onSleepReply, this, Constants::SLEEP_REPLY_TIMEOUT_MS);
+    return _sleep_queued;
+}
+
+/**
+ * @brief Wake the module up and wait for it to answer.
+ *
+ * The module wakes on a string longer than 80 bytes and answers OK+WAKE.
+ * The time between the first byte and the answer is measured, the longest
+ * one becomes the lead getWakeLeadMs() asks for.
+ *
+ * @return true The module answered OK+WAKE, or was not asleep
+ * @return false No answer within Constants::WAKE_TIMEOUT_MS, the module is assumed awake anyway
+ */
+bool BluetoothLE::BLEHandler::wake()
+{
+    if (!_asleep) {
+        return true;
+    }
+    const unsigned long started = millis();
+    _markAwake();
+    _flushSerial();
+    uint8_t filler[Constants::WAKE_SEQUENCE_LENGTH];
+    memset(filler, Constants::WAKE_FILLER, sizeof(filler));
+    _serial.write(filler, sizeof(filler));
+    _sleep_stats.wakes++;
+
+    bool woken = false;
+    ATEvent event;
+    while ((event = _nextEvent(Constants::WAKE_TIMEOUT_MS)) != ATEvent::None) {
+        if (event == ATEvent::Value && strncmp(_parser.line(), AT::Responses::Ok::WAKE.data(), AT::Responses::Ok::WAKE.size()) == 0) {
+            woken = true;
+            break;
+        }
+    }
+    const uint32_t latency = millis() - started;
+    if (!woken) {
+        _sleep_stats.wake_timeouts++;
+        DebugSerial << "[BLE] No OK+WAKE after " << latency << " ms, assuming the module is awake" << endl;
+        return false;
+    }
+    _sleep_stats.last_wake_ms = latency;
+    if (latency > _sleep_stats.worst_wake_ms) {
+        _sleep_stats.worst_wake_ms = latency;
+    }
+    DebugSerial << "[BLE] Module awake in " << latency << " ms" << endl;
+    return true;
+}
+
+bool BluetoothLE::BLEHandler::isAsleep() const
+{
+    return _asleep;
+}
+
+uint32_t BluetoothLE::BLEHandler::getWakeLeadMs() const
+{
+    if (_sleep_stats.worst_wake_ms == 0) {
+        return Constants::WAKE_DEFAULT_LEAD_MS;
+    }
+    return _sleep_stats.worst_wake_ms;
+}
+
+const BluetoothLE::ModuleSleepStats &BluetoothLE::BLEHandler::getSleepStats() const
+{
+    return _sleep_stats;
+}
+
+uint32_t BluetoothLE::BLEHandler::getRadioOnMsPerHour() const
+{
+    const uint32_t uptime_ms = millis();
+    if (uptime_ms == 0) {
+        return 0;
+    }
+    uint32_t asleep_ms = _sleep_stats.asleep_ms;
+    if (_asleep) {
+        asleep_ms += uptime_ms - _asleep_since_ms;
+    }
+    const uint32_t awake_ms = asleep_ms < uptime_ms ? uptime_ms - asleep_ms : 0;
+    return static_cast<uint32_t>((static_cast<uint64_t>(awake_ms) * 3600000ULL) / uptime_ms);
+}
+
+// ==================== Asynchronous Command Queue ====================
+
+bool BluetoothLE::BLEHandler::enqueueCommand(const std::string_view &cmd, ATCompletionCallback on_done, void *context, uint32_t timeout_ms)
+{
+    if (_queue_count >= Constants::AT_QUEUE_SIZE || cmd.size() > Constants::QUEUED_COMMAND_SIZE) {
+        _queue_stats.rejected++;
+        DebugSerial << "[BLE] Command queue full or command too long, rejected: " << cmd << endl;
+        return false;
+    }
+    ATQueuedCommand &entry = _queue[(_queue_head + _queue_count) % Constants::AT_QUEUE_SIZE];
+    memcpy(entry.command, cmd.data(), cmd.size());
+    entry.length = static_cast<uint8_t>(cmd.size());
+    entry.scan = false;
+    entry.timeout_ms = timeout_ms;
+    entry.on_done = on_done;
+    entry.on_device = nullptr;
+    entry.context = context;
+    _queue_count++;
+    _queue_stats.enqueued++;
+    if (_queue_count > _queue_stats.max_depth) {
+        _queue_stats.max_depth = _queue_count;
+    }
+    return true;
+}
+
+bool BluetoothLE::BLEHandler::enqueueScan(uint32_t timeout_ms, DeviceFoundCallback on_device, ATCompletionCallback on_done, void *context)
+{
+    if (!enqueueCommand(AT::Action::DISCOVER, on_done, context, timeout_ms + 1000)) {
+        return false;
+    }
+    ATQueuedCommand &entry = _queue[(_queue_head + _queue_count - 1) % Constants::AT_QUEUE_SIZE];
+    entry.scan = true;
+    entry.on_device = on_device;
+    return true;
+}
+
+void BluetoothLE::BLEHandler::service()
+{
+    if (_job_phase == ATQueuePhase::Idle && _queue_count == 0) {
+        return;
+    }
+    const unsigned long started = micros();
+    if (_job_phase == ATQueuePhase::Idle) {
+        _startJob();
+    }
+    for (uint8_t i = 0; i < Constants::AT_SLICE_MAX_EVENTS && _job_phase != ATQueuePhase::Idle; ++i) {
+        if (!_stepJob()) {
+            break;
+        }
+    }
+    const uint32_t slice_us = micros() - started;
+    if (slice_us > _queue_stats.longest_slice_us) {
+        _queue_stats.longest_slice_us = slice_us;
+    }
+}
+
+bool BluetoothLE::BLEHandler::isQueueBusy() const
+{
+    return _queue_count > 0;
+}
+
+uint8_t BluetoothLE::BLEHandler::getQueueDepth() const
+{
+    return _queue_count;
+}
+
+const BluetoothLE::ATQueueStats &BluetoothLE::BLEHandler::getQueueStats() const
+{
+    return _queue_stats;
+}
+
 // ==================== Slave/Peripheral Mode Operations ====================
 
 // Set module name (buffer version)
 bool BluetoothLE::BLEHandler::setModuleName(const char *name)
 {
-    // Build command: AT+NAME<name>\r\n
-    size_t name_len = strlen(name);
-
-    if (name_len > BluetoothLE::Constants::MAX_NAME_LENGTH) {
-        Serial << "[BLE] Name too long (max " << Constants::MAX_NAME_LENGTH << " chars)" << endl;
-        return false;
+    // Rewriting the same name costs a flash write on the module for nothing
+    if (_info.name_known && strcmp(_info.name, name) == 0) {
+        return true;
     }
 
-    // Build command at runtime
     char cmd[Constants::COMMAND_NAME_LENGTH];  // "AT+NAME" + name + "\r\n" + null
-    snprintf(cmd, sizeof(cmd), "%.*s%s%.*s",
-        (int)AT::Set::NAME.length(), AT::Set::NAME.data(),
-        name,
-        (int)AT::NEWLINE.length(), AT::NEWLINE.data());
-
-    // Send command and get response
-    String response = sendATCommand(cmd, 1000);
+    if (!_buildNameCommand(name, cmd, sizeof(cmd))) {
+        return false;
+    }
 
-    // Check for success (OK or +NAME=<newname>)
-    if (response.indexOf(AT::Responses::Ok::OK.data()) >= 0 || response.indexOf("+NAME=") >= 0) {
-        Serial << "[BLE] Module name set to: " << name << endl;
+    // Success is either OK or +NAME=<newname> followed by OK
+    ATPipelineStep step;
+    step.command = cmd;
+    runPipeline(&step, 1);
+    if (step.ok) {
+        _cacheName(name, strlen(name));
+        DebugSerial << "[BLE] Module name set to: " << name << endl;
         delay(100);  // Let module update
         return true;
     }
 
-    Serial << "[BLE] Failed to set name. Response: " << response << endl;
+    _info.name_known = false;
+    DebugSerial << "[BLE] Failed to set name to: " << name << endl;
     return false;
 }
 
@@ -334,31 +699,61 @@ bool BluetoothLE::BLEHandler::setModuleName(const String &name)
 // Setup slave/peripheral mode
 bool BluetoothLE::BLEHandler::setupSlaveMode(const char *device_name)
 {
-    Serial << "[BLE] Configuring slave/peripheral mode..." << endl;
+    DebugSerial << "[BLE] Configuring slave/peripheral mode..." << endl;
 
-    // Set to slave mode (Role 0)
     if (_current_role == BLERole::Unknown) {
         getRole();
     }
 
+    // Set device name if provided, otherwise use BOARD_NAME from config
+    const char *name_to_set = device_name ? device_name : BOARD_NAME;
+
+    // Only the settings that differ from the cached module state are sent, in one
+    // batch, the role first since a failure there aborts the configuration
+    char name_cmd[Constants::COMMAND_NAME_LENGTH];
+    ATPipelineStep steps[2];
+    uint8_t count = 0;
+    int8_t role_step = -1;
+    int8_t name_step = -1;
     if (_current_role != BLERole::Slave) {
-        Serial << "[BLE] Setting slave mode..." << endl;
-        if (!setRole(BLERole::Slave)) {
-            Serial << "[BLE] Failed to set slave mode" << endl;
+        DebugSerial << "[BLE] Setting slave mode..." << endl;
+        role_step = count;
+        steps[count++].command = AT::Set::ROLE_SLAVE;
+    }
+    if (!(_info.name_known && strcmp(_info.name, name_to_set) == 0) && _buildNameCommand(name_to_set, name_cmd, sizeof(name_cmd))) {
+        name_step = count;
+        steps[count++].command = name_cmd;
+    }
+    runPipeline(steps, count);
+
+    if (role_step >= 0) {
+        if (!steps[role_step].ok) {
+            _current_role = BLERole::Unknown;
+            DebugSerial << "[BLE] Failed to set slave mode" << endl;
             return false;
         }
+        _current_role = BLERole::Slave;
+        _role_churn.switches++;
+        _role_churn.churn_ms += steps[role_step].elapsed_ms;
     }
-
-    // Set device name if provided, otherwise use BOARD_NAME from config
-    const char *name_to_set = device_name ? device_name : BOARD_NAME;
-    if (!setModuleName(name_to_set)) {
-        Serial << "[BLE] Warning: Failed to set device name" << endl;
-        // Not critical - continue anyway
+    if (name_step >= 0) {
+        if (steps[name_step].ok) {
+            _cacheName(name_to_set, strlen(name_to_set));
+        } else {
+            _info.name_known = false;
+            DebugSerial << "[BLE] Warning: Failed to set device name" << endl;
+            // Not critical - continue anyway
+        }
+    }
+    if (role_step >= 0) {
+        // One settle delay for the whole batch
+        delay(Constants::ROLE_CHANGE_DELAY_MS);
+        _role_churn.churn_ms += Constants::ROLE_CHANGE_DELAY_MS;
     }
 
-    Serial << "[BLE] Slave mode configured. Device is now discoverable." << endl;
-    Serial << "[BLE] Device name: " << name_to_set << endl;
-    Serial << "[BLE] Address: " << getModuleAddress() << endl;
+    DebugSerial << "[BLE] Slave mode configured. Device is now discoverable." << endl;
+    DebugSerial << "[BLE] Device name: " << name_to_set << endl;
+    DebugSerial << "[BLE] Address: " << (_info.address_known ? _info.address : "unknown") << endl;
 
     return true;
 }
@@ -366,20 +761,19 @@ bool BluetoothLE::BLEHandler::setupSlaveMode(const char *device_name)
 // Wait for incoming connection
 bool BluetoothLE::BLEHandler::waitForConnection(uint32_t timeout_ms)
 {
-    Serial << "[BLE] Waiting for connection..." << endl;
+    DebugSerial << "[BLE] Waiting for connection..." << endl;
     unsigned long start = millis();
 
     while (timeout_ms == 0 || (millis() - start < timeout_ms)) {
-        if (isConnected()) {
-            Serial << "[BLE] Connection established!" << endl;
-            _was_connected = true;
+        if (sampleConnection(millis())) {
+            DebugSerial << "[BLE] Connection established!" << endl;
             return true;
         }
         delay(100);  // Poll every 100ms
     }
 
     if (timeout_ms > 0) {
-        Serial << "[BLE] Connection timeout" << endl;
+        DebugSerial << "[BLE] Connection timeout" << endl;
     }
     return false;
 }
@@ -393,92 +787,102 @@ bool BluetoothLE::BLEHandler::hasIncomingData()
 // Monitor connection state changes
 void BluetoothLE::BLEHandler::monitorConnection()
 {
-    bool currently_connected = isConnected();
-
-    // Detect state change
-    if (currently_connected != _was_connected) {
-        if (currently_connected) {
-            Serial << "[BLE] Device connected" << endl;
-            MyUtils::ActiveComponents::Panel::enable(_ble_component);
-        } else {
-            Serial << "[BLE] Device disconnected" << endl;
-            MyUtils::ActiveComponents::Panel::disable(_ble_component);
-        }
-        _was_connected = currently_connected;
-    }
+    // The changes are logged and reported by sampleConnection() itself
+    sampleConnection(millis());
 }
 
 // ==================== Scanning Operations ====================
 
-bool BluetoothLE::BLEHandler::startScan(uint32_t timeout_ms)
+bool BluetoothLE::BLEHandler::startScan(uint32_t timeout_ms, DeviceFoundCallback on_device, void *context)
 {
+    // A scan stopped early, or a queued command, must be drained before the table is reused
+    _awaitJob();
+    if (_scan_pending) {
+        finishScan();
+    }
+
     // Ensure we're in master mode
     if (_current_role == BLERole::Unknown) {
         getRole(); // Query current role
     }
 
     if (_current_role != BLERole::Master) {
-        Serial << "[BLE] Not in Master mode. Switching..." << endl;
+        DebugSerial << "[BLE] Not in Master mode. Switching..." << endl;
         if (!setRole(BLERole::Master)) {
-            Serial << "[BLE] Failed to set Master mode!" << endl;
+            DebugSerial << "[BLE] Failed to set Master mode!" << endl;
             return false;
         }
     }
 
     clearScannedDevices();
-    Serial << "[BLE] Starting device discovery..." << endl;
-    Serial << "[BLE] Current role: " << (_current_role == BLERole::Master ? "Master" : (_current_role == BLERole::Slave ? "Slave" : "Unknown")) << endl;
+    DebugSerial << "[BLE] Starting device discovery..." << endl;
+    DebugSerial << "[BLE] Current role: " << (_current_role == BLERole::Master ? "Master" : (_current_role == BLERole::Slave ? "Slave" : "Unknown")) << endl;
 
-    String response = sendATCommand(AT::Action::DISCOVER, timeout_ms + 1000);
+    // Devices are parsed straight from the serial stream into _scanned_devices,
+    // one line at a time, instead of collecting the whole reply first.
+    // Line formats (vary by firmware):
+    // "OK+DISC:001122334455:-045" (address:rssi)
+    // or "OK+DISCS" followed by multiple "OK+DIS0:001122334455:DevName"
+    // or, for AT+DISI?, "OK+DISIS" followed by "OK+DISC:<factory>:<UUID>:<major><minor><tx>:<address>:<rssi>"
+    _scan_timeout_ms = timeout_ms + 1000;
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, true);
+    _writeCommand(_discoveryCommand());
+    ATEvent outcome = _ingestDiscovery(_scan_timeout_ms, on_device, context);
+
+    if ((outcome == ATEvent::Error || (outcome == ATEvent::None && _device_count == 0 && _overflow_count == 0)) && _refuseAdvertisementData()) {
+        _writeCommand(_discoveryCommand());
+        outcome = _ingestDiscovery(_scan_timeout_ms, on_device, context);
+    }
 
-    // If first command fails or returns ERROR, try alternative command format
-    if (response.length() == 0 || response.indexOf(AT::Responses::Error::ERROR.data()) >= 0) {
-        Serial << "[BLE] AT+DISC? failed. Trying AT+DISC..." << endl;
+    // If the first command fails or stays silent, try the alternative command format
+    if (outcome == ATEvent::Error || (outcome == ATEvent::None && _device_count == 0 && _overflow_count == 0)) {
+        DebugSerial << "[BLE] AT+DISC? failed. Trying AT+DISC..." << endl;
         delay(200);  // Small delay before retry
-        response = sendATCommand(AT::Action::DISCOVER_ALT, timeout_ms + 1000);
+        _writeCommand(AT::Action::DISCOVER_ALT);
+        outcome = _ingestDiscovery(_scan_timeout_ms, on_device, context);
 
         // If still failing, log and return
-        if (response.indexOf(AT::Responses::Error::ERROR.data()) >= 0) {
-            Serial << "[BLE] Discovery command not supported or module not ready." << endl;
-            Serial << "[BLE] This AT-09 firmware may not support device discovery." << endl;
-            Serial << "[BLE] Try resetting the module with: bleHandler.reset()" << endl;
+        if (outcome == ATEvent::Error) {
+            _current_role = BLERole::Unknown;  // Query the role again before the next attempt
+            MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
+            DebugSerial << "[BLE] Discovery command not supported or module not ready." << endl;
+            DebugSerial << "[BLE] This AT-09 firmware may not support device discovery." << endl;
+            DebugSerial << "[BLE] Try resetting the module with: bleHandler.reset()" << endl;
             return false;
         }
     }
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
 
-    // Parse response for discovered devices
-    // Response format (varies by firmware):
-    // "OK+DISC:001122334455:-045" (address:rssi)
-    // or "OK+DISCS" followed by multiple "OK+DIS0:001122334455:DevName"
-
-    unsigned int pos = 0;
-    while (pos < response.length()) {
-        int lineEnd = response.indexOf('\n', pos);
-        if (lineEnd < 0) lineEnd = response.length();
-
-        String line = response.substring(pos, lineEnd);
-        line.trim();
-
-        BLEDevice device = _parseDiscoveryLine(line);
-        if (device.valid) {
-            if (_device_count < MAX_BLE_DEVICES) {
-                _scanned_devices[_device_count] = device;
-                _device_count++;
-                Serial << "[BLE] Found device: " << device.address << " (" << device.name << ") RSSI: " << device.rssi << endl;
-            } else {
-                _overflow_count++;
-                Serial << "[BLE] Device buffer full! Lost device: " << device.address << endl;
-            }
-        }
+    if (_scan_pending) {
+        DebugSerial << "[BLE] Scan stopped early by the caller after " << _device_count << " device(s)" << endl;
+        return true;
+    }
+    DebugSerial << "[BLE] Scan complete. Found " << _device_count << " device(s)" << endl;
+    if (_overflow_count > 0) {
+        DebugSerial << "[BLE] WARNING: " << _overflow_count << " device(s) lost due to buffer overflow!" << endl;
+    }
+    return _device_count > 0;
+}
 
-        pos = lineEnd + 1;
+void BluetoothLE::BLEHandler::finishScan(DeviceFoundCallback on_device, void *context)
+{
+    if (!_scan_pending) {
+        return;
+    }
+    _ingestDiscovery(_scan_timeout_ms, on_device, context);
+    if (_scan_pending) {
+        return;  // Stopped again by the callback
     }
 
-    Serial << "[BLE] Scan complete. Found " << _device_count << " device(s)" << endl;
+    DebugSerial << "[BLE] Scan complete. Found " << _device_count << " device(s)" << endl;
     if (_overflow_count > 0) {
-        Serial << "[BLE] WARNING: " << _overflow_count << " device(s) lost due to buffer overflow!" << endl;
+        DebugSerial << "[BLE] WARNING: " << _overflow_count << " device(s) lost due to buffer overflow!" << endl;
     }
-    return _device_count > 0;
+}
+
+bool BluetoothLE::BLEHandler::isScanPending() const
+{
+    return _scan_pending;
 }
 
 const BluetoothLE::BLEDevice *BluetoothLE::BLEHandler::getScannedDevices() const
@@ -496,10 +900,76 @@ uint8_t BluetoothLE::BLEHandler::getOverflowCount() const
     return _overflow_count;
 }
 
+void BluetoothLE::BLEHandler::setKnownDeviceFilter(KnownDeviceFilter filter, void *context)
+{
+    _known_filter = filter;
+    _known_context = context;
+}
+
+const BluetoothLE::ScanRetentionStats &BluetoothLE::BLEHandler::getRetentionStats() const
+{
+    return _retention;
+}
+
+int8_t BluetoothLE::BLEHandler::getWeakestKeptRssi() const
+{
+    return (_heap_size == 0) ? -127 : _scanned_devices[_heap[0]].rssi;
+}
+
+const char *BluetoothLE::BLEHandler::getDeviceName(const BLEDevice &device) const
+{
+    return _names.get(device.name_id);
+}
+
+void BluetoothLE::BLEHandler::setDiscoveryMode(DiscoveryMode mode)
+{
+    _discovery_mode = mode;
+    _advertisement_refused = false;  // Give AT+DISI? another chance when asked for explicitly
+}
+
+BluetoothLE::DiscoveryMode BluetoothLE::BLEHandler::getDiscoveryMode() const
+{
+    return _advertisement_refused ? DiscoveryMode::Names : _discovery_mode;
+}
+
+bool BluetoothLE::BLEHandler::setBeaconUuidFilter(const char *uuid_hex)
+{
+    if (uuid_hex == nullptr || uuid_hex[0] == '\0') {
+        _uuid_filter_set = false;
+        return true;
+    }
+    uint8_t uuid[BeaconRecord::UUID_SIZE];
+    if (!BeaconRecord::parse_uuid(uuid_hex, strlen(uuid_hex), uuid)) {
+        return false;  // The previous filter stays
+    }
+    memcpy(_uuid_filter, uuid, sizeof(_uuid_filter));
+    _uuid_filter_set = true;
+    return true;
+}
+
+bool BluetoothLE::BLEHandler::getBeaconRecord(const BLEDevice &device, BeaconRecord &record) const
+{
+    const uint8_t *uuid = _uuids.get(device.uuid_id);
+    if (!device.valid || uuid == nullptr) {
+        return false;
+    }
+    record.address = device.address;
+    memcpy(record.uuid, uuid, BeaconRecord::UUID_SIZE);
+    record.major = device.major;
+    record.minor = device.minor;
+    record.tx_power = device.tx_power;
+    record.rssi = device.rssi;
+    record.ibeacon = true;
+    return true;
+}
+
 void BluetoothLE::BLEHandler::clearScannedDevices()
 {
     _device_count = 0;
     _overflow_count = 0;
+    _heap_size = 0;
+    _names.clear();
+    _uuids.clear();
     // Optionally clear the array data
     for (uint8_t i = 0; i < MAX_BLE_DEVICES; i++) {
         _scanned_devices[i].valid = false;
@@ -511,7 +981,7 @@ bool BluetoothLE::BLEHandler::connectToDevice(const char *address)
 {
     // Ensure we're in master mode
     if (_current_role != BLERole::Master) {
-        Serial << "[BLE] Must be in Master mode to connect" << endl;
+        DebugSerial << "[BLE] Must be in Master mode to connect" << endl;
         return false;
     }
 
@@ -526,11 +996,11 @@ bool BluetoothLE::BLEHandler::connectToDevice(const char *address)
     size_t len = sendATCommand(cmd_view, response, sizeof(response), 5000);
 
     if (len > 0 && strstr(response, AT::Responses::Ok::CONN.data()) != nullptr) {
-        Serial << "[BLE] Connected to: " << address << endl;
+        DebugSerial << "[BLE] Connected to: " << address << endl;
         return true;
     }
 
-    Serial << "[BLE] Connection failed to: " << address << endl;
+    DebugSerial << "[BLE] Connection failed to: " << address << endl;
     return false;
 }
 
@@ -544,7 +1014,7 @@ bool BluetoothLE::BLEHandler::disconnect()
 {
     String response = sendATCommand(AT::TEST, 1000);  // Sending AT will disconnect
     if (response.indexOf(AT::Responses::Ok::LOST.data()) >= 0) {
-        Serial << "[BLE] Disconnected" << endl;
+        DebugSerial << "[BLE] Disconnected" << endl;
         return true;
     }
     return false;
@@ -554,101 +1024,538 @@ bool BluetoothLE::BLEHandler::disconnect()
 
 void BluetoothLE::BLEHandler::reset()
 {
-    Serial << "[BLE] Resetting module..." << endl;
+    DebugSerial << "[BLE] Resetting module..." << endl;
     sendATCommand(AT::Action::RESET, 2000);
     delay(1000);  // Give module time to reset
     _current_role = BLERole::Unknown;
+    _advertisement_refused = false;  // The module may answer AT+DISI? once reset
     clearScannedDevices();
+    // Factory defaults: the name, and on some clones the address, are not the ones held anymore
+    refreshModuleInfo();
 }
 
 void BluetoothLE::BLEHandler::printStatus()
 {
-    BLERole role = getRole();
+    // Snapshot only, a status dump never talks to the module
+    const BLERole role = _current_role;
     bool connected = isConnected();
-    Serial << "========== BLE Module Status ==========" << endl;
-    Serial << "Module Name: " << getModuleName() << endl;
-    Serial << "Module Address: " << getModuleAddress() << endl;
-    Serial << "Version: " << getVersion() << endl;
-
-    Serial << "Role: ";
-    Serial << ((role == BLERole::Master) ? "Master" : (role == BLERole::Slave) ? "Slave" : "Unknown");
-    Serial << endl;
-    Serial << "Connected: " << (connected ? "Yes" : "No") << endl;
-    Serial << "Scanned Devices: " << _device_count << "/" << MAX_BLE_DEVICES << endl;
+    DebugSerial << "========== BLE Module Status ==========" << endl;
+    DebugSerial << "Module Name: " << (_info.name_known ? _info.name : "unknown") << endl;
+    DebugSerial << "Module Address: " << (_info.address_known ? _info.address : "unknown") << endl;
+    DebugSerial << "Version: " << (_info.version_known ? _info.version : "unknown") << endl;
+
+    DebugSerial << "Role: ";
+    DebugSerial << ((role == BLERole::Master) ? "Master" : (role == BLERole::Slave) ? "Slave" : "Unknown");
+    DebugSerial << endl;
+    DebugSerial << "Connected: " << (connected ? "Yes" : "No") << " (STATE level " << _connection_stats.last_level << ", " << _connection_stats.changes << " change(s))" << endl;
+    DebugSerial << "Sleep: " << (_asleep ? "asleep" : "awake") << ", " << _sleep_stats.sleeps << " sleep(s), wake-up " << _sleep_stats.last_wake_ms << " ms (worst " << _sleep_stats.worst_wake_ms << " ms), radio on " << getRadioOnMsPerHour() << " ms/h" << endl;
+    DebugSerial << "Role churn: " << _role_churn.switches << " switch(es), " << _role_churn.cache_hits << " avoided, " << getRoleChurnMsPerHour() << " ms/h" << endl;
+    DebugSerial << "Scanned Devices: " << _device_count << "/" << MAX_BLE_DEVICES << " (" << ((getDiscoveryMode() == DiscoveryMode::Advertisement) ? "AT+DISI?" : "AT+DISC?") << ")" << endl;
     if (_overflow_count > 0) {
-        Serial << "Lost Devices: " << _overflow_count << endl;
+        DebugSerial << "Lost Devices: " << _overflow_count << endl;
     }
-    Serial << "=======================================" << endl;
+    DebugSerial << "=======================================" << endl;
 }
 
 // ==================== Private Helper Methods ====================
 
+BluetoothLE::ATEvent BluetoothLE::BLEHandler::_pollEvent()
+{
+    while (_serial.available()) {
+        const ATEvent event = _parser.feed(static_cast<uint8_t>(_serial.read()));
+        _last_rx_ms = millis(); // Reset timeout on receiving data
+        if (event != ATEvent::None) {
+            return event;
+        }
+    }
+    // Some firmwares do not terminate their last token, a quiet line completes it
+    if (_parser.pending() && millis() - _last_rx_ms >= Constants::RESPONSE_IDLE_FLUSH_MS) {
+        return _parser.flush();
+    }
+    return ATEvent::None;
+}
+
+BluetoothLE::ATEvent BluetoothLE::BLEHandler::_nextEvent(uint32_t idle_timeout_ms)
+{
+    _last_rx_ms = millis();
+
+    while (true) {
+        const ATEvent event = _pollEvent();
+        if (event != ATEvent::None) {
+            return event;
+        }
+        if (millis() - _last_rx_ms >= idle_timeout_ms) {
+            return ATEvent::None;
+        }
+
+        delay(Constants::RESPONSE_POLL_DELAY_MS);
+    }
+}
+
+void BluetoothLE::BLEHandler::_writeCommand(const std::string_view &cmd)
+{
+    // The module only listens again once its discovery window is over
+    _awaitJob();
+    if (_scan_pending) {
+        finishScan();
+    }
+    _sendRaw(cmd);
+}
+
+void BluetoothLE::BLEHandler::_sendRaw(const std::string_view &cmd)
+{
+    // A sleeping module would swallow the command as part of its wake-up string
+    wake();
+    _flushSerial();
+
+    // Commands already include \r\n in constants
+    _serial.write(cmd.data(), cmd.size());
+    _last_rx_ms = millis();
+    DebugSerial << "[BLE] Sent: " << cmd << endl;
+}
+
+void BluetoothLE::BLEHandler::_startJob()
+{
+    const ATQueuedCommand &job = _queue[_queue_head];
+    _job_length = 0;
+    _job_response[0] = '\0';
+    _job_alt_tried = false;
+    _job_since_ms = millis();
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, true);
+    if (_scan_pending) {
+        finishScan();  // A synchronous scan stopped early still owns the module
+    }
+    if (!job.scan) {
+        _sendRaw(std::string_view(job.command, job.length));
+        _job_phase = ATQueuePhase::Reply;
+        return;
+    }
+    if (_current_role == BLERole::Master) {
+        _role_churn.cache_hits++;
+        _startJobDiscovery(_discoveryCommand());
+        return;
+    }
+    // Switching to master is harmless when the module already is one, no need to ask first
+    _sendRaw(AT::Set::ROLE_MASTER);
+    _job_phase = ATQueuePhase::Reply;
+}
+
+bool BluetoothLE::BLEHandler::_stepJob()
+{
+    const ATQueuedCommand &job = _queue[_queue_head];
+    if (_job_phase == ATQueuePhase::Settle) {
+        if (millis() - _job_since_ms < Constants::ROLE_CHANGE_DELAY_MS) {
+            return false;
+        }
+        _startJobDiscovery(_discoveryCommand());
+        return true;
+    }
+
+    const ATEvent event = _pollEvent();
+    if (event != ATEvent::None) {
+        _onJobEvent(event);
+        return true;
+    }
+    const uint32_t timeout_ms = (job.scan && _job_phase == ATQueuePhase::Reply) ? Constants::ROLE_REPLY_TIMEOUT_MS : job.timeout_ms;
+    if (millis() - _last_rx_ms < timeout_ms) {
+        return false;
+    }
+    _onJobSilence();
+    return true;
+}
+
+void BluetoothLE::BLEHandler::_onJobEvent(ATEvent event)
+{
+    const ATQueuedCommand &job = _queue[_queue_head];
+    if (_job_phase == ATQueuePhase::Discovery) {
+        if (event == ATEvent::Device) {
+            const BLEDevice *device = _commitDevice(_parser.line(), _parser.length());
+            if (device != nullptr && job.on_device != nullptr) {
+                job.on_device(*device, job.context);
+            }
+        } else if (event == ATEvent::Error) {
+            if (_refuseAdvertisementData()) {
+                _startJobDiscovery(_discoveryCommand());
+                return;
+            }
+            if (!_job_alt_tried) {
+                DebugSerial << "[BLE] AT+DISC? failed. Trying AT+DISC..." << endl;
+                _job_alt_tried = true;
+                _startJobDiscovery(AT::Action::DISCOVER_ALT);
+                return;
+            }
+            _current_role = BLERole::Unknown;  // Query the role again before the next attempt
+            _finishJob(ATCommandResult::ERROR);
+        } else if (event == ATEvent::DiscoveryEnd || event == ATEvent::Ok) {
+            _finishJob(ATCommandResult::OK);
+        }
+        return;
+    }
+
+    // Keep the reply tokens for the callback, truncating once the buffer is full
+    const size_t token_length = _parser.length();
+    for (size_t i = 0; i < token_length + AT::NEWLINE.size() && _job_length < sizeof(_job_response) - 1; ++i) {
+        _job_response[_job_length++] = (i < token_length) ? _parser.line()[i] : AT::NEWLINE[i - token_length];
+    }
+    _job_response[_job_length] = '\0';
+
+    if (event == ATEvent::Error) {
+        if (job.scan) {
+            _current_role = BLERole::Unknown;
+        }
+        _finishJob(ATCommandResult::ERROR);
+        return;
+    }
+    // "+ROLE=1" style values are followed by a separate "OK"
+    if (!ATResponseParser::is_terminal(event) || (event == ATEvent::Value && _parser.line()[0] == '+')) {
+        return;
+    }
+    if (!job.scan) {
+        _finishJob(ATCommandResult::OK);
+        return;
+    }
+    // Role switched, the module needs a moment before discovery works
+    _current_role = BLERole::Master;
+    _role_churn.switches++;
+    _role_churn.churn_ms += Constants::ROLE_CHANGE_DELAY_MS;
+    _job_length = 0;
+    _job_response[0] = '\0';
+    _job_phase = ATQueuePhase::Settle;
+    _job_since_ms = millis();
+}
+
+void BluetoothLE::BLEHandler::_onJobSilence()
+{
+    if (_job_phase == ATQueuePhase::Discovery) {
+        if (_device_count == 0 && _overflow_count == 0 && _refuseAdvertisementData()) {
+            _startJobDiscovery(_discoveryCommand());
+            return;
+        }
+        if (!_job_alt_tried && _device_count == 0 && _overflow_count == 0) {
+            DebugSerial << "[BLE] AT+DISC? stayed silent. Trying AT+DISC..." << endl;
+            _job_alt_tried = true;
+            _startJobDiscovery(AT::Action::DISCOVER_ALT);
+            return;
+        }
+        _finishJob(ATCommandResult::OK);
+        return;
+    }
+    if (_queue[_queue_head].scan) {
+        _current_role = BLERole::Unknown;
+    }
+    _finishJob(_job_length == 0 ? ATCommandResult::TIMEOUT : ATCommandResult::UNKNOWN);
+}
+
+void BluetoothLE::BLEHandler::_startJobDiscovery(const std::string_view &cmd)
+{
+    clearScannedDevices();
+    if (!_job_alt_tried) {
+        DebugSerial << "[BLE] Starting queued device discovery..." << endl;
+    }
+    _sendRaw(cmd);
+    _job_phase = ATQueuePhase::Discovery;
+    _job_since_ms = millis();
+}
+
+std::string_view BluetoothLE::BLEHandler::_discoveryCommand() const
+{
+    return (getDiscoveryMode() == DiscoveryMode::Advertisement) ? AT::Action::DISCOVER_IBEACON : AT::Action::DISCOVER;
+}
+
+bool BluetoothLE::BLEHandler::_refuseAdvertisementData()
+{
+    if (getDiscoveryMode() != DiscoveryMode::Advertisement) {
+        return false;
+    }
+    // Older and CC41 firmwares do not know AT+DISI?, asking again every window would only waste it
+    _advertisement_refused = true;
+    DebugSerial << "[BLE] AT+DISI? not supported. Falling back to AT+DISC?..." << endl;
+    return true;
+}
+
+void BluetoothLE::BLEHandler::_finishJob(ATCommandResult result)
+{
+    // Release the slot first so the callback can queue the next command
+    const ATQueuedCommand job = _queue[_queue_head];
+    _queue_head = (_queue_head + 1) % Constants::AT_QUEUE_SIZE;
+    _queue_count--;
+    _job_phase = ATQueuePhase::Idle;
+    _queue_stats.completed++;
+    if (result == ATCommandResult::TIMEOUT) {
+        _queue_stats.timeouts++;
+    } else if (result == ATCommandResult::ERROR) {
+        _queue_stats.errors++;
+    }
+    MyUtils::ActiveComponents::Panel::activity(_ble_component, false);
+
+    if (job.scan) {
+        DebugSerial << "[BLE] Queued scan complete. Found " << _device_count << " device(s)" << endl;
+        if (_overflow_count > 0) {
+            DebugSerial << "[BLE] WARNING: " << _overflow_count << " device(s) lost due to buffer overflow!" << endl;
+        }
+    } else {
+        DebugSerial << "[BLE] Response: " << _job_response << endl;
+    }
+    if (job.on_done != nullptr) {
+        job.on_done(result, _job_response, _job_length, job.context);
+    }
+}
+
+void BluetoothLE::BLEHandler::_awaitJob()
+{
+    while (_job_phase != ATQueuePhase::Idle) {
+        if (!_stepJob()) {
+            delay(Constants::RESPONSE_POLL_DELAY_MS);
+        }
+    }
+}
+
+bool BluetoothLE::BLEHandler::_buildNameCommand(const char *name, char *cmd, size_t cmd_size)
+{
+    // Build command: AT+NAME<name>\r\n
+    if (strlen(name) > Constants::MAX_NAME_LENGTH) {
+        DebugSerial << "[BLE] Name too long (max " << Constants::MAX_NAME_LENGTH << " chars)" << endl;
+        return false;
+    }
+    snprintf(cmd, cmd_size, "%.*s%s%.*s",
+        (int)AT::Set::NAME.length(), AT::Set::NAME.data(),
+        name,
+        (int)AT::NEWLINE.length(), AT::NEWLINE.data());
+    return true;
+}
+
+bool BluetoothLE::BLEHandler::_queryValue(const std::string_view &cmd, const std::string_view &prefix, char *value, size_t value_size)
+{
+    _writeCommand(cmd);
+    ATEvent event;
+    // Stray tokens (a late "OK" of the previous command) are skipped until the value shows up
+    while ((event = _nextEvent(Constants::ROLE_REPLY_TIMEOUT_MS)) != ATEvent::None && event != ATEvent::Error) {
+        const std::string_view line(_parser.line(), _parser.length());
+        if (line.size() >= prefix.size() && line.compare(0, prefix.size(), prefix) == 0) {
+            const size_t length = line.size() - prefix.size();
+            const size_t kept = length < value_size - 1 ? length : value_size - 1;
+            memcpy(value, line.data() + prefix.size(), kept);
+            value[kept] = '\0';
+            return true;
+        }
+    }
+    value[0] = '\0';
+    return false;
+}
+
+void BluetoothLE::BLEHandler::_cacheName(const char *name, size_t length)
+{
+    if (length > Constants::MAX_NAME_LENGTH) {
+        _info.name_known = false;
+        return;
+    }
+    memcpy(_info.name, name, length);
+    _info.name[length] = '\0';
+    _info.name_known = true;
+}
+
+BluetoothLE::ATEvent BluetoothLE::BLEHandler::_ingestDiscovery(uint32_t idle_timeout_ms, DeviceFoundCallback on_device, void *context)
+{
+    ATEvent event = _nextEvent(idle_timeout_ms);
+    while (event != ATEvent::None) {
+        if (event == ATEvent::Error || event == ATEvent::DiscoveryEnd || event == ATEvent::Ok) {
+            _scan_pending = false;
+            return event;
+        }
+        if (event == ATEvent::Device) {
+            const BLEDevice *device = _commitDevice(_parser.line(), _parser.length());
+            if (device != nullptr && on_device != nullptr && on_device(*device, context)) {
+                _scan_pending = true;
+                return event;
+            }
+        }
+        event = _nextEvent(idle_timeout_ms);
+    }
+    _scan_pending = false;
+    return ATEvent::None;
+}
+
+const BluetoothLE::BLEDevice *BluetoothLE::BLEHandler::_commitDevice(const char *line, size_t length)
+{
+    // AT+DISI? lines are decoded once, the identity filter needs the UUID before a slot is taken
+    BeaconRecord record;
+    const bool advertisement = BeaconRecord::is_advertisement_line(line, length);
+    if (advertisement) {
+        if (!record.parse(line, length)) {
+            return nullptr;
+        }
+        if (_uuid_filter_set && !record.matches(_uuid_filter)) {
+            _retention.identity_filtered++;
+            return nullptr;
+        }
+    }
+    const BeaconRecord *parsed = advertisement ? &record : nullptr;
+
+    if (_device_count < MAX_BLE_DEVICES) {
+        // Parse in place, the slot only becomes visible once the count moves
+        BLEDevice &slot = _scanned_devices[_device_count];
+        if (!_fillDevice(parsed, line, length, slot)) {
+            return nullptr;
+        }
+        const uint8_t index = _device_count++;
+        if (_isKnown(slot.address)) {
+            _retention.known_kept++;
+        } else {
+            _heap[_heap_size] = index;
+            _heapSiftUp(_heap_size++);
+        }
+        MyUtils::ActiveComponents::Panel::traffic(_ble_component, length);
+        if (slot.uuid_id != BLEDevice::NO_UUID) {
+            DebugSerial << "[BLE] Found beacon: " << slot.address << " (" << slot.major << "/" << slot.minor << ") RSSI: " << slot.rssi << " ~" << BeaconRecord::estimate_distance_cm(slot.rssi, slot.tx_power) << " cm" << endl;
+        } else {
+            DebugSerial << "[BLE] Found device: " << slot.address << " (" << _names.get(slot.name_id) << ") RSSI: " << slot.rssi << endl;
+        }
+        return &slot;
+    }
+
+    // Table full: a newcomer only gets in by replacing the weakest evictable device
+    BLEDevice candidate;
+    if (!_fillDevice(parsed, line, length, candidate, false)) {
+        return nullptr;
+    }
+    _overflow_count++;
+    const bool known = _isKnown(candidate.address);
+    if (_heap_size == 0 || (!known && candidate.rssi <= _scanned_devices[_heap[0]].rssi)) {
+        if (known) {
+            _retention.known_dropped++;
+        } else {
+            _retention.rejected++;
+        }
+        DebugSerial << "[BLE] Device buffer full! Lost device: " << candidate.address << " RSSI: " << candidate.rssi << endl;
+        return nullptr;
+    }
+
+    const uint8_t victim = _heap[0];
+    BLEDevice &slot = _scanned_devices[victim];
+    DebugSerial << "[BLE] Device buffer full! Evicted " << slot.address << " (" << slot.rssi << ") for " << candidate.address << " (" << candidate.rssi << ")" << endl;
+    // Parse again, with the name or UUID this time, the evicted ones stay in their pool until the next scan
+    if (!_fillDevice(parsed, line, length, slot)) {
+        return nullptr;
+    }
+    _retention.evicted++;
+    if (known) {
+        // Out of the heap for good: the last leaf takes the root
+        _retention.known_kept++;
+        _heap[0] = _heap[--_heap_size];
+    }
+    _heapSiftDown(0);
+    MyUtils::ActiveComponents::Panel::traffic(_ble_component, length);
+    return &slot;
+}
+
+bool BluetoothLE::BLEHandler::_fillDevice(const BeaconRecord *record, const char *line, size_t length, BLEDevice &device, bool keep_name)
+{
+    if (record == nullptr) {
+        return _parseDiscoveryLine(line, length, device, keep_name);
+    }
+    device.address = record->address;
+    device.rssi = record->rssi;
+    device.name_id = BLEDevice::NO_NAME;  // AT+DISI? never resolves names
+    device.uuid_id = (keep_name && record->ibeacon) ? _uuids.intern(record->uuid) : BLEDevice::NO_UUID;
+    device.major = record->major;
+    device.minor = record->minor;
+    device.tx_power = record->tx_power;
+    device.valid = true;
+    return true;
+}
+
+bool BluetoothLE::BLEHandler::_isKnown(const MacAddress &address) const
+{
+    return _known_filter != nullptr && _known_filter(address, _known_context);
+}
+
+void BluetoothLE::BLEHandler::_heapSiftUp(uint8_t position)
+{
+    while (position > 0) {
+        const uint8_t parent = (position - 1) / 2;
+        if (_scanned_devices[_heap[parent]].rssi <= _scanned_devices[_heap[position]].rssi) {
+            return;
+        }
+        MyUtils::swap(_heap[parent], _heap[position]);
+        position = parent;
+    }
+}
+
+void BluetoothLE::BLEHandler::_heapSiftDown(uint8_t position)
+{
+    while (true) {
+        const uint8_t left = 2 * position + 1;
+        if (left >= _heap_size) {
+            return;
+        }
+        const uint8_t right = left + 1;
+        uint8_t weakest = left;
+        if (right < _heap_size && _scanned_devices[_heap[right]].rssi < _scanned_devices[_heap[left]].rssi) {
+            weakest = right;
+        }
+        if (_scanned_devices[_heap[position]].rssi <= _scanned_devices[_heap[weakest]].rssi) {
+            return;
+        }
+        MyUtils::swap(_heap[position], _heap[weakest]);
+        position = weakest;
+    }
+}
+
 // Buffer-based response reader (no heap allocation - hot path)
 size_t BluetoothLE::BLEHandler::_readResponseToBuffer(char *buffer, size_t buffer_size, uint32_t timeout_ms)
 {
     size_t pos = 0;
-    unsigned long start = millis();
+    uint32_t wait_ms = timeout_ms;
     buffer[0] = '\0';  // Initialize as empty string
 
-    while (millis() - start < timeout_ms && pos < buffer_size - 1) {
-        while (_serial.available() && pos < buffer_size - 1) {
-            char c = _serial.read();
-            buffer[pos++] = c;
-            start = millis(); // Reset timeout on receiving data
+    ATEvent event = _nextEvent(wait_ms);
+    while (event != ATEvent::None) {
+        // Store the token followed by a line break, truncating once the buffer is full
+        const size_t token_length = _parser.length();
+        for (size_t i = 0; i < token_length + AT::NEWLINE.size() && pos < buffer_size - 1; ++i) {
+            buffer[pos++] = (i < token_length) ? _parser.line()[i] : AT::NEWLINE[i - token_length];
         }
         buffer[pos] = '\0';  // Always null-terminate
 
-        // Check if we got a complete response
-        if (strstr(buffer, AT::Responses::Ok::OK.data()) != nullptr || strstr(buffer, AT::Responses::Error::ERROR.data()) != nullptr) {
-            delay(Constants::RESPONSE_TRAILING_DELAY_MS); // Small delay to catch any trailing characters
-            while (_serial.available() && pos < buffer_size - 1) {
-                buffer[pos++] = _serial.read();
-            }
-            buffer[pos] = '\0';
-            break;
+        if (ATResponseParser::is_terminal(event)) {
+            // Answer complete, only wait a little for trailing tokens (e.g. "+ROLE=1" followed by "OK")
+            wait_ms = Constants::RESPONSE_TRAILING_DELAY_MS;
         }
-
-        delay(Constants::RESPONSE_POLL_DELAY_MS);
+        event = _nextEvent(wait_ms);
     }
 
     return pos;
 }
 
-// String-based response reader (allocates - for convenience/diagnostics)
+// String-based response reader (for convenience/diagnostics, one append per token)
 String BluetoothLE::BLEHandler::_readResponse(uint32_t timeout_ms)
 {
     String response = "";
-    unsigned long start = millis();
+    uint32_t wait_ms = timeout_ms;
 
-    while (millis() - start < timeout_ms) {
-        while (_serial.available()) {
-            char c = _serial.read();
-            response += c;
-            start = millis(); // Reset timeout on receiving data
-        }
+    ATEvent event = _nextEvent(wait_ms);
+    while (event != ATEvent::None) {
+        response.concat(_parser.line(), _parser.length());
+        response.concat(AT::NEWLINE.data(), AT::NEWLINE.size());
 
-        // Check if we got a complete response
-        if (response.indexOf(AT::Responses::Ok::OK.data()) >= 0 || response.indexOf(AT::Responses::Error::ERROR.data()) >= 0) {
-            delay(Constants::RESPONSE_TRAILING_DELAY_MS); // Small delay to catch any trailing characters
-            while (_serial.available()) {
-                response += (char)_serial.read();
-            }
-            break;
+        if (ATResponseParser::is_terminal(event)) {
+            wait_ms = Constants::RESPONSE_TRAILING_DELAY_MS;
         }
-
-        delay(Constants::RESPONSE_POLL_DELAY_MS);
+        event = _nextEvent(wait_ms);
     }
 
     return response;
 }
 
-// Buffer-based discovery line parser (no heap allocation)
-BluetoothLE::BLEDevice BluetoothLE::BLEHandler::_parseDiscoveryLine(const char *line, size_t length)
+// Buffer-based discovery line parser (no heap allocation, writes straight into the target slot)
+bool BluetoothLE::BLEHandler::_parseDiscoveryLine(const char *line, size_t length, BLEDevice &device, bool keep_name)
 {
-    BLEDevice device;
     device.valid = false;
-    device.address[0] = '\0';
-    device.name[0] = '\0';
+    device.name_id = BLEDevice::NO_NAME;
+    device.uuid_id = BLEDevice::NO_UUID;
+    device.major = 0;
+    device.minor = 0;
+    device.tx_power = 0;
     device.rssi = 0;
 
     // Try different response formats:
@@ -658,89 +1565,139 @@ BluetoothLE::BLEDevice BluetoothLE::BLEHandler::_parseDiscoveryLine(const char *
 
     const char *disc_marker = strstr(line, AT::Responses::Ok::DISC.data());
     const char *dis_marker = (disc_marker == nullptr) ? strstr(line, AT::Responses::Ok::DIS.data()) : disc_marker;
+    if (dis_marker == nullptr) {
+        return false;
+    }
 
-    if (dis_marker != nullptr) {
-        const char *firstColon = strchr(dis_marker, ':');
-        if (firstColon == nullptr) return device;
-
-        const char *secondColon = strchr(firstColon + 1, ':');
-        const char *thirdColon = (secondColon != nullptr) ? strchr(secondColon + 1, ':') : nullptr;
-
-        // Extract address (12 hex digits)
-        const char *addr_start = firstColon + 1;
-        const char *addr_end = (secondColon != nullptr) ? secondColon : (line + length);
-        size_t addr_len = addr_end - addr_start;
-
-        // Validate address format (12 hex characters)
-        if (addr_len >= Constants::BLE_ADDRESS_LENGTH) {
-            // Copy address (max 12 chars)
-            size_t copy_len = (addr_len > Constants::BLE_ADDRESS_LENGTH) ? Constants::BLE_ADDRESS_LENGTH : addr_len;
-            strncpy(device.address, addr_start, copy_len);
-            device.address[copy_len] = '\0';
-            device.valid = true;
-
-            // Extract name if present
-            if (secondColon != nullptr && thirdColon != nullptr) {
-                const char *name_start = secondColon + 1;
-                const char *name_end = thirdColon;
-                size_t name_len = name_end - name_start;
-
-                if (name_len > 0 && name_len < sizeof(device.name)) {
-                    // Trim leading/trailing whitespace
-                    while (name_len > 0 && (*name_start == ' ' || *name_start == '\r' || *name_start == '\n')) {
-                        name_start++;
-                        name_len--;
-                    }
-                    while (name_len > 0 && (name_start[name_len - 1] == ' ' || name_start[name_len - 1] == '\r' || name_start[name_len - 1] == '\n')) {
-                        name_len--;
-                    }
-
-                    if (name_len > 0) {
-                        strncpy(device.name, name_start, name_len);
-                        device.name[name_len] = '\0';
-                    }
-                }
-
-                // Extract RSSI if present
-                const char *rssi_start = thirdColon + 1;
-                device.rssi = atoi(rssi_start);
-            } else if (secondColon != nullptr) {
-                // Could be either name or RSSI
-                const char *last_start = secondColon + 1;
-
-                // Skip whitespace
-                while (*last_start == ' ' || *last_start == '\r' || *last_start == '\n') {
-                    last_start++;
-                }
-
-                if (*last_start == '-' || *last_start == '+' || (*last_start >= '0' && *last_start <= '9')) {
-                    // It's RSSI
-                    device.rssi = atoi(last_start);
-                } else {
-                    // It's a name
-                    size_t name_len = (line + length) - last_start;
-                    if (name_len > 0 && name_len < sizeof(device.name)) {
-                        // Trim trailing whitespace
-                        while (name_len > 0 && (last_start[name_len - 1] == ' ' || last_start[name_len - 1] == '\r' || last_start[name_len - 1] == '\n')) {
-                            name_len--;
-                        }
-                        if (name_len > 0) {
-                            strncpy(device.name, last_start, name_len);
-                            device.name[name_len] = '\0';
-                        }
-                    }
-                }
-            }
+    const char *firstColon = strchr(dis_marker, ':');
+    if (firstColon == nullptr) return false;
+
+    const char *secondColon = strchr(firstColon + 1, ':');
+    const char *thirdColon = (secondColon != nullptr) ? strchr(secondColon + 1, ':') : nullptr;
+
+    // Extract address (12 hex digits), stored as 6 raw bytes
+    const char *addr_start = firstColon + 1;
+    const char *addr_end = (secondColon != nullptr) ? secondColon : (line + length);
+    if (!device.address.parse(addr_start, addr_end - addr_start)) {
+        return false;
+    }
+    device.valid = true;
+
+    const char *name_start = nullptr;
+    size_t name_len = 0;
+    if (secondColon != nullptr && thirdColon != nullptr) {
+        // Name then RSSI
+        name_start = secondColon + 1;
+        name_len = thirdColon - name_start;
+        device.rssi = atoi(thirdColon + 1);
+    } else if (secondColon != nullptr) {
+        // Could be either name or RSSI
+        const char *last_start = secondColon + 1;
+
+        // Skip whitespace
+        while (*last_start == ' ' || *last_start == '\r' || *last_start == '\n') {
+            last_start++;
+        }
+
+        if (*last_start == '-' || *last_start == '+' || (*last_start >= '0' && *last_start <= '9')) {
+            // It's RSSI
+            device.rssi = atoi(last_start);
+        } else {
+            // It's a name
+            name_start = last_start;
+            name_len = (line + length) - last_start;
+        }
+    }
+
+    if (keep_name && name_start != nullptr) {
+        // Trim leading/trailing whitespace
+        while (name_len > 0 && (*name_start == ' ' || *name_start == '\r' || *name_start == '\n')) {
+            name_start++;
+            name_len--;
         }
+        while (name_len > 0 && (name_start[name_len - 1] == ' ' || name_start[name_len - 1] == '\r' || name_start[name_len - 1] == '\n')) {
+            name_len--;
+        }
+        device.name_id = _names.intern(name_start, name_len);
     }
 
-    return device;
+    return true;
 }
 
-// String-based discovery line parser (for backwards compatibility)
-BluetoothLE::BLEDevice BluetoothLE::BLEHandler::_parseDiscoveryLine(const String &line)
+void BluetoothLE::BLEHandler::_openSerial()
 {
-    return _parseDiscoveryLine(line.c_str(), line.length());
+    _serial.begin(_baud);
+#ifdef BLE_USE_HARDWARE_UART
+    // begin() puts UART0 back on GPIO1/3, where the boot ROM and the flasher talk
+    _serial.swap();
+#endif
+}
+
+bool BluetoothLE::BLEHandler::_verifyLink()
+{
+    for (uint8_t i = 0; i < Constants::BAUD_VERIFY_ATTEMPTS; ++i) {
+        if (testConnection() != ATCommandResult::OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t BluetoothLE::BLEHandler::_findBaudRate()
+{
+    for (uint8_t i = 0; i < Constants::BAUD_RATE_COUNT; ++i) {
+        changeBaudRate(Constants::BAUD_RATES[i]);
+        if (testConnection() == ATCommandResult::OK) {
+            return Constants::BAUD_RATES[i];
+        }
+    }
+    return 0;
+}
+
+bool BluetoothLE::BLEHandler::_switchModuleBaud(uint8_t index)
+{
+    const uint32_t previous = _baud;
+    const uint32_t target = Constants::BAUD_RATES[index];
+    char cmd[Constants::COMMAND_BAUD_LENGTH];  // "AT+BAUD" + index + "\r\n"
+    memcpy(cmd, AT::Set::BAUD.data(), AT::Set::BAUD.size());
+    cmd[AT::Set::BAUD.size()] = static_cast<char>('0' + index);
+    memcpy(cmd + AT::Set::BAUD.size() + 1, AT::NEWLINE.data(), AT::NEWLINE.size());
+
+    // The module confirms at the old speed, then switches
+    ATPipelineStep step;
+    step.command = std::string_view(cmd, sizeof(cmd));
+    runPipeline(&step, 1);
+    if (!step.ok) {
+        return false;
+    }
+    changeBaudRate(target);
+    if (_verifyLink()) {
+        return true;
+    }
+
+    changeBaudRate(previous);
+    if (_verifyLink()) {
+        // Some firmwares only apply the new speed after a restart
+        reset();
+        changeBaudRate(target);
+        if (_verifyLink()) {
+            return true;
+        }
+        changeBaudRate(previous);
+        return false;
+    }
+
+    // The module moved but the link does not hold at that speed, send it back blind
+    changeBaudRate(target);
+    for (uint8_t i = 0; i < Constants::BAUD_RATE_COUNT; ++i) {
+        if (Constants::BAUD_RATES[i] == previous) {
+            cmd[AT::Set::BAUD.size()] = static_cast<char>('0' + i);
+            runPipeline(&step, 1);
+            break;
+        }
+    }
+    changeBaudRate(previous);
+    return false;
 }
 
 void BluetoothLE::BLEHandler::_flushSerial()
@@ -748,70 +1705,103 @@ void BluetoothLE::BLEHandler::_flushSerial()
     while (_serial.available()) {
         _serial.read();
     }
+    _parser.reset();
+}
+
+void BluetoothLE::BLEHandler::_onSleepReply(ATCommandResult result, const char *response, size_t length, void *context)
+{
+    BLEHandler *self = static_cast<BLEHandler *>(context);
+    self->_sleep_queued = false;
+    if (result != ATCommandResult::OK) {
+        self->_sleep_stats.refused++;
+        self->_sleep_refusals++;
+        if (self->_sleep_refusals >= Constants::SLEEP_MAX_REFUSALS) {
+            DebugSerial << "[BLE] AT+SLEEP refused " << self->_sleep_refusals << " times, the module stays awake" << endl;
+        }
+        return;
+    }
+    self->_sleep_refusals = 0;
+    self->_sleep_stats.sleeps++;
+    self->_asleep = true;
+    self->_asleep_since_ms = millis();
+}
+
+void BluetoothLE::BLEHandler::_markAwake()
+{
+    if (!_asleep) {
+        return;
+    }
+    _asleep = false;
+    _sleep_stats.asleep_ms += millis() - _asleep_since_ms;
 }
 
 // ==================== Diagnostic & Testing Functions ====================
 
 void BluetoothLE::BLEHandler::testHardware()
 {
-    Serial << "\n=== BLE Hardware Diagnostics ===" << endl;
-    Serial << "BLE_EN_PIN (GPIO" << Pins::BLE_EN_PIN << ") state: " << (digitalRead(Pins::BLE_EN_PIN) ? "HIGH" : "LOW") << endl;
-    Serial << "BLE_STATE_PIN (A0) value: " << analogRead(Pins::BLE_STATE_PIN) << endl;
-    Serial << "BLE_RXD_PIN: GPIO" << Pins::BLE_RXD_PIN << " (should connect to AT-09 TX)" << endl;
-    Serial << "BLE_TXD_PIN: GPIO" << Pins::BLE_TXD_PIN << " (should connect to AT-09 RX)" << endl;
-    Serial << "Baud rate: " << _baud << endl;
-
-    Serial << "\nTrying basic AT command..." << endl;
+    DebugSerial << "\n=== BLE Hardware Diagnostics ===" << endl;
+    DebugSerial << "BLE_EN_PIN (GPIO" << Pins::BLE_EN_PIN << ") state: " << (digitalRead(Pins::BLE_EN_PIN) ? "HIGH" : "LOW") << endl;
+    DebugSerial << "BLE_STATE_PIN (A0) value: " << analogRead(Pins::BLE_STATE_PIN) << endl;
+    DebugSerial << "BLE_RXD_PIN: GPIO" << Pins::BLE_RXD_PIN << " (should connect to AT-09 TX)" << endl;
+    DebugSerial << "BLE_TXD_PIN: GPIO" << Pins::BLE_TXD_PIN << " (should connect to AT-09 RX)" << endl;
+#ifdef BLE_USE_HARDWARE_UART
+    DebugSerial << "Link: hardware UART0 (swapped), logs on UART1" << endl;
+#else
+    DebugSerial << "Link: SoftwareSerial, logs on UART0" << endl;
+#endif
+    DebugSerial << "Baud rate: " << _baud << endl;
+
+    DebugSerial << "\nTrying basic AT command..." << endl;
     ATCommandResult result = testConnection();
-    Serial << "Result: ";
+    DebugSerial << "Result: ";
     switch (result) {
-        case ATCommandResult::OK: Serial << "OK"; break;
-        case ATCommandResult::ERROR: Serial << "ERROR"; break;
-        case ATCommandResult::TIMEOUT: Serial << "TIMEOUT"; break;
-        default: Serial << "UNKNOWN"; break;
+        case ATCommandResult::OK: DebugSerial << "OK"; break;
+        case ATCommandResult::ERROR: DebugSerial << "ERROR"; break;
+        case ATCommandResult::TIMEOUT: DebugSerial << "TIMEOUT"; break;
+        default: DebugSerial << "UNKNOWN"; break;
     }
-    Serial << endl;
-    Serial << "=================================\n" << endl;
+    DebugSerial << endl;
+    DebugSerial << "=================================\n" << endl;
 }
 
 void BluetoothLE::BLEHandler::testBaudRates()
 {
-    Serial << "\n=== Testing Common Baud Rates ===" << endl;
+    DebugSerial << "\n=== Testing Common Baud Rates ===" << endl;
 
-    const uint32_t baud_rates[] = { 9600, 19200, 38400, 57600, 115200 };
-    const uint8_t num_rates = sizeof(baud_rates) / sizeof(baud_rates[0]);
+    const uint32_t *baud_rates = Constants::BAUD_RATES;
+    const uint8_t num_rates = Constants::BAUD_RATE_COUNT;
 
     for (uint8_t i = 0; i < num_rates; i++) {
-        Serial << "\n[" << (i + 1) << "/" << num_rates << "] Testing " << baud_rates[i] << " baud..." << endl;
+        DebugSerial << "\n[" << (i + 1) << "/" << num_rates << "] Testing " << baud_rates[i] << " baud..." << endl;
 
         changeBaudRate(baud_rates[i]);
         delay(200);
 
         ATCommandResult result = testConnection();
-        Serial << "Result: ";
+        DebugSerial << "Result: ";
         switch (result) {
             case ATCommandResult::OK:
-                Serial << "OK - FOUND WORKING BAUD RATE!" << endl;
-                Serial << "=================================\n" << endl;
-                Serial << "*** SUCCESS: Module responds at " << baud_rates[i] << " baud ***\n" << endl;
+                DebugSerial << "OK - FOUND WORKING BAUD RATE!" << endl;
+                DebugSerial << "=================================\n" << endl;
+                DebugSerial << "*** SUCCESS: Module responds at " << baud_rates[i] << " baud ***\n" << endl;
                 return;
             case ATCommandResult::ERROR:
-                Serial << "ERROR" << endl;
+                DebugSerial << "ERROR" << endl;
                 break;
             case ATCommandResult::TIMEOUT:
-                Serial << "TIMEOUT" << endl;
+                DebugSerial << "TIMEOUT" << endl;
                 break;
             default:
-                Serial << "UNKNOWN" << endl;
+                DebugSerial << "UNKNOWN" << endl;
                 break;
         }
     }
 
-    Serial << "\n=== No working baud rate found ===" << endl;
-    Serial << "This suggests a hardware issue (TX/RX swap or power problem)" << endl;
-    Serial << "\nRestoring to original baud rate (" << BLUETOOTH_BAUDRATE << ")..." << endl;
+    DebugSerial << "\n=== No working baud rate found ===" << endl;
+    DebugSerial << "This suggests a hardware issue (TX/RX swap or power problem)" << endl;
+    DebugSerial << "\nRestoring to original baud rate (" << BLUETOOTH_BAUDRATE << ")..." << endl;
     changeBaudRate(BLUETOOTH_BAUDRATE);
-    Serial << "=================================\n" << endl;
+    DebugSerial << "=================================\n" << endl;
 }
 
 void BluetoothLE::BLEHandler::printInitialScan(uint32_t scan_duration_ms)
@@ -822,70 +1812,71 @@ void BluetoothLE::BLEHandler::printInitialScan(uint32_t scan_duration_ms)
         const uint8_t overflow = getOverflowCount();
         const BLEDevice *devices = getScannedDevices();
 
-        Serial << "Found " << deviceCount << " BLE devices:" << endl;
+        DebugSerial << "Found " << deviceCount << " BLE devices:" << endl;
         for (uint8_t i = 0; i < deviceCount; i++) {
-            Serial << " - " << devices[i].address;
-            if (strlen(devices[i].name) > 0) {
-                Serial << " (" << devices[i].name << ")";
+            DebugSerial << " - " << devices[i].address;
+            if (devices[i].name_id != BLEDevice::NO_NAME) {
+                DebugSerial << " (" << getDeviceName(devices[i]) << ")";
             }
-            Serial << " RSSI: " << devices[i].rssi << " dBm" << endl;
+            DebugSerial << " RSSI: " << devices[i].rssi << " dBm" << endl;
         }
 
         if (overflow > 0) {
-            Serial << "WARNING: " << overflow << " devices were not captured (buffer full)" << endl;
+            DebugSerial << "WARNING: " << overflow << " devices were not captured (buffer full)" << endl;
         }
     } else {
-        Serial << "No devices found or scan failed" << endl;
+        DebugSerial << "No devices found or scan failed" << endl;
     }
 }
 
 void BluetoothLE::BLEHandler::printConnectionStatus()
 {
-    Serial << "Checking BLE connection status" << endl;
+    DebugSerial << "Checking BLE connection status" << endl;
     ATCommandResult status = testConnection();
-    Serial << "Connection status: ";
+    DebugSerial << "Connection status: ";
     switch (status) {
         case ATCommandResult::OK:
-            Serial << "[OK]" << endl;
+            DebugSerial << "[OK]" << endl;
             break;
         case ATCommandResult::TIMEOUT:
-            Serial << "[TIMEOUT]" << endl;
+            DebugSerial << "[TIMEOUT]" << endl;
             break;
         case ATCommandResult::ERROR:
-            Serial << "[ERROR]" << endl;
+            DebugSerial << "[ERROR]" << endl;
             break;
         case ATCommandResult::UNKNOWN:
-            Serial << "[UNKNOWN]" << endl;
+            DebugSerial << "[UNKNOWN]" << endl;
             break;
         default:
-            Serial << "[UNKNOWN TYPE]" << endl;
+            DebugSerial << "[UNKNOWN TYPE]" << endl;
             break;
     }
 }
 
 void BluetoothLE::BLEHandler::printPeriodicScan()
 {
-    Serial << "\n========== Periodic BLE Scan ==========" << endl;
+    DebugSerial << "\n========== Periodic BLE Scan ==========" << endl;
     startScan(BLE_PERIODIC_SCAN_DURATION);
 
     uint8_t count = getDeviceCount();
     uint8_t overflow = getOverflowCount();
 
-    Serial << "Detected " << count << " nearby BLE device(s)" << endl;
+    DebugSerial << "Detected " << count << " nearby BLE device(s)" << endl;
 
     if (count > 0) {
         const BLEDevice *devices = getScannedDevices();
         for (uint8_t i = 0; i < count; i++) {
-            Serial << "  [" << (i + 1) << "] " << devices[i].address;
-            if (strlen(devices[i].name) > 0) {
-                Serial << " - " << devices[i].name;
+            DebugSerial << "  [" << (i + 1) << "] " << devices[i].address;
+            if (devices[i].name_id != BLEDevice::NO_NAME) {
+                DebugSerial << " - " << getDeviceName(devices[i]);
             }
-            Serial << " (RSSI: " << devices[i].rssi << " dBm)" << endl;
+            DebugSerial << " (RSSI: " << devices[i].rssi << " dBm)" << endl;
         }
     }
 
     if (overflow > 0) {
-        Serial << "⚠ Lost " << overflow << " devices (increase MAX_BLE_DEVICES if needed)" << endl;
+        DebugSerial << "⚠ Lost " << overflow << " devices (increase MAX_BLE_DEVICES if needed)" << endl;
     }
-    Serial << "=======================================" << endl;
+    DebugSerial << "=======================================" << endl;
 }
+
@@ -0,0 +1,83 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ble_name_pool.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the pool interning the device names advertised during a scan.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstring>
+#include "ble_name_pool.hpp"
+
+uint8_t BluetoothLE::NamePool::intern(const char *name, size_t length)
+{
+    if (name == nullptr || length == 0) {
+        return BLEDevice::NO_NAME;
+    }
+    if (length > Constants::MAX_DEVICE_NAME_LENGTH) {
+        length = Constants::MAX_DEVICE_NAME_LENGTH;
+    }
+
+    // A scan only holds a handful of names, a linear search is enough
+    for (uint8_t id = 0; id < _count; ++id) {
+        const char *known = _buffer + _offsets[id];
+        if (strncmp(known, name, length) == 0 && known[length] == '\0') {
+            return id;
+        }
+    }
+
+    if (_count >= Constants::MAX_INTERNED_NAMES || _used + length + 1 > sizeof(_buffer)) {
+        _rejected++;
+        return BLEDevice::NO_NAME;
+    }
+    _offsets[_count] = static_cast<uint16_t>(_used);
+    memcpy(_buffer + _used, name, length);
+    _buffer[_used + length] = '\0';
+    _used += length + 1;
+    return _count++;
+}
+
+const char *BluetoothLE::NamePool::get(const uint8_t id) const
+{
+    if (id >= _count) {
+        return "";
+    }
+    return _buffer + _offsets[id];
+}
+
+void BluetoothLE::NamePool::clear()
+{
+    _count = 0;
+    _used = 0;
+    _rejected = 0;
+}
+
+uint8_t BluetoothLE::NamePool::count() const
+{
+    return _count;
+}
+
+size_t BluetoothLE::NamePool::used_bytes() const
+{
+    return _used;
+}
+
+uint16_t BluetoothLE::NamePool::rejected() const
+{
+    return _rejected;
+}
@@ -0,0 +1,79 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: ble_settings.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the BLE settings kept in flash across reboots.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <EEPROM.h>
+#include "ble_settings.hpp"
+#include "ble_constants.hpp"
+#include "config.hpp"
+
+namespace
+{
+    uint8_t record_checksum(const BluetoothLE::Settings::BaudRecord &record)
+    {
+        uint8_t sum = static_cast<uint8_t>(record.magic ^ (record.magic >> 8));
+        for (uint8_t shift = 0; shift < 32; shift += 8) {
+            sum ^= static_cast<uint8_t>(record.baud >> shift);
+        }
+        return static_cast<uint8_t>(~sum);
+    }
+
+    bool is_supported(const uint32_t baud)
+    {
+        for (uint8_t i = 0; i < BluetoothLE::Constants::BAUD_RATE_COUNT; ++i) {
+            if (BluetoothLE::Constants::BAUD_RATES[i] == baud) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+uint32_t BluetoothLE::Settings::load_baud_rate()
+{
+    BaudRecord record;
+    EEPROM.begin(EEPROM_SIZE);
+    EEPROM.get(EEPROM_BLE_BAUD_ADDRESS, record);
+    EEPROM.end();
+    if (record.magic != BAUD_RECORD_MAGIC || record.checksum != record_checksum(record) || !is_supported(record.baud)) {
+        return 0;
+    }
+    return record.baud;
+}
+
+bool BluetoothLE::Settings::save_baud_rate(const uint32_t baud)
+{
+    if (!is_supported(baud)) {
+        return false;
+    }
+    if (load_baud_rate() == baud) {
+        return true;  // Spare the flash an erase cycle
+    }
+    BaudRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = BAUD_RECORD_MAGIC;
+    record.baud = baud;
+    record.checksum = record_checksum(record);
+    EEPROM.begin(EEPROM_SIZE);
+    EEPROM.put(EEPROM_BLE_BAUD_ADDRESS, record);
+    return EEPROM.end();
+}
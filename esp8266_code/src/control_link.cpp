@@ -0,0 +1,152 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: control_link.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the kept-alive connection to the control server.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <cstring>
+#include "control_link.hpp"
+
+HttpServer::ControlLink::ControlLink(HTTPClient &http)
+    : _http(http)
+{
+}
+
+/**
+ * @brief Point the HTTP client at the control server, on the kept connection when there is one.
+ *
+ * @param method HTTP method, must outlive the request (a literal)
+ * @param path One of the ServerEndpoints::Url paths
+ * @return false when the URL could not be parsed
+ */
+bool HttpServer::ControlLink::begin(const char *method, const std::string_view &path)
+{
+    const unsigned long now = millis();
+    if (_client.connected() && now - _last_used_ms >= CONTROL_KEEP_ALIVE_IDLE_MS) {
+        // The server is about to drop it, a request sent at the same time would be lost
+        _client.stop();
+        _stats.idle_closes++;
+    }
+    _reused = _client.connected();
+    _method = method;
+    _path = path;
+    _code = 0;
+    _started_ms = now;
+
+    char url[256];
+    snprintf(url, sizeof(url), "%s%.*s", CONTROL_SERVER, static_cast<int>(path.size()), path.data());
+    _http.setReuse(true);
+    if (!_http.begin(_client, url)) {
+        DebugSerial << "[Control] Invalid URL: " << url << endl;
+        return false;
+    }
+    _http.addHeader("Content-Type", "application/json");
+    _http.addHeader("Authorization", CONTROL_AUTHORIZATION);
+    return true;
+}
+
+/**
+ * @brief Send the prepared request, once more on a new connection when the kept one was found dead.
+ *
+ * A POST is only sent again when it provably never reached the server: a
+ * read timeout or a connection lost after the headers went out can follow a
+ * request the server already handled, and feeding or booking twice is worse
+ * than one failed request.
+ *
+ * @param body JSON body, null terminated
+ * @return int HTTP status, or the negative HTTPClient error
+ */
+int HttpServer::ControlLink::send(const char *body)
+{
+    const size_t length = strlen(body);
+    int code = _http.sendRequest(_method, reinterpret_cast<const uint8_t *>(body), length);
+    const bool never_left = (code == HTTPC_ERROR_CONNECTION_REFUSED || code == HTTPC_ERROR_SEND_HEADER_FAILED);
+    if (code < 0 && _reused && (never_left || strcmp(_method, "GET") == 0)) {
+        // Closed on the server side since the previous request, HTTPClient reconnects on the next send
+        _stats.retries++;
+        _client.stop();
+        _reused = false;
+        code = _http.sendRequest(_method, reinterpret_cast<const uint8_t *>(body), length);
+    }
+    _code = code;
+    return code;
+}
+
+void HttpServer::ControlLink::end()
+{
+    // With setReuse(true) the socket stays open unless the server asked for Connection: close
+    _http.end();
+    const unsigned long now = millis();
+    const uint32_t elapsed = now - _started_ms;
+    _last_used_ms = now;
+    if (_code < 0) {
+        _client.stop();
+        _stats.failures++;
+    }
+
+    _stats.requests++;
+    if (_reused) {
+        _stats.reused++;
+        _stats.reused_ms += elapsed;
+    } else {
+        _stats.connects++;
+        _stats.connect_ms += elapsed;
+    }
+    _stats.last_ms = elapsed;
+    if (elapsed > _stats.worst_ms) {
+        _stats.worst_ms = elapsed;
+    }
+    DebugSerial << "[Control] " << _method << " " << _path << " -> " << _code << " in " << elapsed << " ms (" << (_reused ? "kept-alive" : "new connection") << ")" << endl;
+}
+
+bool HttpServer::ControlLink::connected() const
+{
+    return _client.connected();
+}
+
+uint32_t HttpServer::ControlLink::mean_ms() const
+{
+    return (_stats.requests == 0) ? 0 : (_stats.reused_ms + _stats.connect_ms) / _stats.requests;
+}
+
+uint32_t HttpServer::ControlLink::mean_reused_ms() const
+{
+    return (_stats.reused == 0) ? 0 : _stats.reused_ms / _stats.reused;
+}
+
+uint32_t HttpServer::ControlLink::mean_connect_ms() const
+{
+    return (_stats.connects == 0) ? 0 : _stats.connect_ms / _stats.connects;
+}
+
+const HttpServer::ControlLinkStats &HttpServer::ControlLink::stats() const
+{
+    return _stats;
+}
+
+void HttpServer::ControlLink::print() const
+{
+    DebugSerial << "============ Control Link ============" << endl;
+    DebugSerial << "Connection: " << (connected() ? "open" : "closed") << endl;
+    DebugSerial << "Requests: " << _stats.requests << " (" << _stats.reused << " kept-alive, " << _stats.connects << " new connections), retries: " << _stats.retries << ", failures: " << _stats.failures << endl;
+    DebugSerial << "Latency: last " << _stats.last_ms << " ms, worst " << _stats.worst_ms << " ms, mean " << mean_ms() << " ms (kept-alive " << mean_reused_ms() << " ms, new connection " << mean_connect_ms() << " ms)" << endl;
+    DebugSerial << "Idle closes: " << _stats.idle_closes << endl;
+    DebugSerial << "======================================" << endl;
+}
@@ -0,0 +1,102 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: feed_plan.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the queue of portions decided by the control server for the beacons of one scan.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "feed_plan.hpp"
+
+/**
+ * @brief Start a plan for the reply of a batched decision.
+ *
+ * @param beacons Number of beacons the request carried
+ */
+void Feeder::FeedPlan::begin(const uint8_t beacons)
+{
+    _count = 0;
+    _served = 0;
+    _stats.requests++;
+    _stats.beacons += beacons;
+    // The per-beacon path sent a visit and a fed check for each beacon, the fed updates are counted by add()
+    if (beacons > 0) {
+        _stats.round_trips_saved += 2u * beacons - 1u;
+    }
+}
+
+bool Feeder::FeedPlan::add(const BluetoothLE::MacAddress &beacon, const uint32_t grams)
+{
+    if (grams == 0) {
+        return false;
+    }
+    if (_count >= MAX_DUE_BEACONS) {
+        _stats.dropped++;
+        return false;
+    }
+    _portions[_count].beacon = beacon;
+    _portions[_count].grams = grams;
+    _count++;
+    _stats.planned++;
+    _stats.round_trips_saved++;
+    return true;
+}
+
+void Feeder::FeedPlan::record_failure()
+{
+    _stats.failures++;
+}
+
+bool Feeder::FeedPlan::next(FeedPortion &portion)
+{
+    if (_served >= _count) {
+        return false;
+    }
+    portion = _portions[_served++];
+    _stats.served++;
+    return true;
+}
+
+uint8_t Feeder::FeedPlan::pending() const
+{
+    return _count - _served;
+}
+
+const Feeder::FeedPlanStats &Feeder::FeedPlan::stats() const
+{
+    return _stats;
+}
+
+void Feeder::FeedPlan::clear()
+{
+    _count = 0;
+    _served = 0;
+    _stats = FeedPlanStats();
+}
+
+void Feeder::FeedPlan::print() const
+{
+    DebugSerial << "============== Feed Plan =============" << endl;
+    for (uint8_t i = _served; i < _count; ++i) {
+        DebugSerial << "  " << _portions[i].beacon << ": " << _portions[i].grams << " g" << endl;
+    }
+    DebugSerial << "Requests: " << _stats.requests << " (" << _stats.beacons << " beacons), failures: " << _stats.failures << endl;
+    DebugSerial << "Portions: " << _stats.planned << " planned, " << _stats.served << " served, " << _stats.dropped << " dropped" << endl;
+    DebugSerial << "Round-trips saved: " << _stats.round_trips_saved << endl;
+    DebugSerial << "======================================" << endl;
+}
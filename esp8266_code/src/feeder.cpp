@@ -0,0 +1,168 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: feeder.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the non-blocking feeding sequence (tray and trap state machine).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "feeder.hpp"
+
+const char *Feeder::phase_name(const FeedPhase phase)
+{
+    switch (phase) {
+        case FeedPhase::Idle:
+            return "idle";
+        case FeedPhase::ClosingTray:
+            return "closing tray";
+        case FeedPhase::OpeningTrap:
+            return "opening trap";
+        case FeedPhase::Dispensing:
+            return "dispensing";
+        case FeedPhase::ClosingTrap:
+            return "closing trap";
+        case FeedPhase::OpeningTray:
+            return "opening tray";
+        default:
+            return "unknown";
+    }
+}
+
+Feeder::FeedingSequence::FeedingSequence(Motors::Motor *tray_motor, Motors::Motor *trap_motor)
+    : _tray(tray_motor), _trap(trap_motor)
+{
+}
+
+bool Feeder::FeedingSequence::start(const uint32_t amount_grams, const uint32_t now_ms)
+{
+    if (is_busy()) {
+        DebugSerial << "[Feeder] A feed is already in progress (" << phase_name(_phase) << "), ignoring request" << endl;
+        return false;
+    }
+    if (_tray == nullptr || _trap == nullptr) {
+        DebugSerial << "[Feeder] Motors are not available, cannot feed" << endl;
+        return false;
+    }
+    _dispense_ms = amount_grams * FEEDING_MS_PER_GRAM;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(FeedPhase::_COUNT); ++i) {
+        _started_at[i] = 0;
+        _durations[i] = 0;
+    }
+    DebugSerial << "[Feeder] Dispensing " << amount_grams << " g (trap open for " << _dispense_ms << " ms)" << endl;
+    _enter(FeedPhase::ClosingTray, now_ms);
+    return true;
+}
+
+void Feeder::FeedingSequence::tick(const uint32_t now_ms)
+{
+    if (_phase == FeedPhase::Idle) {
+        return;
+    }
+    const uint8_t index = static_cast<uint8_t>(_phase);
+    if (now_ms - _started_at[index] < _durations[index]) {
+        return;
+    }
+    // Only one phase per tick: the next movement starts from the time it is
+    // actually commanded, not from when the previous one should have ended.
+    _finish_motor();
+    _enter(static_cast<FeedPhase>((index + 1) % static_cast<uint8_t>(FeedPhase::_COUNT)), now_ms);
+}
+
+bool Feeder::FeedingSequence::is_busy() const
+{
+    return _phase != FeedPhase::Idle;
+}
+
+Feeder::FeedPhase Feeder::FeedingSequence::phase() const
+{
+    return _phase;
+}
+
+uint32_t Feeder::FeedingSequence::phase_started_at(const FeedPhase phase) const
+{
+    return _started_at[static_cast<uint8_t>(phase)];
+}
+
+uint32_t Feeder::FeedingSequence::phase_duration(const FeedPhase phase) const
+{
+    return _durations[static_cast<uint8_t>(phase)];
+}
+
+uint32_t Feeder::FeedingSequence::completed_feeds() const
+{
+    return _completed_feeds;
+}
+
+uint32_t Feeder::FeedingSequence::last_feed_duration() const
+{
+    return _last_feed_duration;
+}
+
+// ==================== Private Helper Methods ====================
+
+void Feeder::FeedingSequence::_enter(const FeedPhase phase, const uint32_t now_ms)
+{
+    const uint8_t index = static_cast<uint8_t>(phase);
+    _phase = phase;
+    _started_at[index] = now_ms;
+
+    switch (phase) {
+        case FeedPhase::ClosingTray:
+            DebugSerial << "[Feeder] Closing tray" << endl;
+            _durations[index] = _tray->begin_turn_right_degrees(FEEDER_FLAP_DEGREES);
+            break;
+        case FeedPhase::OpeningTrap:
+            DebugSerial << "[Feeder] Opening food trap" << endl;
+            _durations[index] = _trap->begin_turn_left_degrees(FEEDER_FLAP_DEGREES);
+            break;
+        case FeedPhase::Dispensing:
+            DebugSerial << "[Feeder] Dispensing food to tray" << endl;
+            _durations[index] = _dispense_ms;
+            break;
+        case FeedPhase::ClosingTrap:
+            DebugSerial << "[Feeder] Food dispensed to tray, closing trap" << endl;
+            _durations[index] = _trap->begin_turn_right_degrees(FEEDER_FLAP_DEGREES);
+            break;
+        case FeedPhase::OpeningTray:
+            DebugSerial << "[Feeder] Trap closed, opening tray" << endl;
+            _durations[index] = _tray->begin_turn_left_degrees(FEEDER_FLAP_DEGREES);
+            break;
+        default:
+            _durations[index] = 0;
+            _completed_feeds++;
+            _last_feed_duration = now_ms - _started_at[static_cast<uint8_t>(FeedPhase::ClosingTray)];
+            DebugSerial << "[Feeder] Tray opened, Bon appetit (" << _last_feed_duration << " ms)" << endl;
+            break;
+    }
+}
+
+void Feeder::FeedingSequence::_finish_motor()
+{
+    switch (_phase) {
+        case FeedPhase::ClosingTray:
+        case FeedPhase::OpeningTray:
+            _tray->end_turn();
+            break;
+        case FeedPhase::OpeningTrap:
+        case FeedPhase::ClosingTrap:
+            _trap->end_turn();
+            break;
+        default:
+            break;
+    }
+}
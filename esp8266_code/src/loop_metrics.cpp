@@ -0,0 +1,119 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: loop_metrics.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the loop latency histogram (log2 buckets measured with the cpu cycle counter).
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "loop_metrics.hpp"
+#include "sentinels.hpp"
+
+uint32_t MyUtils::Metrics::LoopMetrics::_pass_start_cycles = 0;
+uint32_t MyUtils::Metrics::LoopMetrics::_buckets[LOOP_METRICS_BUCKETS] = {};
+uint32_t MyUtils::Metrics::LoopMetrics::_max_us = 0;
+uint32_t MyUtils::Metrics::LoopMetrics::_last_us = 0;
+uint64_t MyUtils::Metrics::LoopMetrics::_count = 0;
+uint64_t MyUtils::Metrics::LoopMetrics::_total_us = 0;
+
+void MyUtils::Metrics::LoopMetrics::begin_pass()
+{
+    _pass_start_cycles = ESP.getCycleCount();
+}
+
+void MyUtils::Metrics::LoopMetrics::end_pass()
+{
+    // Unsigned subtraction stays correct across one counter wrap-around
+    const uint32_t cycles = ESP.getCycleCount() - _pass_start_cycles;
+    record(cycles / ESP.getCpuFreqMHz());
+}
+
+void MyUtils::Metrics::LoopMetrics::record(const uint32_t duration_us)
+{
+    _buckets[_bucket_index(duration_us)]++;
+    _last_us = duration_us;
+    if (duration_us > _max_us) {
+        _max_us = duration_us;
+    }
+    _count++;
+    _total_us += duration_us;
+}
+
+uint32_t MyUtils::Metrics::LoopMetrics::bucket(const uint8_t index)
+{
+    if (index >= LOOP_METRICS_BUCKETS) {
+        return 0;
+    }
+    return _buckets[index];
+}
+
+uint32_t MyUtils::Metrics::LoopMetrics::bucket_upper_us(const uint8_t index)
+{
+    if (index >= LOOP_METRICS_BUCKETS - 1) {
+        return UINT32_MAX_VALUE;
+    }
+    return 1UL << index;
+}
+
+uint8_t MyUtils::Metrics::LoopMetrics::bucket_count()
+{
+    return LOOP_METRICS_BUCKETS;
+}
+
+uint32_t MyUtils::Metrics::LoopMetrics::max_us()
+{
+    return _max_us;
+}
+
+uint32_t MyUtils::Metrics::LoopMetrics::last_us()
+{
+    return _last_us;
+}
+
+uint64_t MyUtils::Metrics::LoopMetrics::count()
+{
+    return _count;
+}
+
+uint64_t MyUtils::Metrics::LoopMetrics::total_us()
+{
+    return _total_us;
+}
+
+void MyUtils::Metrics::LoopMetrics::reset()
+{
+    for (uint8_t i = 0; i < LOOP_METRICS_BUCKETS; ++i) {
+        _buckets[i] = 0;
+    }
+    _max_us = 0;
+    _last_us = 0;
+    _count = 0;
+    _total_us = 0;
+}
+
+// ==================== Private Helper Methods ====================
+
+uint8_t MyUtils::Metrics::LoopMetrics::_bucket_index(const uint32_t duration_us)
+{
+    if (duration_us == 0) {
+        return 0;
+    }
+    // Position of the highest set bit + 1: 1 µs -> 1, 2-3 µs -> 2, 4-7 µs -> 3...
+    const uint8_t index = static_cast<uint8_t>(32 - __builtin_clz(duration_us));
+    return (index < LOOP_METRICS_BUCKETS) ? index : LOOP_METRICS_BUCKETS - 1;
+}
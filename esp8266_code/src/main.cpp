@@ -31,17 +31,31 @@
 #include "motors.hpp"
 #include "my_utils.hpp"
 #include "ble_handler.hpp"
+#include "beacon_tracker.hpp"
+#include "beacon_allowlist.hpp"
+#include "visit_buffer.hpp"
+#include "feed_plan.hpp"
+#include "scan_duty_cycle.hpp"
+#include "ble_command_channel.hpp"
 #include "wifi_handler.hpp"
+#include "loop_metrics.hpp"
+#include "task_scheduler.hpp"
 #include "shared_dependencies.hpp"
 #include "server_control_endpoints.hpp"
 
 bool led_state = false;
 bool led_cleared = false;
-unsigned long last_toggle = 0;
 static unsigned long long iteration = 0;
 static unsigned long last_ble_scan = 0;
-static unsigned long last_sign_of_life = 0;
-static unsigned long last_ble_status_check = 0;
+static int8_t blinker_task = -1;
+static BluetoothLE::MacAddress due_beacons[MAX_DUE_BEACONS];  // Sighted by the running scan, waiting for the server
+static uint8_t due_beacon_count = 0;
+static bool known_beacon_in_scan = false;  // The running window saw a beacon of the owner or one at the feeder
+
+void register_tasks();
+void handle_ble_data();
+bool is_known_beacon(const BluetoothLE::MacAddress &address, void *context);
+void on_ble_connection_changed(bool connected, void *context);
 
 static LED::ColourPos loop_progress[] = {
     { 0, LED::led_get_colour_from_pointer(&LED::Colours::Yellow) },                 // moving dot
@@ -54,22 +68,22 @@ void setup()
     // ─────────────── Pins & Serial ───────────────
     Pins::init();
 
-    Serial.begin(SERIAL_BAUDRATE);
-    Serial << "Starting up..." << endl;
+    DebugSerial.begin(SERIAL_BAUDRATE);
+    DebugSerial << "Starting up..." << endl;
     delay(100);
 
     // ─────────────── LED Initialization ───────────────
-    Serial << "Initializing LEDs..." << endl;
+    DebugSerial << "Initializing LEDs..." << endl;
     LED::led_init();
     LED::Nodes::set_pos_step(loop_progress[0], 0);
     // Set up the cycle led animation
-    Serial << "Setting up LED cycle animation..." << endl;
+    DebugSerial << "Setting up LED cycle animation..." << endl;
     MyUtils::ActiveComponents::initialise_active_components();
-    Serial << "LED cycle animation set up complete" << endl;
-    Serial << "LEDs initialized" << endl;
+    DebugSerial << "LED cycle animation set up complete" << endl;
+    DebugSerial << "LEDs initialized" << endl;
 
     // ─────────────── WiFi ───────────────
-    Serial << "Initializing WiFi..." << endl;
+    DebugSerial << "Initializing WiFi..." << endl;
     LED::ColourPos wifi_anim[] = {
         {0, LED::green_colour},
         {UINT16_MAX_VALUE, {}}
@@ -77,120 +91,162 @@ void setup()
     LED::Nodes::set_pos_step(wifi_anim[0], 0);
 
     static Wifi::WifiHandler wifiHandler(SSID, SSID_PASSWORD, LED::dark_blue, wifi_anim);
-    Serial << "Sharing WiFi handler pointer..." << endl;
+    DebugSerial << "Sharing WiFi handler pointer..." << endl;
     SharedDependencies::wifiHandler = &wifiHandler;
-    Serial << "WiFi handler pointer shared" << endl;
-    Serial << "Setting up WiFi handler..." << endl;
+    DebugSerial << "WiFi handler pointer shared" << endl;
+    DebugSerial << "Setting up WiFi handler..." << endl;
     wifiHandler.init();
-    Serial << "Connecting to WiFi..." << endl;
+    DebugSerial << "Connecting to WiFi..." << endl;
     wifiHandler.connect();
-    Serial << "WiFi initialized" << endl;
+    DebugSerial << "WiFi initialized" << endl;
+    static HttpServer::ControlLink controlLink(*SharedDependencies::webClient);
+    DebugSerial << "Sharing control link pointer..." << endl;
+    SharedDependencies::controlLink = &controlLink;
+    DebugSerial << "Control link pointer shared" << endl;
 
 
-    Serial << "Unveiling IP..." << endl;
+    DebugSerial << "Unveiling IP..." << endl;
     LED::led_set_colour(LED::red_colour, LED_DURATION, -1);
     send_ip_to_ntfy();
     LED::led_set_colour(LED::yellow_colour, LED_DURATION, -1);
-    Serial << "\nConnected!" << endl;
+    DebugSerial << "\nConnected!" << endl;
     wifiHandler.showIp();
 
     // ─────────────── Motors ───────────────
-    Serial << "Initializing motors..." << endl;
-    Serial << "Declaring left motor..." << endl;
+    DebugSerial << "Initializing motors..." << endl;
+    DebugSerial << "Declaring left motor..." << endl;
     static Motors::Motor kibble_tray(Pins::MOTOR1_PIN, loop_progress, MOTOR_SPEED_DEFAULT, LED::dark_blue, LED::red_colour, MyUtils::ActiveComponents::Component::MotorLeft);
-    Serial << "Left motor declared" << endl;
-    Serial << "Sharing left motor pointer..." << endl;
+    DebugSerial << "Left motor declared" << endl;
+    DebugSerial << "Sharing left motor pointer..." << endl;
     SharedDependencies::leftMotor = &kibble_tray;
-    Serial << "Left motor pointer shared" << endl;
-    Serial << "Initialising left motor..." << endl;
+    DebugSerial << "Left motor pointer shared" << endl;
+    DebugSerial << "Initialising left motor..." << endl;
     kibble_tray.init();
-    Serial << "Right motor initialized" << endl;
+    DebugSerial << "Right motor initialized" << endl;
     // Disabled the calibration test because it would offset it
-    // Serial << "Running test turn on left motor..." << endl;
+    // DebugSerial << "Running test turn on left motor..." << endl;
     // kibble_tray.calibrate();
-    // Serial << "Left motor callibrated" << endl;
+    // DebugSerial << "Left motor callibrated" << endl;
 
-    Serial << "Initializing right motor..." << endl;
+    DebugSerial << "Initializing right motor..." << endl;
     static Motors::Motor food_trap(Pins::MOTOR2_PIN, loop_progress, MOTOR_SPEED_DEFAULT, LED::dark_blue, LED::red_colour, MyUtils::ActiveComponents::Component::MotorRight);
-    Serial << "Rigth motor declared" << endl;
-    Serial << "Sharing right motor pointer..." << endl;
+    DebugSerial << "Rigth motor declared" << endl;
+    DebugSerial << "Sharing right motor pointer..." << endl;
     SharedDependencies::rightMotor = &food_trap;
-    Serial << "Right motor pointer shared" << endl;
-    Serial << "Initialising right motor..." << endl;
+    DebugSerial << "Right motor pointer shared" << endl;
+    DebugSerial << "Initialising right motor..." << endl;
     food_trap.init();
-    Serial << "Right motor initialized" << endl;
+    DebugSerial << "Right motor initialized" << endl;
     // Disabled the calibration test because it would offset it
-    // Serial << "Running test turn on right motor..." << endl;
+    // DebugSerial << "Running test turn on right motor..." << endl;
     // food_trap.calibrate();
-    // Serial << "Right motor callibrated" << endl;
+    // DebugSerial << "Right motor callibrated" << endl;
+    DebugSerial << "Declaring feeding sequence..." << endl;
+    static Feeder::FeedingSequence feeding_sequence(&kibble_tray, &food_trap);
+    SharedDependencies::feeder = &feeding_sequence;
+    DebugSerial << "Feeding sequence pointer shared" << endl;
+    static Feeder::FeedPlan feedPlan;
+    SharedDependencies::feedPlan = &feedPlan;
+    DebugSerial << "Feed plan pointer shared" << endl;
 
     // ─────────────── HTTP Server ───────────────
-    Serial << "Starting HTTP server..." << endl;
+    DebugSerial << "Starting HTTP server..." << endl;
     HttpServer::initialize_server();
-    Serial << "HTTP server started" << endl;
+    DebugSerial << "HTTP server started" << endl;
     LED::led_set_colour(LED::blue_colour, LED_DURATION, -1);
 
     // ─────────────── Bluetooth ───────────────
-    Serial << "Setting up bluetooth..." << endl;
+    DebugSerial << "Setting up bluetooth..." << endl;
     static BluetoothLE::BLEHandler bleHandler(BLUETOOTH_BAUDRATE);
-    Serial << "Sharing bluetooth handler pointer..." << endl;
+    DebugSerial << "Sharing bluetooth handler pointer..." << endl;
     SharedDependencies::bleHandler = &bleHandler;
-    Serial << "Bluetooth handler pointer shared" << endl;
-    Serial << "Initializing bluetooth..." << endl;
+    DebugSerial << "Bluetooth handler pointer shared" << endl;
+    static BluetoothLE::BeaconTracker beaconTracker;
+    SharedDependencies::beaconTracker = &beaconTracker;
+    DebugSerial << "Beacon tracker pointer shared" << endl;
+    static BluetoothLE::BeaconAllowlist beaconAllowlist;
+    SharedDependencies::beaconAllowlist = &beaconAllowlist;
+    DebugSerial << "Beacon allowlist pointer shared" << endl;
+    static BluetoothLE::VisitBuffer visitBuffer;
+    SharedDependencies::visitBuffer = &visitBuffer;
+    DebugSerial << "Visit buffer pointer shared" << endl;
+    static BluetoothLE::ScanDutyCycle scanDutyCycle;
+    SharedDependencies::scanDutyCycle = &scanDutyCycle;
+    DebugSerial << "Scan duty cycle pointer shared" << endl;
+    static BluetoothLE::CommandChannel commandChannel;
+    SharedDependencies::commandChannel = &commandChannel;
+    DebugSerial << "Bluetooth command channel pointer shared" << endl;
+    bleHandler.setKnownDeviceFilter(is_known_beacon);
+    bleHandler.setConnectionCallback(on_ble_connection_changed);
+    DebugSerial << "Initializing bluetooth..." << endl;
     bleHandler.init();
-    Serial << "Enabling bluetooth..." << endl;
+    DebugSerial << "Enabling bluetooth..." << endl;
     bleHandler.enable();
-    Serial << "Granting additional wait time for first boot..." << endl;
+    DebugSerial << "Granting additional wait time for first boot..." << endl;
     delay(200);  // AT-09 needs ~200-300ms after power-on (enable() already has 100ms)
+    DebugSerial << "Negotiating bluetooth baud rate..." << endl;
+    if (bleHandler.negotiateBaudRate() == 0) {
+        DebugSerial << "Warning: BLE module not answering, check the wiring" << endl;
+    }
     // Hardware diagnostics
-    Serial << "Testing Hardware..." << endl;
+    DebugSerial << "Testing Hardware..." << endl;
     bleHandler.testHardware();
 
     // Debug: Uncomment to test different baud rates
     // bleHandler.testBaudRates();
 
-    Serial << "Ble module information..." << endl;
+    DebugSerial << "Ble module information..." << endl;
+    bleHandler.refreshModuleInfo();
     bleHandler.printStatus();
 
     // Setup as discoverable peripheral (slave mode)
-    Serial << "Configuring as discoverable BLE peripheral..." << endl;
+    DebugSerial << "Configuring as discoverable BLE peripheral..." << endl;
     if (bleHandler.setupSlaveMode(BOARD_NAME)) {
-        Serial << "Device is now discoverable as: " << BOARD_NAME << endl;
+        DebugSerial << "Device is now discoverable as: " << BOARD_NAME << endl;
     } else {
-        Serial << "Warning: Slave mode setup failed, device may not be discoverable" << endl;
+        DebugSerial << "Warning: Slave mode setup failed, device may not be discoverable" << endl;
     }
 
-    Serial << "Serial BT started" << endl;
+    DebugSerial << "Serial BT started" << endl;
 
     // Give a sign of life to the control server
-    Serial << "Giving a sign of life to the server" << endl;
+    DebugSerial << "Giving a sign of life to the server" << endl;
     bool broadcast_status = HttpServer::ServerEndpoints::Handler::Put::ip();
     if (broadcast_status) {
-        Serial << "Sign of life provided successfully" << endl;
+        DebugSerial << "Sign of life provided successfully" << endl;
     } else {
-        Serial << "Failed to provide a sign of life to the server, is it down?" << endl;
+        DebugSerial << "Failed to provide a sign of life to the server, is it down?" << endl;
+    }
+
+    // Only the beacons of the owner are reported, until this succeeds every beacon is
+    DebugSerial << "Fetching the beacon allowlist" << endl;
+    if (!HttpServer::ServerEndpoints::Handler::Get::beacons(beaconAllowlist)) {
+        DebugSerial << "Beacon allowlist unavailable, reporting every beacon until the next sync" << endl;
     }
 
     // Final render to clear all setup artifacts
-    Serial << "Clearing setup artifacts..." << endl;
+    DebugSerial << "Clearing setup artifacts..." << endl;
     MyUtils::ActiveComponents::Panel::render();
-    Serial << "Setup complete - entering main loop" << endl;
+
+    // ─────────────── Scheduler ───────────────
+    DebugSerial << "Registering loop tasks..." << endl;
+    register_tasks();
+    DebugSerial << "Loop tasks registered" << endl;
+    DebugSerial << "Setup complete - entering main loop" << endl;
 }
 
 void onboard_blinker()
 {
-    uint32_t now = millis();
-    if (now - last_toggle >= blinkInterval) {
-        last_toggle = now;
-        led_state = !led_state;
-        digitalWrite(Pins::LED_PIN, led_state ? LOW : HIGH);
-    }
+    led_state = !led_state;
+    digitalWrite(Pins::LED_PIN, led_state ? LOW : HIGH);
+    // The interval can be changed at runtime through the /blink endpoint
+    MyUtils::Scheduler::TaskScheduler::set_period(blinker_task, blinkInterval);
 }
 
 void increment_iteration()
 {
     if (iteration + 1 == UINT32_MAX_VALUE) {
-        Serial << "Iteration counter overflow imminent, resetting to 0" << endl;
+        DebugSerial << "Iteration counter overflow imminent, resetting to 0" << endl;
         iteration = 0;
     } else {
         iteration++;
@@ -203,49 +259,12 @@ void refresh_ble_scan()
         last_ble_scan = millis();
         SharedDependencies::bleHandler->printPeriodicScan();
 
-        // Check for BLE connection and handle incoming data
-        const bool ble_status = SharedDependencies::bleHandler->isConnected();
-        if (ble_status) {
-            String received = SharedDependencies::bleHandler->receive();
-            if (received.length() > 0) {
-                Serial << "Received over Bluetooth: " << received << endl;
-
-                // Example: respond to commands
-                if (received.indexOf("SCAN") >= 0) {
-                    Serial << "Command received: Starting scan..." << endl;
-                    SharedDependencies::bleHandler->startScan(5000);
-
-                    // Send results back via BLE
-                    uint8_t count = SharedDependencies::bleHandler->getDeviceCount();
-                    const BluetoothLE::BLEDevice *devices = SharedDependencies::bleHandler->getScannedDevices();
-
-                    Serial << "Found " << count << " devices" << endl;
-                    for (uint8_t i = 0; i < count; i++) {
-                        Serial << devices[i].address << endl;
-                    }
-
-                    uint8_t overflow = SharedDependencies::bleHandler->getOverflowCount();
-                    if (overflow > 0) {
-                        Serial << "Lost: " << overflow << endl;
-                    }
-                } else if (received.indexOf("STATUS") >= 0) {
-                    SharedDependencies::bleHandler->printStatus();
-                } else if (received.indexOf("CONNECT:") >= 0) {
-                    // Extract MAC address (e.g., "CONNECT:001122334455")
-                    String address = received.substring(8);
-                    address.trim();
-                    if (SharedDependencies::bleHandler->connectToDevice(address)) {
-                        SharedDependencies::bleHandler->send("Connected to " + address);
-                    } else {
-                        SharedDependencies::bleHandler->send("Connection failed");
-                    }
-                }
-            }
-        }
+        // Check for BLE connection and handle incoming commands
+        handle_ble_data();
     }
 }
 
-// Handle incoming BLE data from connected devices
+// Handle the framed commands of a paired phone, see ble_command_channel.hpp
 void handle_ble_data()
 {
     // Only check if connected
@@ -258,168 +277,273 @@ void handle_ble_data()
         return;
     }
 
-    // Option 1: Receive as String (easier but allocates memory)
-    String received = SharedDependencies::bleHandler->receive();
+    char buffer[BLE_COMMAND_READ_CHUNK];
+    const size_t bytes_read = SharedDependencies::bleHandler->receive(buffer, sizeof(buffer));
+    uint8_t response[BluetoothLE::Protocol::MAX_RESPONSE_SIZE];
+    const uint32_t now = millis();
+    for (size_t i = 0; i < bytes_read; ++i) {
+        const size_t length = SharedDependencies::commandChannel->feed(static_cast<uint8_t>(buffer[i]), now, response, sizeof(response));
+        if (length > 0) {
+            SharedDependencies::bleHandler->send(reinterpret_cast<const char *>(response), length);
+        }
+    }
+}
 
-    // Option 2: Receive into buffer (more efficient, no heap allocation)
-    // char buffer[128];
-    // size_t bytes_read = SharedDependencies::bleHandler->receive(buffer, sizeof(buffer));
-    // if (bytes_read > 0) { /* process buffer */ }
+void on_ble_connection_changed(bool connected, void *context)
+{
+    // A frame cut by the previous link must not prefix the first command of the next one
+    SharedDependencies::commandChannel->reset();
+}
 
-    if (received.length() > 0) {
-        Serial << "[BLE Data] Received: " << received << endl;
+bool on_beacon_seen(const BluetoothLE::BLEDevice &device, void *context)
+{
+    const BluetoothLE::TrackedBeacon *beacon = nullptr;
+    const uint32_t now = millis();
+    // A tag advertising its measured power is judged on the distance, not on how loud it transmits
+    const int8_t rssi = BluetoothLE::BeaconRecord::normalise_rssi(device.rssi, device.tx_power);
+    const BluetoothLE::BeaconTransition transition = SharedDependencies::beaconTracker->observe(device.address, rssi, now, &beacon);
+    if (is_known_beacon(device.address, context)) {
+        known_beacon_in_scan = true;  // Keeps the duty cycle at its shortest interval
+    }
+    if (beacon == nullptr || !beacon->present) {
+        return false;
+    }
+    // Beacons of other owners stay in the tracker but never reach the server
+    if (!SharedDependencies::beaconAllowlist->allows(beacon->address)) {
+        return false;
+    }
+    // Every sighting goes into the visit of its beacon, upload_visits() sends them all at once
+    SharedDependencies::visitBuffer->record(beacon->address, rssi, now);
+    // Report a beacon that just arrived, or one that stayed long enough to be reported again
+    if (transition != BluetoothLE::BeaconTransition::Entered && now - beacon->last_reported_ms < BEACON_REPORT_INTERVAL) {
+        return false;
+    }
+    for (uint8_t i = 0; i < due_beacon_count; ++i) {
+        if (due_beacons[i] == beacon->address) {
+            return false;
+        }
+    }
+    if (due_beacon_count < MAX_DUE_BEACONS) {
+        due_beacons[due_beacon_count++] = beacon->address;
+    }
+    return false;  // The queued scan keeps running, report_due_beacons() sends the whole scan once it is over
+}
 
-        // Example: Echo back to the sender
-        SharedDependencies::bleHandler->send("Echo: " + received);
+bool is_known_beacon(const BluetoothLE::MacAddress &address, void *context)
+{
+    // A beacon already at the feeder keeps its scan slot, however crowded the neighbourhood
+    const BluetoothLE::TrackedBeacon *beacon = SharedDependencies::beaconTracker->find(address);
+    if (beacon != nullptr && beacon->present) {
+        return true;
+    }
+    // So does a beacon of the owner, even before it reached the presence threshold
+    return SharedDependencies::beaconAllowlist->contains(address);
+}
 
-        // Example: Handle specific commands
-        if (received.indexOf("STATUS") >= 0) {
-            SharedDependencies::bleHandler->send("Device: " + String(BOARD_NAME) + ", Ready!");
-        } else if (received.indexOf("FEED") >= 0) {
-            Serial << "[Command] Feed command received!" << endl;
-            SharedDependencies::bleHandler->send("Feeding cat...");
-            // TODO: Add your motor control code here
-        } else if (received.indexOf("HELLO") >= 0) {
-            SharedDependencies::bleHandler->send("Hello from " + String(BOARD_NAME) + "!");
-        }
+void on_beacon_scan_done(BluetoothLE::ATCommandResult result, const char *response, size_t length, void *context)
+{
+    if (result != BluetoothLE::ATCommandResult::OK || SharedDependencies::bleHandler->getDeviceCount() == 0) {
+        DebugSerial << "Scan failed or no devices present" << endl;
+    }
+    const uint8_t left = SharedDependencies::beaconTracker->expire(millis());
+    if (left > 0) {
+        DebugSerial << left << " beacon(s) left the feeder" << endl;
     }
+    SharedDependencies::scanDutyCycle->finished(millis(), known_beacon_in_scan);
+    DebugSerial << "Next scan in " << SharedDependencies::scanDutyCycle->next_scan_in_ms(millis()) << " ms" << endl;
 }
 
-void handle_beacons()
+void serve_portion(const Feeder::FeedPortion &portion)
 {
-    Serial << endl << "Scanning to obtain incoming data for " << BLE_PERIODIC_SCAN_DURATION << " ms" << endl;
-    bool scan_status = SharedDependencies::bleHandler->startScan(BLE_PERIODIC_SCAN_DURATION);
-    if (!scan_status) {
-        Serial << "Scan failed or no devices present" << endl;
-        return;
+    DebugSerial << "Distributing " << portion.grams << " g to the beacon " << portion.beacon << endl;
+    // The motors are driven by the feeder task, the loop keeps running while the food falls
+    SharedDependencies::feeder->start(portion.grams, millis());
+}
+
+void report_beacons(const BluetoothLE::MacAddress *beacons, const uint8_t count)
+{
+    // The server orders the pets by how close they are, so each beacon goes with its smoothed RSSI
+    int8_t rssi[MAX_DUE_BEACONS];
+    for (uint8_t i = 0; i < count; ++i) {
+        const BluetoothLE::TrackedBeacon *tracked = SharedDependencies::beaconTracker->find(beacons[i]);
+        rssi[i] = tracked != nullptr ? tracked->rssi() : BLE_MIN_VALID_RSSI_VALUE;
     }
-    uint8_t device_id = 0;
-    uint8_t valid_devices = 0;
-    const BluetoothLE::BLEDevice *devices = SharedDependencies::bleHandler->getScannedDevices();
-    uint8_t count = SharedDependencies::bleHandler->getDeviceCount();
-    for (uint8_t i = 0; i < count; i++) {
-        Serial << "Device " << i << ": " << devices[i].address << endl;
-        if (devices[i].rssi < BLE_MIN_VALID_RSSI_VALUE) {
-            Serial << "The device is to far from the feeder, ignoring" << endl;
-            continue;
-        }
-        Serial << "Sending the server the presence of the beacon" << endl;
-        bool status = HttpServer::ServerEndpoints::Handler::Post::visits(devices[i].address);
-        if (status) {
-            if (valid_devices == 0) {
-                device_id = i;
-            }
-            valid_devices++;
-            Serial << "Server presence of beacon updated" << endl;
-        } else {
-            Serial << "Server presence of beacon failed to update" << endl;
+    DebugSerial << "Sending the server the presence of " << count << " beacon(s)" << endl;
+    bool status = HttpServer::ServerEndpoints::Handler::Post::feed_plan(beacons, rssi, count, *SharedDependencies::feedPlan);
+    const uint32_t now = millis();
+    if (!status) {
+        // The cat is still at the bowl, the decision is asked again after a short back-off rather than a whole report interval
+        DebugSerial << "Server feeding plan failed, the beacons are reported again in " << BEACON_REPORT_RETRY_INTERVAL << " ms" << endl;
+        for (uint8_t i = 0; i < count; ++i) {
+            SharedDependencies::beaconTracker->retry_report(beacons[i], now);
         }
-    }
-    if (valid_devices == 0) {
-        Serial << "No known device is near the feeder, skipping feed check." << endl;
         return;
     }
-    if (valid_devices > 1) {
-        Serial << "More than once device is available, using the first seen device to know if feeding is possible." << endl;
+    for (uint8_t i = 0; i < count; ++i) {
+        SharedDependencies::beaconTracker->mark_reported(beacons[i], now);
     }
-    long long int distributable_amount = -1;
-    bool can_feed = HttpServer::ServerEndpoints::Handler::Get::fed(devices[device_id].address, &distributable_amount);
-    if (!can_feed) {
-        Serial << "The device is not allowed to feed, ending check." << endl;
+}
+
+void start_beacon_scan()
+{
+    const uint32_t window = SharedDependencies::scanDutyCycle->window_ms();
+    DebugSerial << endl << "Scanning to obtain incoming data for " << window << " ms" << endl;
+    // Every sighting goes through the beacon tracker as soon as its line is
+    // parsed, the scan runs from the ble_queue task so the LEDs and the HTTP
+    // server keep being served during the whole discovery window.
+    if (!SharedDependencies::bleHandler->enqueueScan(window, on_beacon_seen, on_beacon_scan_done)) {
+        DebugSerial << "BLE command queue full, scan skipped" << endl;
         return;
     }
-    if (distributable_amount <= 0) {
-        Serial << "The device is not allowed food, can distribute is below or equal to 0, distributable_amount value " << distributable_amount << endl;
+    known_beacon_in_scan = false;
+    SharedDependencies::scanDutyCycle->started(millis());
+}
+
+void report_due_beacons()
+{
+    if (SharedDependencies::feeder->is_busy()) {
         return;
     }
-    if (distributable_amount > MAX_FEEDING_SINGLE_PORTION) {
-        Serial << "Can distribute more than the single portion, clamping to single portion so other portions can still be given during the day." << endl;
-        distributable_amount = MAX_FEEDING_SINGLE_PORTION;
-    }
-    bool feed_update = HttpServer::ServerEndpoints::Handler::Post::fed(devices[device_id].address, distributable_amount);
-    if (feed_update) {
-        Serial << "Server feeding update successfully sent, distributing." << endl;
-    } else {
-        Serial << "Failed to send the server update about feeding, skipping distribution." << endl;
+    // The portions of the latest plan go out one at a time, each once the previous feed is over
+    Feeder::FeedPortion portion;
+    if (SharedDependencies::feedPlan->next(portion)) {
+        serve_portion(portion);
         return;
     }
-    Serial << "Dispensing food" << endl;
-    Serial << "Closing tray" << endl;
-    SharedDependencies::leftMotor->turn_right_degrees(90);
-    Serial << "Opening food trap" << endl;
-    SharedDependencies::rightMotor->turn_left_degrees(90);
-    unsigned long now_start = millis();
-    unsigned long current = (millis() - now_start);
-    while (current <= distributable_amount) {
-        current = (millis() - now_start);
-        if (current % 10 == 0) {
-            Serial << "Dispensing food to tray" << endl;
-        }
+    // One server round-trip per scan, sent once its window closed so every beacon it saw is in
+    if (due_beacon_count == 0 || SharedDependencies::scanDutyCycle->running()) {
+        return;
     }
-    Serial << "Food dispensed to tray, closing trap" << endl;
-    SharedDependencies::rightMotor->turn_right_degrees(90);
-    Serial << "Trap closed, opening tray" << endl;
-    SharedDependencies::leftMotor->turn_left_degrees(90);
-    Serial << "Tray opened, Bon appetit" << endl;
+    report_beacons(due_beacons, due_beacon_count);
+    due_beacon_count = 0;
 }
 
-void loop()
+void service_ble_queue()
 {
-    unsigned long now = millis();
-    static unsigned long last_led_render = 0;
+    SharedDependencies::bleHandler->service();
+}
 
+void monitor_ble_connection()
+{
     // Monitor BLE connection status (detects connect/disconnect events)
     SharedDependencies::bleHandler->monitorConnection();
+}
 
-    // Handle incoming BLE data from connected devices (non-AT commands)
-    // handle_ble_data();
+void serve_http_clients()
+{
+    SharedDependencies::webServer->handleClient();
+}
 
-    // LED updates every 100ms
-    if (now - last_led_render >= LED_RENDER_INTERVAL) {
-        last_led_render = now;
-        MyUtils::ActiveComponents::Panel::tick();
-        MyUtils::ActiveComponents::Panel::render();
-    }
+void render_leds()
+{
+    MyUtils::ActiveComponents::Panel::tick();
+    MyUtils::ActiveComponents::Panel::render();
+}
 
-    if (now - last_ble_status_check >= BLE_STATUS_CHECK_INTERVAL) {
-        if (!SharedDependencies::bleHandler->isConnected()) {
-            Serial << ".";
-            if (SharedDependencies::bleHandler->hasIncomingData()) {
-                handle_beacons();
-            }
-        } else {
-            Serial << "A device is connected to the BLE module" << endl;
+void rest_ble_module(const uint32_t now)
+{
+    if (!BLE_SLEEP_BETWEEN_SCANS || SharedDependencies::scanDutyCycle->running()) {
+        return;
+    }
+    // The task only runs every BLE_SCAN_TICK_INTERVAL, the wake-up must land before the tick that starts the window
+    const uint32_t next_scan = SharedDependencies::scanDutyCycle->next_scan_in_ms(now);
+    const uint32_t lead = SharedDependencies::bleHandler->getWakeLeadMs() + BLE_SCAN_TICK_INTERVAL;
+    if (SharedDependencies::bleHandler->isAsleep()) {
+        if (next_scan <= lead) {
+            SharedDependencies::bleHandler->wake();
         }
+        return;
+    }
+    if (next_scan > lead + BLE_SLEEP_MIN_GAP_MS) {
+        SharedDependencies::bleHandler->sleep();
     }
+}
 
-    // BLE connectivity status check every 10 seconds
-    // if (now - last_ble_status_check >= BLE_STATUS_CHECK_INTERVAL) {
-    //     last_ble_status_check = now;
-    //     Serial << "\n--- BLE Connectivity Check ---" << endl;
-    //     SharedDependencies::bleHandler->printConnectionStatus();
-    // }
-
-        // BLE periodic scanning (handled by refresh_ble_scan with BLE_SCAN_INTERVAL)
-        // refresh_ble_scan();
-
-    // Inform server
-    if (now - last_sign_of_life >= SIGNS_OF_LIFE_INTERVAL) {
-        last_sign_of_life = now;
-        bool broadcast_status = HttpServer::ServerEndpoints::Handler::Put::ip();
-        if (broadcast_status) {
-            Serial << "Sign of life provided successfully" << endl;
-        } else {
-            Serial << "Failed to provide a sign of life to the server, is it down?" << endl;
-        }
+void run_scan_duty_cycle()
+{
+    if (SharedDependencies::bleHandler->isConnected()) {
+        return;  // A connected central owns the module, scanning would drop it
+    }
+    const uint32_t now = millis();
+    if (!SharedDependencies::scanDutyCycle->due(now)) {
+        rest_ble_module(now);  // Between two windows
+        return;
+    }
+    if (SharedDependencies::bleHandler->isQueueBusy()) {
+        return;  // A command is still running
     }
+    start_beacon_scan();
+}
 
-    // Onboard LED blinker
-    onboard_blinker();
-    // LED::led_set_led_position(5, LED::green_colour, LED_DURATION, true);
-    // LED::led_set_led_position(10, LED::led_get_colour_from_pointer(&LED::Colours::Aqua), LED_DURATION, true);
-    // LED::led_set_colour(LED::blue_colour, LED_DURATION, 15, LED::black_colour);
-    // LED::led_set_colour(LED::led_get_colour_from_pointer(&LED::Colours::Magenta), LED_DURATION, 20, LED::led_get_colour_from_pointer(&LED::Colours::Black));
-    SharedDependencies::webServer->handleClient();
-    // quick repro in loop()
+void give_sign_of_life()
+{
+    bool broadcast_status = HttpServer::ServerEndpoints::Handler::Put::ip();
+    if (broadcast_status) {
+        DebugSerial << "Sign of life provided successfully" << endl;
+    } else {
+        DebugSerial << "Failed to provide a sign of life to the server, is it down?" << endl;
+    }
+}
+
+void sync_beacon_allowlist()
+{
+    HttpServer::ServerEndpoints::Handler::Get::beacons(*SharedDependencies::beaconAllowlist);
+}
+
+void upload_visits()
+{
+    // Like the feeding decisions, the round-trip waits for the motors and the scan window
+    if (SharedDependencies::feeder->is_busy() || SharedDependencies::scanDutyCycle->running()) {
+        return;
+    }
+    if (SharedDependencies::visitBuffer->due(millis())) {
+        HttpServer::ServerEndpoints::Handler::Post::visit_batch(*SharedDependencies::visitBuffer);
+    }
+}
+
+void tick_feeder()
+{
+    SharedDependencies::feeder->tick(millis());
+}
+
+void print_scheduler_stats()
+{
+    MyUtils::Scheduler::TaskScheduler::print_stats();
+}
+
+void register_tasks()
+{
+    using MyUtils::Scheduler::TaskPriority;
+    using MyUtils::Scheduler::TaskScheduler;
+
+    TaskScheduler::add("ble_monitor", monitor_ble_connection, BLE_STATE_SAMPLE_INTERVAL, TASK_DEADLINE_BLE_MONITOR, TaskPriority::Critical);
+    TaskScheduler::add("http_server", serve_http_clients, 0, TASK_DEADLINE_HTTP_SERVER, TaskPriority::Critical);
+    TaskScheduler::add("ble_queue", service_ble_queue, 0, TASK_DEADLINE_BLE_QUEUE, TaskPriority::Critical);
+    TaskScheduler::add("feeder", tick_feeder, FEEDER_TICK_INTERVAL, TASK_DEADLINE_FEEDER, TaskPriority::High);
+    TaskScheduler::add("led_render", render_leds, LED_RENDER_INTERVAL, TASK_DEADLINE_LED_RENDER, TaskPriority::High);
+    TaskScheduler::add("ble_scan", run_scan_duty_cycle, BLE_SCAN_TICK_INTERVAL, TASK_DEADLINE_BLE_SCAN, TaskPriority::Normal);
+    TaskScheduler::add("beacon_reports", report_due_beacons, 0, TASK_DEADLINE_BEACON_REPORTS, TaskPriority::Normal);
+    TaskScheduler::add("sign_of_life", give_sign_of_life, SIGNS_OF_LIFE_INTERVAL, TASK_DEADLINE_SIGN_OF_LIFE, TaskPriority::Low);
+    TaskScheduler::add("allowlist_sync", sync_beacon_allowlist, BEACON_ALLOWLIST_SYNC_INTERVAL, TASK_DEADLINE_ALLOWLIST_SYNC, TaskPriority::Low);
+    TaskScheduler::add("visit_upload", upload_visits, VISIT_FLUSH_CHECK_INTERVAL, TASK_DEADLINE_VISIT_FLUSH, TaskPriority::Low);
+#ifndef BLE_USE_HARDWARE_UART
+    // The onboard LED pin carries the logs (UART1 TX) when the BLE module owns UART0
+    blinker_task = TaskScheduler::add("blinker", onboard_blinker, blinkInterval, TASK_DEADLINE_BLINKER, TaskPriority::Low);
+#endif
+    TaskScheduler::add("sched_stats", print_scheduler_stats, SCHEDULER_STATS_INTERVAL, 0, TaskPriority::Low);
+
+    // Framed commands from a paired phone (non-AT commands)
+    TaskScheduler::add("ble_data", handle_ble_data, 0, TASK_DEADLINE_BLE_COMMANDS, TaskPriority::High);
+
+    // BLE periodic scanning (refresh_ble_scan already throttles itself with BLE_SCAN_INTERVAL)
+    // TaskScheduler::add("ble_scan", refresh_ble_scan, 0, 0, TaskPriority::Normal);
+}
+
+void loop()
+{
+    MyUtils::Metrics::LoopMetrics::begin_pass();
+    // Every periodic job is a scheduler task, see register_tasks()
+    MyUtils::Scheduler::TaskScheduler::run();
     increment_iteration();
+    MyUtils::Metrics::LoopMetrics::end_pass();
 }
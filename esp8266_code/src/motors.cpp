@@ -33,24 +33,24 @@ Motors::Motor::Motor(const uint8_t motor_pin, LED::ColourPos *led_items, const i
 
 void Motors::Motor::init()
 {
-    Serial << "Initializing motor on pin " << _pin << endl;
+    DebugSerial << "Initializing motor on pin " << _pin << endl;
     LED::led_fancy(_leds, _leds_length, _background, 100);
     uint32_t free_heap = ESP.getFreeHeap();
     uint8_t fragmented_heap = ESP.getHeapFragmentation();
-    Serial << "Heap before: " << free_heap << " frag:" << fragmented_heap << endl;
+    DebugSerial << "Heap before: " << free_heap << " frag:" << fragmented_heap << endl;
     // Do not attach servo here: attach on-demand in set_speed() to avoid
     // keeping multiple servo timers active simultaneously which can
     // interfere with timing-critical LED updates on ESP8266.
-    Serial << "(servo attach deferred until first movement)" << endl;
+    DebugSerial << "(servo attach deferred until first movement)" << endl;
     // Quick attach/detach validation to ensure the servo can be controlled
     // without leaving the timer running. This briefly exercises the driver
     // while keeping it detached for normal operation.
-    Serial << "Validating servo attach/detach on pin " << _pin << endl;
+    DebugSerial << "Validating servo attach/detach on pin " << _pin << endl;
     _servo.attach(_pin);
     delay(5);
     stop();
     _servo.detach();
-    Serial << "Servo attach/detach validation complete" << endl;
+    DebugSerial << "Servo attach/detach validation complete" << endl;
     // Ensure motor is stopped (will attach/detach when used)
     MyUtils::ActiveComponents::Panel::enable(_component);
 }
@@ -121,6 +121,26 @@ void Motors::Motor::turn_right_degrees(float degrees)
     MyUtils::ActiveComponents::Panel::activity(_component, false);
 }
 
+unsigned long Motors::Motor::begin_turn_left_degrees(float degrees)
+{
+    MyUtils::ActiveComponents::Panel::activity(_component, true);
+    set_speed(-100);
+    return static_cast<unsigned long>(degrees_to_delay(-100, degrees));
+}
+
+unsigned long Motors::Motor::begin_turn_right_degrees(float degrees)
+{
+    MyUtils::ActiveComponents::Panel::activity(_component, true);
+    set_speed(100);
+    return static_cast<unsigned long>(degrees_to_delay(100, degrees));
+}
+
+void Motors::Motor::end_turn()
+{
+    stop();
+    MyUtils::ActiveComponents::Panel::activity(_component, false);
+}
+
 float Motors::Motor::degrees_to_delay(int8_t speed, float degrees) const
 {
     // speed: -100 .. 100
@@ -144,39 +164,39 @@ void Motors::Motor::calibrate()
 {
     _test_mode = true;
     _calibration_step = 0;
-    Serial << "Calibrating motor on pin " << _pin << endl;
+    DebugSerial << "Calibrating motor on pin " << _pin << endl;
     LED::led_fancy(_leds, _leds_length, _background, 100);
 
-    Serial << " - Setting to max speed" << endl;
+    DebugSerial << " - Setting to max speed" << endl;
     set_speed(_min_speed);
     delay(MOTOR_SPEED_DEFAULT);
     _increment_calibration_step();
 
-    Serial << " - Setting to min speed" << endl;
+    DebugSerial << " - Setting to min speed" << endl;
     set_speed(_max_speed);
     delay(MOTOR_SPEED_DEFAULT);
     _increment_calibration_step();
 
-    Serial << " - turning left for " << MOTOR_SPEED_DEFAULT << " second" << endl;
+    DebugSerial << " - turning left for " << MOTOR_SPEED_DEFAULT << " second" << endl;
     turn_left(MOTOR_SPEED_DEFAULT);
     _increment_calibration_step();
 
-    Serial << " - turning right for " << MOTOR_SPEED_DEFAULT << " second" << endl;
+    DebugSerial << " - turning right for " << MOTOR_SPEED_DEFAULT << " second" << endl;
     turn_right(MOTOR_SPEED_DEFAULT);
     _increment_calibration_step();
 
-    Serial << " - turning left for 90°" << endl;
+    DebugSerial << " - turning left for 90°" << endl;
     turn_left_degrees(90);
     _increment_calibration_step();
 
-    Serial << " - turning right for 90°" << endl;
+    DebugSerial << " - turning right for 90°" << endl;
     turn_right_degrees(90);
     _increment_calibration_step();
 
-    Serial << " - Stopping motor" << endl;
+    DebugSerial << " - Stopping motor" << endl;
     stop();
     _increment_calibration_step();
-    Serial << "Motor calibration complete" << endl;
+    DebugSerial << "Motor calibration complete" << endl;
     _test_mode = false;
 }
 
@@ -63,5 +63,5 @@ void send_ip_to_ntfy()
   int httpCode = SharedDependencies::webClient->POST((uint8_t *)message, strlen(message));
   SharedDependencies::webClient->end();
 
-  Serial << "ntfy POST result: " << httpCode << endl;
+  DebugSerial << "ntfy POST result: " << httpCode << endl;
 }
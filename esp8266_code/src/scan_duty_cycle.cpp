@@ -0,0 +1,163 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: scan_duty_cycle.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the scheduler deciding when the bluetooth module scans and for how long.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "scan_duty_cycle.hpp"
+
+BluetoothLE::ScanDutyCycle::ScanDutyCycle(const uint32_t window_ms, const uint32_t min_interval_ms, const uint32_t max_interval_ms, const ScanMode mode)
+    : _window_ms(window_ms), _min_interval_ms(min_interval_ms), _max_interval_ms(max_interval_ms), _interval_ms(min_interval_ms), _mode(mode)
+{
+}
+
+/**
+ * @brief Change the duty cycle at runtime, the interval restarts from its minimum.
+ *
+ * @param window_ms Discovery time of one scan
+ * @param min_interval_ms Start-to-start time while known beacons are around (the only interval in Fixed mode)
+ * @param max_interval_ms Ceiling of the adaptive back-off
+ * @param mode Fixed or Adaptive
+ * @return true The setting was applied
+ * @return false The setting was rejected, the previous one stays
+ */
+bool BluetoothLE::ScanDutyCycle::configure(const uint32_t window_ms, const uint32_t min_interval_ms, const uint32_t max_interval_ms, const ScanMode mode)
+{
+    if (window_ms == 0 || window_ms > min_interval_ms || min_interval_ms > max_interval_ms) {
+        return false;
+    }
+    _window_ms = window_ms;
+    _min_interval_ms = min_interval_ms;
+    _max_interval_ms = max_interval_ms;
+    _interval_ms = min_interval_ms;
+    _mode = mode;
+    return true;
+}
+
+bool BluetoothLE::ScanDutyCycle::due(const uint32_t now_ms) const
+{
+    if (_running) {
+        return false;
+    }
+    return !_ever_started || now_ms - _last_start_ms >= _interval_ms;
+}
+
+void BluetoothLE::ScanDutyCycle::started(const uint32_t now_ms)
+{
+    if (_ever_started && now_ms - _last_start_ms > _stats.longest_gap_ms) {
+        _stats.longest_gap_ms = now_ms - _last_start_ms;
+    }
+    _ever_started = true;
+    _running = true;
+    _last_start_ms = now_ms;
+}
+
+void BluetoothLE::ScanDutyCycle::finished(const uint32_t now_ms, const bool known_seen)
+{
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    _stats.scans++;
+    _stats.radio_ms += now_ms - _last_start_ms;
+    if (known_seen) {
+        _stats.active_scans++;
+        _known_ever = true;
+        _last_known_ms = now_ms;
+    }
+    if (_mode == ScanMode::Fixed) {
+        return;
+    }
+    if (known_seen || (_known_ever && now_ms - _last_known_ms < BLE_SCAN_ACTIVE_HOLD_MS)) {
+        _interval_ms = _min_interval_ms;
+        return;
+    }
+    if (_interval_ms < _max_interval_ms) {
+        _interval_ms = (_interval_ms > _max_interval_ms / 2) ? _max_interval_ms : _interval_ms * 2;
+        _stats.backoffs++;
+    }
+}
+
+bool BluetoothLE::ScanDutyCycle::running() const
+{
+    return _running;
+}
+
+uint32_t BluetoothLE::ScanDutyCycle::window_ms() const
+{
+    return _window_ms;
+}
+
+uint32_t BluetoothLE::ScanDutyCycle::interval_ms() const
+{
+    return _interval_ms;
+}
+
+uint32_t BluetoothLE::ScanDutyCycle::min_interval_ms() const
+{
+    return _min_interval_ms;
+}
+
+uint32_t BluetoothLE::ScanDutyCycle::max_interval_ms() const
+{
+    return _max_interval_ms;
+}
+
+BluetoothLE::ScanMode BluetoothLE::ScanDutyCycle::mode() const
+{
+    return _mode;
+}
+
+uint32_t BluetoothLE::ScanDutyCycle::next_scan_in_ms(const uint32_t now_ms) const
+{
+    if (_running || due(now_ms)) {
+        return 0;
+    }
+    return _interval_ms - (now_ms - _last_start_ms);
+}
+
+uint16_t BluetoothLE::ScanDutyCycle::duty_permille() const
+{
+    return static_cast<uint16_t>((static_cast<uint64_t>(_window_ms) * 1000ULL) / _interval_ms);
+}
+
+uint32_t BluetoothLE::ScanDutyCycle::radio_ms_per_hour() const
+{
+    const uint32_t uptime_ms = millis();
+    if (uptime_ms == 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>((static_cast<uint64_t>(_stats.radio_ms) * 3600000ULL) / uptime_ms);
+}
+
+const BluetoothLE::ScanDutyCycleStats &BluetoothLE::ScanDutyCycle::stats() const
+{
+    return _stats;
+}
+
+void BluetoothLE::ScanDutyCycle::print() const
+{
+    DebugSerial << "========== Scan Duty Cycle ==========" << endl;
+    DebugSerial << "Mode: " << (_mode == ScanMode::Adaptive ? "adaptive" : "fixed") << ", window " << _window_ms << " ms every " << _interval_ms << " ms";
+    DebugSerial << " (" << _min_interval_ms << "-" << _max_interval_ms << " ms), duty " << duty_permille() << " permille" << endl;
+    DebugSerial << "Scans: " << _stats.scans << " (" << _stats.active_scans << " with a known beacon), backoffs: " << _stats.backoffs << endl;
+    DebugSerial << "Radio: " << _stats.radio_ms << " ms, " << radio_ms_per_hour() << " ms/h, longest gap " << _stats.longest_gap_ms << " ms" << endl;
+    DebugSerial << "=====================================" << endl;
+}
@@ -26,7 +26,10 @@
 #include "server.hpp"
 #include "config.hpp"
 #include "ble_handler.hpp"
+#include "loop_metrics.hpp"
+#include "beacon_tracker.hpp"
 #include "my_overloads.hpp"
+#include "task_scheduler.hpp"
 #include "server_control_endpoints.hpp"
 
 namespace HttpServer
@@ -53,8 +56,186 @@ namespace HttpServer
         String response;
         serializeJson(doc, response);
 
-        Serial << "Info requested: '" << response << "'" << endl;
-        MyUtils::ActiveComponents::Panel::data_transmission(blinkIntervalComponent, 5);
+        DebugSerial << "Info requested: '" << response << "'" << endl;
+        MyUtils::ActiveComponents::Panel::traffic(blinkIntervalComponent, response.length());
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        server->send(200, "application/json", response);
+    }
+
+    void handleMetrics()
+    {
+        using MyUtils::Metrics::LoopMetrics;
+        using MyUtils::Scheduler::TaskScheduler;
+
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
+        StaticJsonDocument<2048> doc;
+
+        JsonObject loop_stats = doc["loop"].to<JsonObject>();
+        loop_stats["count"] = LoopMetrics::count();
+        loop_stats["max_us"] = LoopMetrics::max_us();
+        loop_stats["last_us"] = LoopMetrics::last_us();
+        loop_stats["mean_us"] = (LoopMetrics::count() > 0) ? LoopMetrics::total_us() / LoopMetrics::count() : 0;
+        // buckets[i] counts the passes shorter than upper_us[i] (and not shorter than upper_us[i - 1])
+        JsonArray upper = loop_stats["upper_us"].to<JsonArray>();
+        JsonArray buckets = loop_stats["buckets"].to<JsonArray>();
+        for (uint8_t i = 0; i < LoopMetrics::bucket_count(); ++i) {
+            upper.add(LoopMetrics::bucket_upper_us(i));
+            buckets.add(LoopMetrics::bucket(i));
+        }
+
+        // Per-task worst cases tell which job caused a slow pass
+        JsonArray tasks = doc["tasks"].to<JsonArray>();
+        for (uint8_t i = 0; i < TaskScheduler::count(); ++i) {
+            const MyUtils::Scheduler::Task *task = TaskScheduler::get(i);
+            JsonObject entry = tasks.add<JsonObject>();
+            entry["name"] = task->name;
+            entry["runs"] = task->stats.run_count;
+            entry["worst_run_us"] = task->stats.worst_run_us;
+            entry["overruns"] = task->stats.overrun_count;
+        }
+
+        // Time lost flipping the BLE module between scanning and advertising
+        const BluetoothLE::RoleChurnStats &churn = SharedDependencies::bleHandler->getRoleChurnStats();
+        JsonObject ble_role = doc["ble_role"].to<JsonObject>();
+        ble_role["queries"] = churn.queries;
+        ble_role["switches"] = churn.switches;
+        ble_role["cache_hits"] = churn.cache_hits;
+        ble_role["churn_ms"] = churn.churn_ms;
+        ble_role["churn_ms_per_hour"] = SharedDependencies::bleHandler->getRoleChurnMsPerHour();
+
+        const BluetoothLE::ConnectionStateStats &link = SharedDependencies::bleHandler->getConnectionStats();
+        JsonObject ble_link = doc["ble_link"].to<JsonObject>();
+        ble_link["connected"] = SharedDependencies::bleHandler->isConnected();
+        ble_link["level"] = link.last_level;
+        ble_link["samples"] = link.samples;
+        ble_link["rate_limited"] = link.rate_limited;
+        ble_link["changes"] = link.changes;
+
+        // Radio-on time, compare it between units running with and without BLE_SLEEP_BETWEEN_SCANS
+        const BluetoothLE::ModuleSleepStats &rest = SharedDependencies::bleHandler->getSleepStats();
+        JsonObject ble_sleep = doc["ble_sleep"].to<JsonObject>();
+        ble_sleep["asleep"] = SharedDependencies::bleHandler->isAsleep();
+        ble_sleep["sleeps"] = rest.sleeps;
+        ble_sleep["refused"] = rest.refused;
+        ble_sleep["wakes"] = rest.wakes;
+        ble_sleep["wake_timeouts"] = rest.wake_timeouts;
+        ble_sleep["last_wake_ms"] = rest.last_wake_ms;
+        ble_sleep["worst_wake_ms"] = rest.worst_wake_ms;
+        ble_sleep["radio_on_ms_per_hour"] = SharedDependencies::bleHandler->getRadioOnMsPerHour();
+
+        const BluetoothLE::ScanRetentionStats &retention = SharedDependencies::bleHandler->getRetentionStats();
+        JsonObject ble_scan = doc["ble_scan"].to<JsonObject>();
+        ble_scan["devices"] = SharedDependencies::bleHandler->getDeviceCount();
+        ble_scan["overflow"] = SharedDependencies::bleHandler->getOverflowCount();
+        ble_scan["weakest_kept_rssi"] = SharedDependencies::bleHandler->getWeakestKeptRssi();
+        ble_scan["evicted"] = retention.evicted;
+        ble_scan["rejected"] = retention.rejected;
+        ble_scan["known_kept"] = retention.known_kept;
+        ble_scan["known_dropped"] = retention.known_dropped;
+        ble_scan["identity_filtered"] = retention.identity_filtered;
+        ble_scan["discovery"] = (SharedDependencies::bleHandler->getDiscoveryMode() == BluetoothLE::DiscoveryMode::Advertisement) ? "advertisement" : "names";
+
+        const BluetoothLE::ATQueueStats &queue = SharedDependencies::bleHandler->getQueueStats();
+        JsonObject ble_queue = doc["ble_queue"].to<JsonObject>();
+        ble_queue["depth"] = SharedDependencies::bleHandler->getQueueDepth();
+        ble_queue["max_depth"] = queue.max_depth;
+        ble_queue["enqueued"] = queue.enqueued;
+        ble_queue["rejected"] = queue.rejected;
+        ble_queue["completed"] = queue.completed;
+        ble_queue["timeouts"] = queue.timeouts;
+        ble_queue["errors"] = queue.errors;
+        ble_queue["longest_slice_us"] = queue.longest_slice_us;
+
+        const BluetoothLE::BeaconTrackerStats &tracker = SharedDependencies::beaconTracker->stats();
+        JsonObject beacons = doc["beacons"].to<JsonObject>();
+        beacons["tracked"] = SharedDependencies::beaconTracker->count();
+        beacons["present"] = SharedDependencies::beaconTracker->present_count();
+        beacons["entered"] = tracker.entered;
+        beacons["left"] = tracker.left;
+        beacons["dropped"] = tracker.dropped;
+
+        // Sightings kept off the network by the owner's beacon list
+        const BluetoothLE::BeaconAllowlistStats &filter = SharedDependencies::beaconAllowlist->stats();
+        JsonObject allowlist = doc["allowlist"].to<JsonObject>();
+        allowlist["synced"] = SharedDependencies::beaconAllowlist->synced();
+        allowlist["version"] = SharedDependencies::beaconAllowlist->version();
+        allowlist["count"] = SharedDependencies::beaconAllowlist->count();
+        allowlist["syncs"] = filter.syncs;
+        allowlist["not_modified"] = filter.not_modified;
+        allowlist["failures"] = filter.failures;
+        allowlist["truncated"] = filter.truncated;
+        allowlist["allowed"] = filter.allowed;
+        allowlist["filtered"] = filter.filtered;
+
+        const BluetoothLE::ScanDutyCycleStats &duty = SharedDependencies::scanDutyCycle->stats();
+        JsonObject ble_duty = doc["ble_duty"].to<JsonObject>();
+        ble_duty["adaptive"] = SharedDependencies::scanDutyCycle->mode() == BluetoothLE::ScanMode::Adaptive;
+        ble_duty["window_ms"] = SharedDependencies::scanDutyCycle->window_ms();
+        ble_duty["interval_ms"] = SharedDependencies::scanDutyCycle->interval_ms();
+        ble_duty["duty_permille"] = SharedDependencies::scanDutyCycle->duty_permille();
+        ble_duty["scans"] = duty.scans;
+        ble_duty["active_scans"] = duty.active_scans;
+        ble_duty["backoffs"] = duty.backoffs;
+        ble_duty["radio_ms"] = duty.radio_ms;
+        ble_duty["radio_ms_per_hour"] = SharedDependencies::scanDutyCycle->radio_ms_per_hour();
+        ble_duty["longest_gap_ms"] = duty.longest_gap_ms;
+
+        const BluetoothLE::Protocol::CommandStats &commands = SharedDependencies::commandChannel->stats();
+        JsonObject ble_commands = doc["ble_commands"].to<JsonObject>();
+        ble_commands["frames"] = commands.frames;
+        ble_commands["rejected"] = commands.rejected;
+        ble_commands["bad_checksum"] = commands.bad_checksum;
+        ble_commands["stray_bytes"] = commands.stray_bytes;
+        ble_commands["timeouts"] = commands.timeouts;
+        ble_commands["worst_dispatch_us"] = commands.worst_dispatch_us;
+
+        // Batched feeding decisions, one round-trip per scan whatever the number of pets
+        const Feeder::FeedPlanStats &plan = SharedDependencies::feedPlan->stats();
+        JsonObject feed_plan = doc["feed_plan"].to<JsonObject>();
+        feed_plan["pending"] = SharedDependencies::feedPlan->pending();
+        feed_plan["requests"] = plan.requests;
+        feed_plan["failures"] = plan.failures;
+        feed_plan["beacons"] = plan.beacons;
+        feed_plan["planned"] = plan.planned;
+        feed_plan["served"] = plan.served;
+        feed_plan["dropped"] = plan.dropped;
+        feed_plan["round_trips_saved"] = plan.round_trips_saved;
+
+        // Visits coalesced per beacon, one upload per interval instead of one request per sighting
+        const BluetoothLE::VisitBufferStats &visit_stats = SharedDependencies::visitBuffer->stats();
+        JsonObject visits = doc["visits"].to<JsonObject>();
+        visits["buffered"] = SharedDependencies::visitBuffer->count();
+        visits["sightings"] = visit_stats.sightings;
+        visits["overflows"] = visit_stats.overflows;
+        visits["uploads"] = visit_stats.uploads;
+        visits["failures"] = visit_stats.failures;
+        visits["sent"] = visit_stats.visits;
+        visits["requests_saved"] = visit_stats.requests_saved;
+        visits["requests_saved_per_hour"] = SharedDependencies::visitBuffer->requests_saved_per_hour();
+
+        // Kept-alive connection to the control server
+        const HttpServer::ControlLinkStats &control = SharedDependencies::controlLink->stats();
+        JsonObject control_link = doc["control_link"].to<JsonObject>();
+        control_link["connected"] = SharedDependencies::controlLink->connected();
+        control_link["requests"] = control.requests;
+        control_link["reused"] = control.reused;
+        control_link["connects"] = control.connects;
+        control_link["retries"] = control.retries;
+        control_link["failures"] = control.failures;
+        control_link["idle_closes"] = control.idle_closes;
+        control_link["last_ms"] = control.last_ms;
+        control_link["worst_ms"] = control.worst_ms;
+        control_link["mean_ms"] = SharedDependencies::controlLink->mean_ms();
+        control_link["mean_reused_ms"] = SharedDependencies::controlLink->mean_reused_ms();
+        control_link["mean_connect_ms"] = SharedDependencies::controlLink->mean_connect_ms();
+        doc["uptime_ms"] = millis();
+        doc["heap_free"] = ESP.getFreeHeap();
+
+        String response;
+        serializeJson(doc, response);
+
+        DebugSerial << "Metrics requested (" << response.length() << " bytes)" << endl;
+        MyUtils::ActiveComponents::Panel::traffic(blinkIntervalComponent, response.length());
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
         server->send(200, "application/json", response);
     }
@@ -72,27 +253,78 @@ namespace HttpServer
         DeserializationError err = deserializeJson(doc, server->arg("plain"));
 
         if (err || !doc["interval"].is<unsigned long>()) {
-            Serial << "Failed to parse JSON or missing 'interval'" << endl;
+            DebugSerial << "Failed to parse JSON or missing 'interval'" << endl;
             MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
             server->send(400, "text/plain", "Invalid JSON");
             return;
         }
 
         blinkInterval = doc["interval"];
-        Serial << "Blink interval updated to " << blinkInterval << endl;
+        DebugSerial << "Blink interval updated to " << blinkInterval << endl;
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
         server->send(200, "text/plain", "Blink interval updated");
     }
 
+    void handleScanConfig()
+    {
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
+        if (!server->hasArg("plain")) {
+            MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+            server->send(400, "text/plain", "Missing body");
+            return;
+        }
+
+        StaticJsonDocument<128> doc;
+        DeserializationError err = deserializeJson(doc, server->arg("plain"));
+        if (err) {
+            DebugSerial << "Failed to parse the scan configuration" << endl;
+            MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+            server->send(400, "text/plain", "Invalid JSON");
+            return;
+        }
+
+        // Missing fields keep their current value
+        BluetoothLE::ScanDutyCycle *duty = SharedDependencies::scanDutyCycle;
+        const uint32_t window = doc["window"] | duty->window_ms();
+        const uint32_t min_interval = doc["min_interval"] | duty->min_interval_ms();
+        const uint32_t max_interval = doc["max_interval"] | duty->max_interval_ms();
+        const bool adaptive = doc["adaptive"] | (duty->mode() == BluetoothLE::ScanMode::Adaptive);
+        const char *discovery = doc["discovery"] | "";  // "names" (AT+DISC?) or "advertisement" (AT+DISI?)
+        const bool advertisement = strcmp(discovery, "advertisement") == 0;
+        if (discovery[0] != '\0' && !advertisement && strcmp(discovery, "names") != 0) {
+            MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+            server->send(400, "text/plain", "discovery must be names or advertisement");
+            return;
+        }
+        if (!duty->configure(window, min_interval, max_interval, adaptive ? BluetoothLE::ScanMode::Adaptive : BluetoothLE::ScanMode::Fixed)) {
+            DebugSerial << "Rejected scan configuration: window " << window << ", interval " << min_interval << "-" << max_interval << endl;
+            MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+            server->send(400, "text/plain", "window must not exceed min_interval, min_interval must not exceed max_interval");
+            return;
+        }
+        if (discovery[0] != '\0') {
+            SharedDependencies::bleHandler->setDiscoveryMode(advertisement ? BluetoothLE::DiscoveryMode::Advertisement : BluetoothLE::DiscoveryMode::Names);
+        }
+        DebugSerial << "Scan duty cycle updated" << endl;
+        duty->print();
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        server->send(200, "text/plain", "Scan configuration updated");
+    }
+
     void getBluetoothStatus()
     {
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
         StaticJsonDocument<256> doc;
         doc["bluetooth_connected"] = SharedDependencies::bleHandler->isConnected();
+        // Read from the module info snapshot, answering never waits on the module
+        const BluetoothLE::ModuleInfo &info = SharedDependencies::bleHandler->getModuleInfo();
+        doc["name"] = info.name;
+        doc["address"] = info.address;
+        doc["version"] = info.version;
         String response;
         serializeJson(doc, response);
-        Serial << "Bluetooth status requested: '" << response << "'" << endl;
-        MyUtils::ActiveComponents::Panel::data_transmission(blinkIntervalComponent, 3);
+        DebugSerial << "Bluetooth status requested: '" << response << "'" << endl;
+        MyUtils::ActiveComponents::Panel::traffic(blinkIntervalComponent, response.length());
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
         server->send(200, "application/json", response);
     }
@@ -100,8 +332,8 @@ namespace HttpServer
     void getStatus()
     {
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
-        MyUtils::ActiveComponents::Panel::data_transmission(blinkIntervalComponent, 3);
-        Serial << "Status fetched" << endl;
+        MyUtils::ActiveComponents::Panel::traffic(blinkIntervalComponent, 2);
+        DebugSerial << "Status fetched" << endl;
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
         server->send(200, "text/plain", "OK");
     }
@@ -109,7 +341,9 @@ namespace HttpServer
     void setupServer()
     {
         server->on("/info", HTTP_GET, handleInfo);
+        server->on("/metrics", HTTP_GET, handleMetrics);
         server->on("/blink", HTTP_POST, handleBlink);
+        server->on("/scan", HTTP_POST, handleScanConfig);
         server->on("/bluetooth_status", HTTP_GET, getBluetoothStatus);
         server->on("/", HTTP_GET, getStatus);
         server->begin();
@@ -45,6 +45,23 @@ const char *getCachedMac()
     return mac_buffer;
 }
 
+// Request and reply bytes of a control server round-trip go on the Wi-Fi traffic bar
+static void countWifiTraffic(const size_t sent)
+{
+    const int received = SharedDependencies::webClient->getSize();
+    MyUtils::ActiveComponents::Panel::traffic(Wifi::WIFI_COMPONENT, sent + (received > 0 ? received : 0));
+}
+
+// Account for an snprintf() into body + length, false once the text did not fit in the remaining size
+static bool appended(const int written, size_t &length, const size_t size)
+{
+    if (written < 0 || static_cast<size_t>(written) >= size - length) {
+        return false;
+    }
+    length += static_cast<size_t>(written);
+    return true;
+}
+
 // Helper to get cached IP
 const char *getCachedIp()
 {
@@ -61,19 +78,16 @@ bool HttpServer::ServerEndpoints::Handler::Get::fed(const char *beacon_mac, long
     MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
     char body[256];
     snprintf(body, sizeof(body), "{\"beacon_mac\":\"%s\"}", beacon_mac);
-    WiFiClient client;
-    char url[256];
-    snprintf(url, sizeof(url), "%s%s", CONTROL_SERVER, HttpServer::ServerEndpoints::Url::Get::FED.data());
-    SharedDependencies::webClient->begin(client, url);
-    SharedDependencies::webClient->addHeader("Content-Type", "application/json");
-    int httpCode = SharedDependencies::webClient->sendRequest("GET", body);
+    SharedDependencies::controlLink->begin("GET", HttpServer::ServerEndpoints::Url::Get::FED);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(strlen(body));
     if (httpCode == 200) {
         String response = SharedDependencies::webClient->getString();
         StaticJsonDocument<256> doc;
         DeserializationError err = deserializeJson(doc, response);
-        SharedDependencies::webClient->end();
+        SharedDependencies::controlLink->end();
         if (err) {
-            Serial << "JSON parse error for beacon: " << beacon_mac << endl;
+            DebugSerial << "JSON parse error for beacon: " << beacon_mac << endl;
             return false;
         }
         long long int food_eaten = doc["food_eaten"];
@@ -82,41 +96,112 @@ bool HttpServer::ServerEndpoints::Handler::Get::fed(const char *beacon_mac, long
         *can_distribute = food_max - food_eaten;
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
         if (food_eaten < food_max && can_distribute_check) {
-            Serial << "Can feed beacon: " << beacon_mac << " (eaten " << food_eaten << " < max " << food_max << "), can_distribute " << can_distribute_check << endl;
+            DebugSerial << "Can feed beacon: " << beacon_mac << " (eaten " << food_eaten << " < max " << food_max << "), can_distribute " << can_distribute_check << endl;
             return true;
         } else {
-            Serial << "Cannot feed beacon: " << beacon_mac << " (eaten " << food_eaten << " >= max " << food_max << "), can_distribute " << can_distribute_check << endl;
+            DebugSerial << "Cannot feed beacon: " << beacon_mac << " (eaten " << food_eaten << " >= max " << food_max << "), can_distribute " << can_distribute_check << endl;
             *can_distribute = -1;
             return false;
         }
     } else {
-        SharedDependencies::webClient->end();
+        SharedDependencies::controlLink->end();
         MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
-        Serial << "GET fed failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
+        DebugSerial << "GET fed failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
         *can_distribute = -1;
         return false;
     }
 }
 
+bool HttpServer::ServerEndpoints::Handler::Get::beacons(BluetoothLE::BeaconAllowlist &allowlist)
+{
+    MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
+    getCachedMac();
+    char body[64];
+    snprintf(body, sizeof(body), "{\"feeder_mac\":\"%s\"}", mac_buffer);
+    SharedDependencies::controlLink->begin("GET", HttpServer::ServerEndpoints::Url::Get::BEACONS);
+    if (allowlist.synced()) {
+        SharedDependencies::webClient->addHeader("If-None-Match", allowlist.version());
+    }
+    const char *collected[] = { "ETag" };
+    SharedDependencies::webClient->collectHeaders(collected, 1);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(strlen(body));
+    if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        SharedDependencies::controlLink->end();
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        allowlist.confirm();
+        DebugSerial << "Beacon allowlist unchanged (" << allowlist.version() << ")" << endl;
+        return true;
+    }
+    if (httpCode != 200) {
+        SharedDependencies::controlLink->end();
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        allowlist.record_failure();
+        DebugSerial << "GET beacons failed code: " << httpCode << endl;
+        return false;
+    }
+    String response = SharedDependencies::webClient->getString();
+    String etag = SharedDependencies::webClient->header("ETag");
+    SharedDependencies::controlLink->end();
+
+    // Only the address list is kept, the rest of the boilerplate is skipped while parsing
+    JsonDocument filter;
+    filter["resp"]["beacons"] = true;
+    filter["resp"]["version"] = true;
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, response, DeserializationOption::Filter(filter));
+    JsonArray listed = doc["resp"]["beacons"];
+    if (err || listed.isNull()) {
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        allowlist.record_failure();
+        DebugSerial << "JSON parse error for the beacon allowlist" << endl;
+        return false;
+    }
+    if (etag.length() == 0) {
+        const char *version = doc["resp"]["version"] | "";
+        etag = version;
+    }
+
+    BluetoothLE::MacAddress addresses[BEACON_ALLOWLIST_CAPACITY];
+    uint8_t count = 0;
+    uint32_t received = 0;
+    for (JsonVariant entry : listed) {
+        const char *hex = entry | "";
+        BluetoothLE::MacAddress address;
+        if (!address.parse(hex, strlen(hex))) {
+            DebugSerial << "Skipping malformed allowlist entry: " << hex << endl;
+            continue;
+        }
+        received++;
+        if (count < BEACON_ALLOWLIST_CAPACITY) {
+            addresses[count++] = address;
+        }
+    }
+    const bool changed = allowlist.replace(addresses, count, etag.c_str(), received);
+    MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+    DebugSerial << "Beacon allowlist " << (changed ? "updated" : "confirmed") << ": " << allowlist.count() << " beacons, version " << allowlist.version() << endl;
+    if (received > count) {
+        DebugSerial << "Warning: " << (received - count) << " beacons do not fit the allowlist" << endl;
+    }
+    return true;
+}
+
 bool HttpServer::ServerEndpoints::Handler::Post::fed(const char *beacon_mac, const unsigned long food_amount)
 {
     MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
     getCachedMac();
     char body[256];
     snprintf(body, sizeof(body), "{\"beacon_mac\":\"%s\",\"feeder_mac\":\"%s\",\"amount\":%lu}", beacon_mac, mac_buffer, food_amount);
-    WiFiClient client;
-    char url[256];
-    snprintf(url, sizeof(url), "%s%s", CONTROL_SERVER, HttpServer::ServerEndpoints::Url::Post::FED.data());
-    SharedDependencies::webClient->begin(client, url);
-    SharedDependencies::webClient->addHeader("Content-Type", "application/json");
-    int httpCode = SharedDependencies::webClient->POST(body);
-    SharedDependencies::webClient->end();
+    SharedDependencies::controlLink->begin("POST", HttpServer::ServerEndpoints::Url::Post::FED);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(strlen(body));
+    SharedDependencies::controlLink->end();
     MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
     if (httpCode == 200) {
-        Serial << "POST fed successful for beacon: " << beacon_mac << endl;
+        DebugSerial << "POST fed successful for beacon: " << beacon_mac << endl;
         return true;
     } else {
-        Serial << "POST fed failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
+        DebugSerial << "POST fed failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
         return false;
     }
 }
@@ -127,19 +212,16 @@ bool HttpServer::ServerEndpoints::Handler::Post::location(const char *beacon_mac
     getCachedMac();
     char body[256];
     snprintf(body, sizeof(body), "{\"beacon_mac\":\"%s\",\"feeder_mac\":\"%s\"}", beacon_mac, mac_buffer);
-    WiFiClient client;
-    char url[256];
-    snprintf(url, sizeof(url), "%s%s", CONTROL_SERVER, HttpServer::ServerEndpoints::Url::Post::LOCATION.data());
-    SharedDependencies::webClient->begin(client, url);
-    SharedDependencies::webClient->addHeader("Content-Type", "application/json");
-    int httpCode = SharedDependencies::webClient->POST(body);
-    SharedDependencies::webClient->end();
+    SharedDependencies::controlLink->begin("POST", HttpServer::ServerEndpoints::Url::Post::LOCATION);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(strlen(body));
+    SharedDependencies::controlLink->end();
     MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
     if (httpCode == 200) {
-        Serial << "POST location successful for beacon: " << beacon_mac << endl;
+        DebugSerial << "POST location successful for beacon: " << beacon_mac << endl;
         return true;
     } else {
-        Serial << "POST location failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
+        DebugSerial << "POST location failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
         return false;
     }
 }
@@ -151,22 +233,129 @@ visits(const char *beacon_mac)
     getCachedMac();
     char body[256];
     snprintf(body, sizeof(body), "{\"beacon_mac\":\"%s\",\"feeder_mac\":\"%s\"}", beacon_mac, mac_buffer);
-    WiFiClient client;
-    char url[256];
-    snprintf(url, sizeof(url), "%s%s", CONTROL_SERVER, HttpServer::ServerEndpoints::Url::Post::VISITS.data());
-    SharedDependencies::webClient->begin(client, url);
-    SharedDependencies::webClient->addHeader("Content-Type", "application/json");
-    int httpCode = SharedDependencies::webClient->POST(body);
-    SharedDependencies::webClient->end();
+    SharedDependencies::controlLink->begin("POST", HttpServer::ServerEndpoints::Url::Post::VISITS);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(strlen(body));
+    SharedDependencies::controlLink->end();
+    MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+    if (httpCode == 200) {
+        DebugSerial << "POST visits successful for beacon: " << beacon_mac << endl;
+        return true;
+    } else {
+        DebugSerial << "POST visits failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
+        return false;
+    }
+}
+
+bool HttpServer::ServerEndpoints::Handler::Post::visit_batch(BluetoothLE::VisitBuffer &buffer)
+{
+    MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
+    getCachedMac();
+    const uint32_t now = millis();
+    // {"feeder_mac":"AA:BB:CC:DD:EE:FF","visits":[ is 44 bytes, the closing ]} and the null 3 bytes
+    // ,{"mac":"AABBCCDDEEFF","first_ms_ago":4294967295,"last_ms_ago":4294967295,"samples":65535,"rssi":-128} is 102 bytes per visit
+    char body[44 + 102 * VISIT_BUFFER_CAPACITY + 3];
+    size_t length = 0;
+    bool fits = appended(snprintf(body, sizeof(body), "{\"feeder_mac\":\"%s\",\"visits\":[", mac_buffer), length, sizeof(body));
+    const BluetoothLE::BeaconVisit *visits = buffer.visits();
+    for (uint8_t i = 0; fits && i < buffer.count(); ++i) {
+        char hex[BluetoothLE::MacAddress::HEX_LENGTH + 1];
+        visits[i].beacon.to_hex(hex);
+        fits = appended(snprintf(body + length, sizeof(body) - length, "%s{\"mac\":\"%s\",\"first_ms_ago\":%lu,\"last_ms_ago\":%lu,\"samples\":%u,\"rssi\":%d}",
+            i > 0 ? "," : "", hex, static_cast<unsigned long>(now - visits[i].first_seen_ms), static_cast<unsigned long>(now - visits[i].last_seen_ms),
+            visits[i].samples, visits[i].mean_rssi()), length, sizeof(body));
+    }
+    fits = fits && appended(snprintf(body + length, sizeof(body) - length, "]}"), length, sizeof(body));
+    if (!fits) {
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        buffer.record_failure(now);
+        DebugSerial << "POST visit batch skipped, " << buffer.count() << " visits do not fit in " << sizeof(body) << " bytes" << endl;
+        return false;
+    }
+    SharedDependencies::controlLink->begin("POST", HttpServer::ServerEndpoints::Url::Post::VISIT_BATCH);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(length);
+    SharedDependencies::controlLink->end();
     MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+    const uint8_t count = buffer.count();
     if (httpCode == 200) {
-        Serial << "POST visits successful for beacon: " << beacon_mac << endl;
+        buffer.sent(now);
+        DebugSerial << "POST visit batch successful: " << count << " visits" << endl;
         return true;
     } else {
-        Serial << "POST visits failed for beacon: " << beacon_mac << " code: " << httpCode << endl;
+        buffer.record_failure(now);
+        DebugSerial << "POST visit batch failed for " << count << " visits, code: " << httpCode << endl;
+        return false;
+    }
+}
+
+bool HttpServer::ServerEndpoints::Handler::Post::feed_plan(const BluetoothLE::MacAddress *beacons, const int8_t *rssi, const uint8_t count, Feeder::FeedPlan &plan)
+{
+    MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
+    getCachedMac();
+    // {"feeder_mac":"AA:BB:CC:DD:EE:FF","max_portion":65535,"record_visits":false,"beacons":[ is 87 bytes, the closing ]} and the null 3 bytes
+    // ,{"mac":"AABBCCDDEEFF","rssi":-128} is 35 bytes per beacon
+    char body[96 + 36 * MAX_DUE_BEACONS];
+    size_t length = 0;
+    bool fits = appended(snprintf(body, sizeof(body), "{\"feeder_mac\":\"%s\",\"max_portion\":%u,\"record_visits\":false,\"beacons\":[", mac_buffer, MAX_FEEDING_SINGLE_PORTION), length, sizeof(body));
+    for (uint8_t i = 0; fits && i < count && i < MAX_DUE_BEACONS; ++i) {
+        char hex[BluetoothLE::MacAddress::HEX_LENGTH + 1];
+        beacons[i].to_hex(hex);
+        fits = appended(snprintf(body + length, sizeof(body) - length, "%s{\"mac\":\"%s\",\"rssi\":%d}", i > 0 ? "," : "", hex, rssi[i]), length, sizeof(body));
+    }
+    fits = fits && appended(snprintf(body + length, sizeof(body) - length, "]}"), length, sizeof(body));
+    if (!fits) {
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        plan.record_failure();
+        DebugSerial << "POST feed plan skipped, " << count << " beacons do not fit in " << sizeof(body) << " bytes" << endl;
         return false;
     }
+    SharedDependencies::controlLink->begin("POST", HttpServer::ServerEndpoints::Url::Post::FEED_PLAN);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(length);
+    if (httpCode != 200) {
+        SharedDependencies::controlLink->end();
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        plan.record_failure();
+        DebugSerial << "POST feed plan failed for " << count << " beacons, code: " << httpCode << endl;
+        return false;
+    }
+    String response = SharedDependencies::webClient->getString();
+    SharedDependencies::controlLink->end();
+
+    JsonDocument filter;
+    filter["resp"]["portions"][0]["beacon_mac"] = true;
+    filter["resp"]["portions"][0]["amount"] = true;
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, response, DeserializationOption::Filter(filter));
+    JsonArray portions = doc["resp"]["portions"];
+    if (err || portions.isNull()) {
+        MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+        plan.record_failure();
+        DebugSerial << "JSON parse error for the feed plan" << endl;
+        return false;
+    }
+
+    // The server already booked the portions, they are served in the order received
+    plan.begin(count);
+    for (JsonVariant portion : portions) {
+        const char *hex = portion["beacon_mac"] | "";
+        const unsigned long amount = portion["amount"] | 0UL;
+        BluetoothLE::MacAddress address;
+        if (!address.parse(hex, strlen(hex))) {
+            DebugSerial << "Skipping malformed feed plan entry: " << hex << endl;
+            continue;
+        }
+        const uint32_t grams = amount > MAX_FEEDING_SINGLE_PORTION ? MAX_FEEDING_SINGLE_PORTION : amount;
+        if (!plan.add(address, grams) && grams > 0) {
+            DebugSerial << "Feed plan full, dropping the portion of " << hex << endl;
+        }
+    }
+    MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
+    DebugSerial << "POST feed plan successful: " << count << " beacons, " << plan.pending() << " portions to serve" << endl;
+    return true;
 }
+
 bool HttpServer::ServerEndpoints::Handler::Put::ip()
 {
     MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, true);
@@ -174,19 +363,16 @@ bool HttpServer::ServerEndpoints::Handler::Put::ip()
     getCachedIp();
     char body[256];
     snprintf(body, sizeof(body), "{\"mac\":\"%s\",\"ip\":\"%s\"}", mac_buffer, ip_buffer);
-    WiFiClient client;
-    char url[256];
-    snprintf(url, sizeof(url), "%s%s", CONTROL_SERVER, HttpServer::ServerEndpoints::Url::Put::IP.data());
-    SharedDependencies::webClient->begin(client, url);
-    SharedDependencies::webClient->addHeader("Content-Type", "application/json");
-    int httpCode = SharedDependencies::webClient->PUT(body);
-    SharedDependencies::webClient->end();
+    SharedDependencies::controlLink->begin("PUT", HttpServer::ServerEndpoints::Url::Put::IP);
+    int httpCode = SharedDependencies::controlLink->send(body);
+    countWifiTraffic(strlen(body));
+    SharedDependencies::controlLink->end();
     MyUtils::ActiveComponents::Panel::activity(blinkIntervalComponent, false);
     if (httpCode == 200) {
-        Serial << "PUT ip successful" << endl;
+        DebugSerial << "PUT ip successful" << endl;
         return true;
     } else {
-        Serial << "PUT ip failed code: " << httpCode << endl;
+        DebugSerial << "PUT ip failed code: " << httpCode << endl;
         return false;
     }
 }
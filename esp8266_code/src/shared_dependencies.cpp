@@ -29,8 +29,16 @@ static HTTPClient httpClient;
 static ESP8266WebServer webServerInstance(SERVER_PORT);
 
 HTTPClient *SharedDependencies::webClient = &httpClient;
+HttpServer::ControlLink *SharedDependencies::controlLink = nullptr;
 ESP8266WebServer *SharedDependencies::webServer = &webServerInstance;
 Motors::Motor *SharedDependencies::leftMotor = nullptr;
 Motors::Motor *SharedDependencies::rightMotor = nullptr;
+Feeder::FeedingSequence *SharedDependencies::feeder = nullptr;
+Feeder::FeedPlan *SharedDependencies::feedPlan = nullptr;
 Wifi::WifiHandler *SharedDependencies::wifiHandler = nullptr;
 BluetoothLE::BLEHandler *SharedDependencies::bleHandler = nullptr;
+BluetoothLE::BeaconTracker *SharedDependencies::beaconTracker = nullptr;
+BluetoothLE::BeaconAllowlist *SharedDependencies::beaconAllowlist = nullptr;
+BluetoothLE::VisitBuffer *SharedDependencies::visitBuffer = nullptr;
+BluetoothLE::ScanDutyCycle *SharedDependencies::scanDutyCycle = nullptr;
+BluetoothLE::CommandChannel *SharedDependencies::commandChannel = nullptr;
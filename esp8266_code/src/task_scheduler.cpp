@@ -0,0 +1,251 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: task_scheduler.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: This is the implementation of the cooperative task scheduler driven by the main loop.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "task_scheduler.hpp"
+
+MyUtils::Scheduler::Task MyUtils::Scheduler::TaskScheduler::_tasks[MAX_SCHEDULED_TASKS] = {};
+uint8_t MyUtils::Scheduler::TaskScheduler::_task_count = 0;
+
+/**
+ * @brief Register a task in the fixed task table.
+ *
+ * The first release happens one period after registration, tasks with a
+ * period of 0 are released on every pass.
+ *
+ * @param name Static name used in the statistics output
+ * @param callback Function to call when the task is due
+ * @param period_ms Interval between two releases (0 = every pass)
+ * @param deadline_ms Time allowed between release and completion (0 = none)
+ * @param priority Servicing order inside a pass
+ * @return int8_t Task identifier, -1 if the table is full
+ */
+int8_t MyUtils::Scheduler::TaskScheduler::add(const char *name, TaskCallback callback, const uint32_t period_ms, const uint32_t deadline_ms, const TaskPriority priority)
+{
+    if (callback == nullptr) {
+        DebugSerial << "[Scheduler] Refusing task without callback: " << name << endl;
+        return -1;
+    }
+    if (_task_count >= MAX_SCHEDULED_TASKS) {
+        DebugSerial << "[Scheduler] Task table full, cannot add: " << name << " (max " << MAX_SCHEDULED_TASKS << ")" << endl;
+        return -1;
+    }
+
+    Task &task = _tasks[_task_count];
+    task.name = name;
+    task.callback = callback;
+    task.period_ms = period_ms;
+    task.deadline_ms = deadline_ms;
+    task.priority = priority;
+    task.next_run_ms = millis() + period_ms;
+    task.enabled = true;
+    task.stats = TaskStats();
+
+    DebugSerial << "[Scheduler] Task " << _task_count << " '" << name << "' every " << period_ms << " ms (deadline " << deadline_ms << " ms)" << endl;
+    return static_cast<int8_t>(_task_count++);
+}
+
+void MyUtils::Scheduler::TaskScheduler::run()
+{
+    // Walk the priorities from the most to the least urgent so that the
+    // critical tasks are always serviced first within a pass.
+    for (uint8_t level = 0; level < static_cast<uint8_t>(TaskPriority::_COUNT); ++level) {
+        for (uint8_t i = 0; i < _task_count; ++i) {
+            Task &task = _tasks[i];
+            if (static_cast<uint8_t>(task.priority) != level) {
+                continue;
+            }
+            // Sample the clock for each task, the previous ones may have taken a while
+            const uint32_t now = millis();
+            if (!_is_due(task, now)) {
+                continue;
+            }
+            _execute(task, now);
+        }
+    }
+}
+
+void MyUtils::Scheduler::TaskScheduler::enable(const int8_t task_id)
+{
+    if (!_valid(task_id)) {
+        return;
+    }
+    Task &task = _tasks[task_id];
+    if (!task.enabled) {
+        task.enabled = true;
+        task.next_run_ms = millis() + task.period_ms;
+    }
+}
+
+void MyUtils::Scheduler::TaskScheduler::disable(const int8_t task_id)
+{
+    if (!_valid(task_id)) {
+        return;
+    }
+    _tasks[task_id].enabled = false;
+}
+
+void MyUtils::Scheduler::TaskScheduler::set_period(const int8_t task_id, const uint32_t period_ms)
+{
+    if (!_valid(task_id)) {
+        return;
+    }
+    Task &task = _tasks[task_id];
+    if (task.period_ms == period_ms) {
+        return;
+    }
+    // Move the pending release so the new period takes effect right away
+    task.next_run_ms = task.next_run_ms - task.period_ms + period_ms;
+    task.period_ms = period_ms;
+}
+
+uint32_t MyUtils::Scheduler::TaskScheduler::time_until_next_ms()
+{
+    const int8_t task_id = next_task();
+    if (task_id < 0) {
+        return UINT32_MAX_VALUE;
+    }
+    const int32_t remaining = static_cast<int32_t>(_tasks[task_id].next_run_ms - millis());
+    return (remaining > 0) ? static_cast<uint32_t>(remaining) : 0;
+}
+
+int8_t MyUtils::Scheduler::TaskScheduler::next_task()
+{
+    const uint32_t now = millis();
+    int8_t closest = -1;
+    int32_t closest_remaining = INT32_MAX_VALUE;
+    for (uint8_t i = 0; i < _task_count; ++i) {
+        const Task &task = _tasks[i];
+        if (!task.enabled) {
+            continue;
+        }
+        // Signed difference keeps the comparison valid across millis() wrap-around
+        const int32_t remaining = static_cast<int32_t>(task.next_run_ms - now);
+        if (closest < 0 || remaining < closest_remaining ||
+            (remaining == closest_remaining && task.priority < _tasks[closest].priority)) {
+            closest = static_cast<int8_t>(i);
+            closest_remaining = remaining;
+        }
+    }
+    return closest;
+}
+
+const MyUtils::Scheduler::Task *MyUtils::Scheduler::TaskScheduler::get(const int8_t task_id)
+{
+    if (!_valid(task_id)) {
+        return nullptr;
+    }
+    return &_tasks[task_id];
+}
+
+uint8_t MyUtils::Scheduler::TaskScheduler::count()
+{
+    return _task_count;
+}
+
+uint64_t MyUtils::Scheduler::TaskScheduler::total_run_us()
+{
+    uint64_t total = 0;
+    for (uint8_t i = 0; i < _task_count; ++i) {
+        total += _tasks[i].stats.total_run_us;
+    }
+    return total;
+}
+
+void MyUtils::Scheduler::TaskScheduler::reset_stats()
+{
+    for (uint8_t i = 0; i < _task_count; ++i) {
+        _tasks[i].stats = TaskStats();
+    }
+}
+
+void MyUtils::Scheduler::TaskScheduler::print_stats()
+{
+    const uint64_t busy_us = total_run_us();
+    DebugSerial << "========== Scheduler Statistics ==========" << endl;
+    DebugSerial << "Tasks: " << _task_count << "/" << MAX_SCHEDULED_TASKS << ", next release in " << time_until_next_ms() << " ms" << endl;
+    for (uint8_t i = 0; i < _task_count; ++i) {
+        const Task &task = _tasks[i];
+        const TaskStats &stats = task.stats;
+        // Share of the time spent in tasks, in tenths of a percent
+        const uint32_t share = (busy_us > 0) ? static_cast<uint32_t>((stats.total_run_us * 1000) / busy_us) : 0;
+        DebugSerial << "[" << i << "] " << task.name << (task.enabled ? "" : " (disabled)") << endl;
+        DebugSerial << "    runs: " << stats.run_count << ", overruns: " << stats.overrun_count << ", skipped: " << stats.skipped_count << endl;
+        DebugSerial << "    run us (last/worst): " << stats.last_run_us << "/" << stats.worst_run_us;
+        DebugSerial << ", jitter ms (last/worst): " << stats.last_jitter_ms << "/" << stats.worst_jitter_ms;
+        DebugSerial << ", busy share: " << (share / 10) << "." << (share % 10) << "%" << endl;
+    }
+    DebugSerial << "==========================================" << endl;
+}
+
+// ==================== Private Helper Methods ====================
+
+bool MyUtils::Scheduler::TaskScheduler::_valid(const int8_t task_id)
+{
+    return task_id >= 0 && static_cast<uint8_t>(task_id) < _task_count;
+}
+
+bool MyUtils::Scheduler::TaskScheduler::_is_due(const Task &task, const uint32_t now)
+{
+    if (!task.enabled) {
+        return false;
+    }
+    return static_cast<int32_t>(now - task.next_run_ms) >= 0;
+}
+
+void MyUtils::Scheduler::TaskScheduler::_execute(Task &task, const uint32_t now)
+{
+    const uint32_t release = task.next_run_ms;
+    const uint32_t jitter_ms = now - release;
+
+    const uint32_t start_us = micros();
+    task.callback();
+    const uint32_t run_us = micros() - start_us;
+
+    TaskStats &stats = task.stats;
+    stats.run_count++;
+    stats.last_run_us = run_us;
+    stats.total_run_us += run_us;
+    if (run_us > stats.worst_run_us) {
+        stats.worst_run_us = run_us;
+    }
+    stats.last_jitter_ms = jitter_ms;
+    if (jitter_ms > stats.worst_jitter_ms) {
+        stats.worst_jitter_ms = jitter_ms;
+    }
+    if (task.deadline_ms > 0 && (jitter_ms * 1000ULL) + run_us > task.deadline_ms * 1000ULL) {
+        stats.overrun_count++;
+    }
+
+    // Compute the next release from the previous one to avoid drift, and
+    // resynchronise if the task fell more than a whole period behind.
+    if (task.period_ms == 0) {
+        task.next_run_ms = millis();
+        return;
+    }
+    task.next_run_ms = release + task.period_ms;
+    const uint32_t finished = millis();
+    if (static_cast<int32_t>(finished - task.next_run_ms) >= 0) {
+        stats.skipped_count += (finished - release) / task.period_ms;
+        task.next_run_ms = finished + task.period_ms;
+    }
+}
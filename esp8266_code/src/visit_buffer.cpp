@@ -0,0 +1,151 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: visit_buffer.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: Coalesce the visits of the beacons at the feeder so they reach the control server in one batched request.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include "visit_buffer.hpp"
+
+/**
+ * @brief Add a sighting to the visit of its beacon.
+ *
+ * @param beacon Address of the beacon seen
+ * @param rssi Signal strength of this sighting (dBm)
+ * @param now millis() of the sighting
+ * @return false when the beacon had no entry and the buffer is full
+ */
+bool BluetoothLE::VisitBuffer::record(const MacAddress &beacon, const int8_t rssi, const uint32_t now)
+{
+    BeaconVisit *visit = nullptr;
+    for (uint8_t i = 0; i < _count; ++i) {
+        if (_visits[i].beacon == beacon) {
+            visit = &_visits[i];
+            break;
+        }
+    }
+    if (visit == nullptr) {
+        if (_count >= VISIT_BUFFER_CAPACITY) {
+            _overflowed = true;
+            _stats.overflows++;
+            return false;
+        }
+        if (_count == 0 && _pending_sightings == 0) {
+            _window_start_ms = now;  // The interval runs from the first visit, an idle feeder sends nothing
+        }
+        visit = &_visits[_count++];
+        visit->beacon = beacon;
+        visit->first_seen_ms = now;
+        visit->samples = 0;
+        visit->rssi_sum = 0;
+    }
+    visit->last_seen_ms = now;
+    if (visit->samples < UINT16_MAX_VALUE) {
+        visit->samples++;
+        visit->rssi_sum += rssi;
+    }
+    _pending_sightings++;
+    _stats.sightings++;
+    return true;
+}
+
+bool BluetoothLE::VisitBuffer::due(const uint32_t now) const
+{
+    if (_count == 0) {
+        return false;
+    }
+    if (_overflowed) {
+        return true;
+    }
+    return now - _window_start_ms >= VISIT_FLUSH_INTERVAL;
+}
+
+void BluetoothLE::VisitBuffer::sent(const uint32_t now)
+{
+    _stats.uploads++;
+    _stats.visits += _count;
+    // The per-sighting path sent one visit request for each beacon of each scan
+    if (_pending_sightings > 0) {
+        _stats.requests_saved += _pending_sightings - 1;
+    }
+    _count = 0;
+    _pending_sightings = 0;
+    _overflowed = false;
+    _window_start_ms = now;
+}
+
+void BluetoothLE::VisitBuffer::record_failure(const uint32_t now)
+{
+    // The visits wait for the next interval, a full buffer must not retry on every check
+    _stats.failures++;
+    _overflowed = false;
+    _window_start_ms = now;
+}
+
+uint8_t BluetoothLE::VisitBuffer::count() const
+{
+    return _count;
+}
+
+bool BluetoothLE::VisitBuffer::full() const
+{
+    return _count >= VISIT_BUFFER_CAPACITY;
+}
+
+const BluetoothLE::BeaconVisit *BluetoothLE::VisitBuffer::visits() const
+{
+    return _visits;
+}
+
+uint32_t BluetoothLE::VisitBuffer::requests_saved_per_hour() const
+{
+    const uint32_t uptime_ms = millis();
+    if (uptime_ms == 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>((static_cast<uint64_t>(_stats.requests_saved) * 3600000ULL) / uptime_ms);
+}
+
+const BluetoothLE::VisitBufferStats &BluetoothLE::VisitBuffer::stats() const
+{
+    return _stats;
+}
+
+void BluetoothLE::VisitBuffer::clear()
+{
+    _count = 0;
+    _pending_sightings = 0;
+    _window_start_ms = 0;
+    _overflowed = false;
+    _stats = VisitBufferStats();
+}
+
+void BluetoothLE::VisitBuffer::print() const
+{
+    DebugSerial << "============ Visit Buffer ============" << endl;
+    for (uint8_t i = 0; i < _count; ++i) {
+        const BeaconVisit &visit = _visits[i];
+        DebugSerial << "  " << visit.beacon << ": " << visit.samples << " samples, mean RSSI " << visit.mean_rssi()
+            << " dBm, seen " << (visit.last_seen_ms - visit.first_seen_ms) << " ms" << endl;
+    }
+    DebugSerial << "Sightings: " << _stats.sightings << ", overflows: " << _stats.overflows << endl;
+    DebugSerial << "Uploads: " << _stats.uploads << " (" << _stats.visits << " visits), failures: " << _stats.failures << endl;
+    DebugSerial << "Requests saved: " << _stats.requests_saved << " (" << requests_saved_per_hour() << "/h)" << endl;
+    DebugSerial << "======================================" << endl;
+}
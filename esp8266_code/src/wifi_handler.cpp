@@ -38,7 +38,7 @@ Wifi::WifiHandler::WifiHandler(const char *ssid_, const char *password_, const L
 
 void Wifi::WifiHandler::init()
 {
-    Serial << "Connecting to WiFi..." << endl;
+    DebugSerial << "Connecting to WiFi..." << endl;
     WiFi.mode(WIFI_STA);
     WiFi.begin(ssid, password);
 }
@@ -46,10 +46,10 @@ void Wifi::WifiHandler::init()
 void Wifi::WifiHandler::connect()
 {
     uint16_t connect_attempts = 0;
-    Serial.print("Checking status: ");
+    DebugSerial.print("Checking status: ");
     while (WiFi.status() != WL_CONNECTED) {
         delay(WIFI_RETRY_DELAY);
-        Serial.print(".");
+        DebugSerial.print(".");
         connect_attempts++;
         LED::led_fancy(wifi_anim, wifi_anim_length, background, 100);
         wifi_anim[0].pos = (wifi_anim[0].pos + 1);
@@ -58,7 +58,7 @@ void Wifi::WifiHandler::connect()
             wifi_anim[0].pos = 0;
         }
     }
-    Serial << "\nWiFi connected" << endl;
+    DebugSerial << "\nWiFi connected" << endl;
     LED::led_set_colour(wifi_anim->colour, LED_DURATION, -1);
     MyUtils::ActiveComponents::Panel::enable(WIFI_COMPONENT);
 }
@@ -67,7 +67,7 @@ void Wifi::WifiHandler::showIp()
 {
     IPAddress ip = getIP();
     // Print IP without using String - access octets directly
-    Serial << "Device IP Address: " << ip[0] << "." << ip[1] << "." << ip[2] << "." << ip[3] << endl;
+    DebugSerial << "Device IP Address: " << ip[0] << "." << ip[1] << "." << ip[2] << "." << ip[3] << endl;
     LED::led_set_colour(wifi_anim->colour, LED_DURATION, -1);
 }
 
@@ -0,0 +1,206 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: test_main.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: These are the host tests of the beacon tracker presence hysteresis and hash table.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <unity.h>
+#include <Arduino.h>
+#include "beacon_tracker.hpp"
+
+using BluetoothLE::BeaconTracker;
+using BluetoothLE::BeaconTransition;
+using BluetoothLE::MacAddress;
+using BluetoothLE::TrackedBeacon;
+
+static BeaconTracker *tracker = nullptr;
+
+static MacAddress beacon(const uint8_t id)
+{
+    char hex[MacAddress::HEX_LENGTH + 1];
+    snprintf(hex, sizeof(hex), "A4C1380000%02X", id);
+    MacAddress address;
+    address.parse(hex, MacAddress::HEX_LENGTH);
+    return address;
+}
+
+static int transition(const MacAddress &address, const int8_t rssi, const uint32_t now_ms)
+{
+    return static_cast<int>(tracker->observe(address, rssi, now_ms));
+}
+
+void setUp()
+{
+    ArduinoShim::set_console_echo(false);
+    tracker = new BeaconTracker();
+}
+
+void tearDown()
+{
+    delete tracker;
+    tracker = nullptr;
+}
+
+void test_strong_first_sample_enters()
+{
+    const TrackedBeacon *entry = nullptr;
+    TEST_ASSERT_EQUAL(static_cast<int>(BeaconTransition::Entered), static_cast<int>(tracker->observe(beacon(1), BEACON_ENTER_RSSI, 1000, &entry)));
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_TRUE(entry->present);
+    TEST_ASSERT_EQUAL_UINT32(1000, entry->entered_ms);
+    TEST_ASSERT_EQUAL_UINT8(1, tracker->present_count());
+}
+
+void test_weak_beacon_is_tracked_but_absent()
+{
+    TEST_ASSERT_EQUAL(static_cast<int>(BeaconTransition::None), transition(beacon(1), BEACON_LEAVE_RSSI - 10, 1000));
+    const TrackedBeacon *entry = tracker->find(beacon(1));
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_FALSE(entry->present);
+    TEST_ASSERT_EQUAL_UINT8(1, tracker->count());
+    TEST_ASSERT_EQUAL_UINT8(0, tracker->present_count());
+}
+
+void test_between_thresholds_holds_the_state()
+{
+    const int8_t middle = (BEACON_ENTER_RSSI + BEACON_LEAVE_RSSI) / 2;
+    // Present beacons stay present
+    transition(beacon(1), BEACON_ENTER_RSSI + 10, 0);
+    for (uint32_t i = 1; i <= 50; ++i) {
+        TEST_ASSERT_EQUAL(static_cast<int>(BeaconTransition::None), transition(beacon(1), middle, i * 1000));
+    }
+    TEST_ASSERT_TRUE(tracker->find(beacon(1))->present);
+    TEST_ASSERT_EQUAL_INT8(middle, tracker->find(beacon(1))->rssi());
+    // Absent beacons stay absent
+    transition(beacon(2), BEACON_LEAVE_RSSI - 20, 0);
+    for (uint32_t i = 1; i <= 50; ++i) {
+        TEST_ASSERT_EQUAL(static_cast<int>(BeaconTransition::None), transition(beacon(2), middle, i * 1000));
+    }
+    TEST_ASSERT_FALSE(tracker->find(beacon(2))->present);
+}
+
+void test_single_weak_sample_does_not_flap()
+{
+    transition(beacon(1), BEACON_ENTER_RSSI + 10, 0);
+    TEST_ASSERT_EQUAL(static_cast<int>(BeaconTransition::None), transition(beacon(1), -100, 1000));
+    TEST_ASSERT_TRUE(tracker->find(beacon(1))->present);
+}
+
+void test_leaves_once_on_weak_signal_and_reenters_on_strong()
+{
+    transition(beacon(1), BEACON_ENTER_RSSI + 10, 0);
+    uint8_t left = 0;
+    for (uint32_t i = 1; i <= 20; ++i) {
+        if (transition(beacon(1), -100, i * 1000) == static_cast<int>(BeaconTransition::Left)) {
+            left++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, left);
+    TEST_ASSERT_FALSE(tracker->find(beacon(1))->present);
+    TEST_ASSERT_EQUAL_UINT32(1, tracker->stats().left);
+
+    uint8_t entered = 0;
+    for (uint32_t i = 21; i <= 60; ++i) {
+        if (transition(beacon(1), BEACON_ENTER_RSSI + 10, i * 1000) == static_cast<int>(BeaconTransition::Entered)) {
+            entered++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, entered);
+    TEST_ASSERT_TRUE(tracker->find(beacon(1))->present);
+}
+
+void test_silence_leaves_then_forgets()
+{
+    transition(beacon(1), BEACON_ENTER_RSSI, 1000);
+    TEST_ASSERT_EQUAL_UINT8(0, tracker->expire(1000 + BEACON_LEAVE_TIMEOUT_MS - 1));
+    TEST_ASSERT_TRUE(tracker->find(beacon(1))->present);
+    TEST_ASSERT_EQUAL_UINT8(1, tracker->expire(1000 + BEACON_LEAVE_TIMEOUT_MS));
+    TEST_ASSERT_FALSE(tracker->find(beacon(1))->present);
+    // Leaving does not count twice
+    TEST_ASSERT_EQUAL_UINT8(0, tracker->expire(1000 + BEACON_LEAVE_TIMEOUT_MS + 1));
+
+    tracker->expire(1000 + BEACON_FORGET_TIMEOUT_MS);
+    TEST_ASSERT_NULL(tracker->find(beacon(1)));
+    TEST_ASSERT_EQUAL_UINT8(0, tracker->count());
+    TEST_ASSERT_EQUAL_UINT32(1, tracker->stats().forgotten);
+}
+
+void test_forgetting_keeps_the_other_beacons_reachable()
+{
+    // Enough beacons for the probe chains to overlap, the odd ones go silent
+    const uint8_t total = BeaconTracker::MAX_TRACKED;
+    for (uint8_t i = 0; i < total; ++i) {
+        transition(beacon(i), -50, 0);
+    }
+    TEST_ASSERT_EQUAL_UINT8(total, tracker->count());
+    for (uint8_t i = 0; i < total; i += 2) {
+        transition(beacon(i), -50, BEACON_FORGET_TIMEOUT_MS);
+    }
+    tracker->expire(BEACON_FORGET_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_UINT8((total + 1) / 2, tracker->count());
+    for (uint8_t i = 0; i < total; ++i) {
+        if (i % 2 == 0) {
+            TEST_ASSERT_NOT_NULL(tracker->find(beacon(i)));
+        } else {
+            TEST_ASSERT_NULL(tracker->find(beacon(i)));
+        }
+    }
+}
+
+void test_full_table_drops_new_beacons()
+{
+    for (uint8_t i = 0; i < BeaconTracker::MAX_TRACKED; ++i) {
+        transition(beacon(i), -50, 0);
+    }
+    const TrackedBeacon *entry = tracker->find(beacon(0));
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(static_cast<int>(BeaconTransition::None), static_cast<int>(tracker->observe(beacon(200), -50, 0, &entry)));
+    TEST_ASSERT_NULL(entry);
+    TEST_ASSERT_EQUAL_UINT32(1, tracker->stats().dropped);
+    TEST_ASSERT_NULL(tracker->find(beacon(200)));
+}
+
+void test_report_marks()
+{
+    transition(beacon(1), -50, 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, tracker->find(beacon(1))->last_reported_ms);
+    TEST_ASSERT_TRUE(tracker->mark_reported(beacon(1), 5000));
+    TEST_ASSERT_EQUAL_UINT32(5000, tracker->find(beacon(1))->last_reported_ms);
+    // A failed report is due again after the retry interval, not the report interval
+    const uint32_t now = 1000000;
+    TEST_ASSERT_TRUE(tracker->retry_report(beacon(1), now));
+    TEST_ASSERT_EQUAL_UINT32(BEACON_REPORT_INTERVAL, (now + BEACON_REPORT_RETRY_INTERVAL) - tracker->find(beacon(1))->last_reported_ms);
+    TEST_ASSERT_FALSE(tracker->mark_reported(beacon(9), now));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_strong_first_sample_enters);
+    RUN_TEST(test_weak_beacon_is_tracked_but_absent);
+    RUN_TEST(test_between_thresholds_holds_the_state);
+    RUN_TEST(test_single_weak_sample_does_not_flap);
+    RUN_TEST(test_leaves_once_on_weak_signal_and_reenters_on_strong);
+    RUN_TEST(test_silence_leaves_then_forgets);
+    RUN_TEST(test_forgetting_keeps_the_other_beacons_reachable);
+    RUN_TEST(test_full_table_drops_new_beacons);
+    RUN_TEST(test_report_marks);
+    return UNITY_END();
+}
@@ -0,0 +1,244 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: test_main.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: These are the host tests of the framing and checksum of the bluetooth command channel.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <unity.h>
+#include <Arduino.h>
+#include "ble_command_channel.hpp"
+
+using BluetoothLE::CommandChannel;
+namespace Protocol = BluetoothLE::Protocol;
+
+static CommandChannel *channel = nullptr;
+static uint8_t response[Protocol::MAX_RESPONSE_SIZE];
+static uint32_t now_ms = 0;
+
+// Request frame with a valid CRC, returns its length
+static size_t frame(const uint8_t opcode, const uint8_t seq, const uint8_t *payload, const uint8_t length, uint8_t *out)
+{
+    out[0] = Protocol::REQUEST_START;
+    out[1] = opcode;
+    out[2] = seq;
+    out[3] = length;
+    if (length > 0) {
+        memcpy(out + 4, payload, length);
+    }
+    out[4 + length] = Protocol::crc8(out + 1, 3 + length);
+    return 5 + length;
+}
+
+// Feed the bytes one at a time, only the last one may complete the frame (0 otherwise)
+static size_t send(const uint8_t *bytes, const size_t length)
+{
+    size_t reply = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (reply != 0) {
+            return 0;
+        }
+        reply = channel->feed(bytes[i], now_ms, response, sizeof(response));
+    }
+    return reply;
+}
+
+static void assert_response(const size_t length, const uint8_t opcode, const uint8_t seq, const Protocol::Status status, const uint8_t payload_length)
+{
+    TEST_ASSERT_EQUAL_UINT32(5 + payload_length + 1, length);
+    TEST_ASSERT_EQUAL_UINT8(Protocol::RESPONSE_START, response[0]);
+    TEST_ASSERT_EQUAL_UINT8(opcode, response[1]);
+    TEST_ASSERT_EQUAL_UINT8(seq, response[2]);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(status), response[3]);
+    TEST_ASSERT_EQUAL_UINT8(payload_length, response[4]);
+    TEST_ASSERT_EQUAL_UINT8(Protocol::crc8(response + 1, 4 + payload_length), response[5 + payload_length]);
+}
+
+void setUp()
+{
+    ArduinoShim::set_console_echo(false);
+    channel = new CommandChannel();
+    memset(response, 0, sizeof(response));
+    now_ms = 1000;
+}
+
+void tearDown()
+{
+    delete channel;
+    channel = nullptr;
+}
+
+void test_crc8_matches_the_reference_check_value()
+{
+    // CRC-8, polynomial 0x07, init 0x00: check value of "123456789"
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_UINT8(0xF4, Protocol::crc8(check, sizeof(check)));
+    // Chaining two halves gives the same result
+    TEST_ASSERT_EQUAL_UINT8(0xF4, Protocol::crc8(check + 4, 5, Protocol::crc8(check, 4)));
+}
+
+void test_ping_echoes_its_payload()
+{
+    // A start byte inside the payload is data, not a new frame
+    const uint8_t payload[] = {0x10, Protocol::REQUEST_START, 0x00, 0xFF};
+    uint8_t request[Protocol::MAX_RESPONSE_SIZE];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 7, payload, sizeof(payload), request);
+    assert_response(send(request, length), 0x01, 7, Protocol::Status::Ok, sizeof(payload));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, response + 5, sizeof(payload));
+    TEST_ASSERT_EQUAL_UINT32(1, channel->stats().frames);
+}
+
+void test_empty_payload_goes_straight_to_the_checksum()
+{
+    uint8_t request[8];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 1, nullptr, 0, request);
+    TEST_ASSERT_EQUAL_UINT32(5, length);
+    assert_response(send(request, length), 0x01, 1, Protocol::Status::Ok, 0);
+}
+
+void test_bad_checksum_is_rejected()
+{
+    const uint8_t payload[] = {1, 2, 3};
+    uint8_t request[16];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 9, payload, sizeof(payload), request);
+    request[length - 1] ^= 0x01;
+    assert_response(send(request, length), 0x01, 9, Protocol::Status::BadChecksum, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, channel->stats().bad_checksum);
+    TEST_ASSERT_EQUAL_UINT32(0, channel->stats().frames);
+
+    // The next frame is read normally
+    request[length - 1] ^= 0x01;
+    assert_response(send(request, length), 0x01, 9, Protocol::Status::Ok, sizeof(payload));
+}
+
+void test_stray_bytes_are_skipped()
+{
+    uint8_t request[16] = {'O', 'K', '+', 'L', 'O', 'S', 'T'};
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 3, nullptr, 0, request + 7);
+    assert_response(send(request, 7 + length), 0x01, 3, Protocol::Status::Ok, 0);
+    TEST_ASSERT_EQUAL_UINT32(7, channel->stats().stray_bytes);
+}
+
+void test_oversized_length_is_answered_at_once()
+{
+    const uint8_t header[] = {Protocol::REQUEST_START, static_cast<uint8_t>(Protocol::Opcode::Ping), 4, Protocol::MAX_PAYLOAD + 1};
+    assert_response(send(header, sizeof(header)), 0x01, 4, Protocol::Status::BadLength, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, channel->stats().rejected);
+
+    uint8_t request[8];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 5, nullptr, 0, request);
+    assert_response(send(request, length), 0x01, 5, Protocol::Status::Ok, 0);
+}
+
+void test_cut_frame_times_out()
+{
+    const uint8_t payload[] = {1, 2, 3, 4};
+    uint8_t request[16];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 2, payload, sizeof(payload), request);
+    TEST_ASSERT_EQUAL_UINT32(0, send(request, 5));  // Header and the first payload byte
+
+    // A whole frame arriving after the gap is read on its own
+    now_ms += Protocol::FRAME_TIMEOUT_MS + 1;
+    assert_response(send(request, length), 0x01, 2, Protocol::Status::Ok, sizeof(payload));
+    TEST_ASSERT_EQUAL_UINT32(1, channel->stats().timeouts);
+}
+
+void test_slow_but_steady_frame_is_kept()
+{
+    uint8_t request[8];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 2, nullptr, 0, request);
+    size_t reply = 0;
+    for (size_t i = 0; i < length; ++i) {
+        now_ms += Protocol::FRAME_TIMEOUT_MS;
+        reply = channel->feed(request[i], now_ms, response, sizeof(response));
+    }
+    assert_response(reply, 0x01, 2, Protocol::Status::Ok, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, channel->stats().timeouts);
+}
+
+void test_reset_drops_the_partial_frame()
+{
+    uint8_t request[8];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 6, nullptr, 0, request);
+    send(request, 3);
+    channel->reset();
+    assert_response(send(request, length), 0x01, 6, Protocol::Status::Ok, 0);
+}
+
+void test_dispatch_errors()
+{
+    uint8_t request[16];
+    size_t length = frame(0x7F, 1, nullptr, 0, request);
+    assert_response(send(request, length), 0x7F, 1, Protocol::Status::UnknownOpcode, 0);
+
+    const uint8_t one_byte[] = {10};
+    length = frame(static_cast<uint8_t>(Protocol::Opcode::Feed), 2, one_byte, sizeof(one_byte), request);
+    assert_response(send(request, length), 0x05, 2, Protocol::Status::BadLength, 0);
+
+    const uint8_t no_food[] = {0, 0};
+    length = frame(static_cast<uint8_t>(Protocol::Opcode::Feed), 3, no_food, sizeof(no_food), request);
+    assert_response(send(request, length), 0x05, 3, Protocol::Status::Failed, 0);
+
+    length = frame(static_cast<uint8_t>(Protocol::Opcode::Devices), 4, nullptr, 0, request);
+    assert_response(send(request, length), 0x03, 4, Protocol::Status::BadLength, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(4, channel->stats().rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, channel->stats().frames);
+}
+
+void test_hello_fits_the_payload()
+{
+    uint8_t request[8];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Hello), 8, nullptr, 0, request);
+    const size_t reply = send(request, length);
+    TEST_ASSERT_GREATER_THAN(6, reply);
+    assert_response(reply, 0x06, 8, Protocol::Status::Ok, response[4]);
+    TEST_ASSERT_LESS_OR_EQUAL(Protocol::MAX_PAYLOAD, response[4]);
+}
+
+void test_small_response_buffer_gets_nothing()
+{
+    const uint8_t payload[] = {1, 2, 3, 4};
+    uint8_t request[16];
+    const size_t length = frame(static_cast<uint8_t>(Protocol::Opcode::Ping), 1, payload, sizeof(payload), request);
+    uint8_t small[6];
+    size_t reply = 0;
+    for (size_t i = 0; i < length; ++i) {
+        reply = channel->feed(request[i], now_ms, small, sizeof(small));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, reply);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc8_matches_the_reference_check_value);
+    RUN_TEST(test_ping_echoes_its_payload);
+    RUN_TEST(test_empty_payload_goes_straight_to_the_checksum);
+    RUN_TEST(test_bad_checksum_is_rejected);
+    RUN_TEST(test_stray_bytes_are_skipped);
+    RUN_TEST(test_oversized_length_is_answered_at_once);
+    RUN_TEST(test_cut_frame_times_out);
+    RUN_TEST(test_slow_but_steady_frame_is_kept);
+    RUN_TEST(test_reset_drops_the_partial_frame);
+    RUN_TEST(test_dispatch_errors);
+    RUN_TEST(test_hello_fits_the_payload);
+    RUN_TEST(test_small_response_buffer_gets_nothing);
+    return UNITY_END();
+}
@@ -0,0 +1,185 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: test_main.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: These are the host tests of the non-blocking feeding sequence, driven by a fake clock.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <unity.h>
+#include <Arduino.h>
+#include <Servo.h>
+#include "feeder.hpp"
+
+// Any free pins, the shim Servo remembers what each one was told
+static constexpr uint8_t TRAY_PIN = 4;
+static constexpr uint8_t TRAP_PIN = 5;
+static constexpr int SERVO_STOP = 90;
+static constexpr int SERVO_RIGHT = 180;  // Speed 100
+static constexpr int SERVO_LEFT = 0;     // Speed -100
+
+static LED::ColourPos tray_leds[] = {{0, LED::green_colour}, {UINT16_MAX_VALUE, {}}};
+static LED::ColourPos trap_leds[] = {{0, LED::green_colour}, {UINT16_MAX_VALUE, {}}};
+
+static Motors::Motor *tray = nullptr;
+static Motors::Motor *trap = nullptr;
+static Feeder::FeedingSequence *sequence = nullptr;
+static uint32_t now_ms = 0;
+
+// Advance the fake clock to the end of the current phase and tick once
+static void finish_phase()
+{
+    const Feeder::FeedPhase phase = sequence->phase();
+    now_ms = sequence->phase_started_at(phase) + sequence->phase_duration(phase);
+    sequence->tick(now_ms);
+}
+
+static void assert_motor(const uint8_t pin, const bool running, const int value)
+{
+    TEST_ASSERT_EQUAL(running, Servo::pin_attached(pin));
+    TEST_ASSERT_EQUAL_INT(value, Servo::pin_value(pin));
+}
+
+void setUp()
+{
+    ArduinoShim::set_console_echo(false);
+    Servo::reset_pins();
+    static Motors::Motor tray_motor(TRAY_PIN, tray_leds, MOTOR_SPEED_DEFAULT, LED::default_background, LED::red_colour, MyUtils::ActiveComponents::Component::MotorLeft);
+    static Motors::Motor trap_motor(TRAP_PIN, trap_leds, MOTOR_SPEED_DEFAULT, LED::default_background, LED::red_colour, MyUtils::ActiveComponents::Component::MotorRight);
+    tray = &tray_motor;
+    trap = &trap_motor;
+    sequence = new Feeder::FeedingSequence(tray, trap);
+    now_ms = 1000;
+}
+
+void tearDown()
+{
+    delete sequence;
+    sequence = nullptr;
+}
+
+void test_idle_until_started()
+{
+    TEST_ASSERT_FALSE(sequence->is_busy());
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::Idle), static_cast<int>(sequence->phase()));
+    sequence->tick(now_ms + 60000);
+    TEST_ASSERT_FALSE(sequence->is_busy());
+    assert_motor(TRAY_PIN, false, SERVO_STOP);
+    assert_motor(TRAP_PIN, false, SERVO_STOP);
+}
+
+void test_phases_drive_the_motors_in_order()
+{
+    TEST_ASSERT_TRUE(sequence->start(20, now_ms));
+    TEST_ASSERT_TRUE(sequence->is_busy());
+
+    // The tray hides the bowl first, the trap does not move
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::ClosingTray), static_cast<int>(sequence->phase()));
+    assert_motor(TRAY_PIN, true, SERVO_RIGHT);
+    assert_motor(TRAP_PIN, false, SERVO_STOP);
+    TEST_ASSERT_GREATER_THAN(0, sequence->phase_duration(Feeder::FeedPhase::ClosingTray));
+
+    // One millisecond early changes nothing
+    sequence->tick(now_ms + sequence->phase_duration(Feeder::FeedPhase::ClosingTray) - 1);
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::ClosingTray), static_cast<int>(sequence->phase()));
+
+    finish_phase();
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::OpeningTrap), static_cast<int>(sequence->phase()));
+    assert_motor(TRAY_PIN, false, SERVO_STOP);
+    assert_motor(TRAP_PIN, true, SERVO_LEFT);
+
+    finish_phase();
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::Dispensing), static_cast<int>(sequence->phase()));
+    TEST_ASSERT_EQUAL_UINT32(20 * FEEDING_MS_PER_GRAM, sequence->phase_duration(Feeder::FeedPhase::Dispensing));
+    assert_motor(TRAP_PIN, false, SERVO_STOP);
+
+    finish_phase();
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::ClosingTrap), static_cast<int>(sequence->phase()));
+    assert_motor(TRAP_PIN, true, SERVO_RIGHT);
+
+    finish_phase();
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::OpeningTray), static_cast<int>(sequence->phase()));
+    assert_motor(TRAP_PIN, false, SERVO_STOP);
+    assert_motor(TRAY_PIN, true, SERVO_LEFT);
+    TEST_ASSERT_TRUE(sequence->is_busy());
+
+    finish_phase();
+    TEST_ASSERT_FALSE(sequence->is_busy());
+    assert_motor(TRAY_PIN, false, SERVO_STOP);
+    assert_motor(TRAP_PIN, false, SERVO_STOP);
+    TEST_ASSERT_EQUAL_UINT32(1, sequence->completed_feeds());
+    TEST_ASSERT_EQUAL_UINT32(now_ms - 1000, sequence->last_feed_duration());
+}
+
+void test_one_phase_per_tick_when_late()
+{
+    TEST_ASSERT_TRUE(sequence->start(20, now_ms));
+    // A tick far past the end of the whole feed still moves a single phase
+    sequence->tick(now_ms + 600000);
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::OpeningTrap), static_cast<int>(sequence->phase()));
+    TEST_ASSERT_EQUAL_UINT32(now_ms + 600000, sequence->phase_started_at(Feeder::FeedPhase::OpeningTrap));
+}
+
+void test_restart_while_running_is_refused()
+{
+    TEST_ASSERT_TRUE(sequence->start(20, now_ms));
+    finish_phase();
+    finish_phase();
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::Dispensing), static_cast<int>(sequence->phase()));
+    const uint32_t changes = Servo::pin_changes(TRAY_PIN) + Servo::pin_changes(TRAP_PIN);
+
+    // The running feed keeps its phase, its amount and its motors
+    TEST_ASSERT_FALSE(sequence->start(50, now_ms + 1));
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::Dispensing), static_cast<int>(sequence->phase()));
+    TEST_ASSERT_EQUAL_UINT32(20 * FEEDING_MS_PER_GRAM, sequence->phase_duration(Feeder::FeedPhase::Dispensing));
+    TEST_ASSERT_EQUAL_UINT32(changes, Servo::pin_changes(TRAY_PIN) + Servo::pin_changes(TRAP_PIN));
+
+    while (sequence->is_busy()) {
+        finish_phase();
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, sequence->completed_feeds());
+
+    // Once over, the next feed starts from the first phase with its own amount
+    TEST_ASSERT_TRUE(sequence->start(50, now_ms));
+    TEST_ASSERT_EQUAL(static_cast<int>(Feeder::FeedPhase::ClosingTray), static_cast<int>(sequence->phase()));
+    assert_motor(TRAY_PIN, true, SERVO_RIGHT);
+    while (sequence->is_busy()) {
+        finish_phase();
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, sequence->completed_feeds());
+    TEST_ASSERT_EQUAL_UINT32(50 * FEEDING_MS_PER_GRAM, sequence->phase_duration(Feeder::FeedPhase::Dispensing));
+}
+
+void test_missing_motor_refuses_to_start()
+{
+    Feeder::FeedingSequence no_trap(tray, nullptr);
+    TEST_ASSERT_FALSE(no_trap.start(20, now_ms));
+    TEST_ASSERT_FALSE(no_trap.is_busy());
+    assert_motor(TRAY_PIN, false, SERVO_STOP);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_until_started);
+    RUN_TEST(test_phases_drive_the_motors_in_order);
+    RUN_TEST(test_one_phase_per_tick_when_late);
+    RUN_TEST(test_restart_while_running_is_refused);
+    RUN_TEST(test_missing_motor_refuses_to_start);
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: test_main.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: These are the host tests of the adaptive BLE scan duty cycle.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <unity.h>
+#include <Arduino.h>
+#include "scan_duty_cycle.hpp"
+
+using BluetoothLE::ScanDutyCycle;
+using BluetoothLE::ScanMode;
+
+static constexpr uint32_t WINDOW_MS = 3000;
+static constexpr uint32_t MIN_INTERVAL_MS = 10000;
+static constexpr uint32_t MAX_INTERVAL_MS = 60000;
+
+static ScanDutyCycle *duty = nullptr;
+static uint32_t now_ms = 0;
+
+// Wait for the next window, run it for WINDOW_MS and close it
+static void run_scan(const bool known_seen)
+{
+    now_ms += duty->next_scan_in_ms(now_ms);
+    TEST_ASSERT_TRUE(duty->due(now_ms));
+    duty->started(now_ms);
+    now_ms += WINDOW_MS;
+    duty->finished(now_ms, known_seen);
+}
+
+void setUp()
+{
+    ArduinoShim::set_console_echo(false);
+    duty = new ScanDutyCycle(WINDOW_MS, MIN_INTERVAL_MS, MAX_INTERVAL_MS, ScanMode::Adaptive);
+    now_ms = 5000;
+}
+
+void tearDown()
+{
+    delete duty;
+    duty = nullptr;
+}
+
+void test_first_window_is_due_right_away()
+{
+    TEST_ASSERT_TRUE(duty->due(now_ms));
+    TEST_ASSERT_EQUAL_UINT32(0, duty->next_scan_in_ms(now_ms));
+    duty->started(now_ms);
+    TEST_ASSERT_TRUE(duty->running());
+    TEST_ASSERT_FALSE(duty->due(now_ms + MAX_INTERVAL_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, duty->next_scan_in_ms(now_ms + 1));
+}
+
+void test_interval_runs_start_to_start()
+{
+    const uint32_t start = now_ms;
+    duty->started(start);
+    duty->finished(start + WINDOW_MS, true);
+    TEST_ASSERT_FALSE(duty->running());
+    TEST_ASSERT_FALSE(duty->due(start + MIN_INTERVAL_MS - 1));
+    TEST_ASSERT_EQUAL_UINT32(1, duty->next_scan_in_ms(start + MIN_INTERVAL_MS - 1));
+    TEST_ASSERT_TRUE(duty->due(start + MIN_INTERVAL_MS));
+}
+
+void test_idle_windows_double_up_to_the_ceiling()
+{
+    const uint32_t expected[] = {20000, 40000, 60000, 60000, 60000};
+    for (const uint32_t interval : expected) {
+        run_scan(false);
+        TEST_ASSERT_EQUAL_UINT32(interval, duty->interval_ms());
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, duty->stats().backoffs);
+    TEST_ASSERT_EQUAL_UINT16(WINDOW_MS * 1000 / MAX_INTERVAL_MS, duty->duty_permille());
+}
+
+void test_known_beacon_drops_to_the_minimum_and_holds()
+{
+    run_scan(false);
+    run_scan(false);
+    TEST_ASSERT_EQUAL_UINT32(40000, duty->interval_ms());
+
+    run_scan(true);
+    const uint32_t known_at = now_ms;
+    TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL_MS, duty->interval_ms());
+
+    // Idle windows keep the minimum while the hold lasts
+    while (now_ms + MIN_INTERVAL_MS - known_at < BLE_SCAN_ACTIVE_HOLD_MS) {  // The next window closes inside the hold
+        run_scan(false);
+        TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL_MS, duty->interval_ms());
+    }
+    // Then the back-off starts again
+    run_scan(false);
+    TEST_ASSERT_GREATER_OR_EQUAL(BLE_SCAN_ACTIVE_HOLD_MS, now_ms - known_at);
+    TEST_ASSERT_EQUAL_UINT32(2 * MIN_INTERVAL_MS, duty->interval_ms());
+    TEST_ASSERT_EQUAL_UINT32(1, duty->stats().active_scans);
+}
+
+void test_fixed_mode_never_backs_off()
+{
+    TEST_ASSERT_TRUE(duty->configure(WINDOW_MS, MIN_INTERVAL_MS, MAX_INTERVAL_MS, ScanMode::Fixed));
+    for (uint8_t i = 0; i < 10; ++i) {
+        run_scan(false);
+        TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL_MS, duty->interval_ms());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, duty->stats().backoffs);
+}
+
+void test_configure_rejects_inconsistent_settings()
+{
+    run_scan(false);
+    TEST_ASSERT_EQUAL_UINT32(20000, duty->interval_ms());
+    TEST_ASSERT_FALSE(duty->configure(0, MIN_INTERVAL_MS, MAX_INTERVAL_MS, ScanMode::Adaptive));
+    TEST_ASSERT_FALSE(duty->configure(MIN_INTERVAL_MS + 1, MIN_INTERVAL_MS, MAX_INTERVAL_MS, ScanMode::Adaptive));
+    TEST_ASSERT_FALSE(duty->configure(WINDOW_MS, MAX_INTERVAL_MS + 1, MAX_INTERVAL_MS, ScanMode::Adaptive));
+    TEST_ASSERT_EQUAL_UINT32(20000, duty->interval_ms());
+    TEST_ASSERT_EQUAL_UINT32(WINDOW_MS, duty->window_ms());
+
+    // An accepted setting restarts from its minimum
+    TEST_ASSERT_TRUE(duty->configure(2000, 15000, 120000, ScanMode::Adaptive));
+    TEST_ASSERT_EQUAL_UINT32(15000, duty->interval_ms());
+    TEST_ASSERT_EQUAL_UINT32(120000, duty->max_interval_ms());
+}
+
+void test_stats_count_radio_time_and_gaps()
+{
+    duty->finished(now_ms, true);  // Nothing was started, ignored
+    TEST_ASSERT_EQUAL_UINT32(0, duty->stats().scans);
+
+    run_scan(false);
+    run_scan(false);
+    run_scan(false);
+    TEST_ASSERT_EQUAL_UINT32(3, duty->stats().scans);
+    TEST_ASSERT_EQUAL_UINT32(3 * WINDOW_MS, duty->stats().radio_ms);
+    TEST_ASSERT_EQUAL_UINT32(40000, duty->stats().longest_gap_ms);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_window_is_due_right_away);
+    RUN_TEST(test_interval_runs_start_to_start);
+    RUN_TEST(test_idle_windows_double_up_to_the_ceiling);
+    RUN_TEST(test_known_beacon_drops_to_the_minimum_and_holds);
+    RUN_TEST(test_fixed_mode_never_backs_off);
+    RUN_TEST(test_configure_rejects_inconsistent_settings);
+    RUN_TEST(test_stats_count_radio_time_and_gaps);
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+/*
+* +==== BEGIN CatFeeder =================+
+* LOGO:
+* ..............(....⁄\
+* ...............)..(.')
+* ..............(../..)
+* ...............\(__)|
+* Inspired by Joan Stark
+* source https://www.asciiart.eu/
+* animals/cats
+* /STOP
+* PROJECT: CatFeeder
+* FILE: test_main.cpp
+* CREATION DATE: 16-10-2026
+* LAST Modified: 9:12:40 16-10-2026
+* DESCRIPTION:
+* This is the project in charge of making the connected cat feeder project work.
+* /STOP
+* COPYRIGHT: (c) Cat Feeder
+* PURPOSE: These are the host tests of the visit buffer coalescing and upload timing.
+* // AR
+* +==== END CatFeeder =================+
+*/
+#include <unity.h>
+#include <Arduino.h>
+#include "visit_buffer.hpp"
+
+using BluetoothLE::BeaconVisit;
+using BluetoothLE::MacAddress;
+using BluetoothLE::VisitBuffer;
+
+static VisitBuffer *buffer = nullptr;
+
+static MacAddress beacon(const uint8_t id)
+{
+    char hex[MacAddress::HEX_LENGTH + 1];
+    snprintf(hex, sizeof(hex), "A4C1380000%02X", id);
+    MacAddress address;
+    address.parse(hex, MacAddress::HEX_LENGTH);
+    return address;
+}
+
+void setUp()
+{
+    ArduinoShim::set_console_echo(false);
+    buffer = new VisitBuffer();
+}
+
+void tearDown()
+{
+    delete buffer;
+    buffer = nullptr;
+}
+
+void test_empty_buffer_is_never_due()
+{
+    TEST_ASSERT_EQUAL_UINT8(0, buffer->count());
+    TEST_ASSERT_FALSE(buffer->due(0));
+    TEST_ASSERT_FALSE(buffer->due(10 * VISIT_FLUSH_INTERVAL));
+}
+
+void test_sightings_of_a_beacon_coalesce()
+{
+    TEST_ASSERT_TRUE(buffer->record(beacon(1), -50, 1000));
+    TEST_ASSERT_TRUE(buffer->record(beacon(2), -70, 2000));
+    TEST_ASSERT_TRUE(buffer->record(beacon(1), -60, 11000));
+    TEST_ASSERT_TRUE(buffer->record(beacon(1), -55, 21000));
+
+    TEST_ASSERT_EQUAL_UINT8(2, buffer->count());
+    const BeaconVisit &first = buffer->visits()[0];
+    TEST_ASSERT_TRUE(first.beacon == beacon(1));
+    TEST_ASSERT_EQUAL_UINT32(1000, first.first_seen_ms);
+    TEST_ASSERT_EQUAL_UINT32(21000, first.last_seen_ms);
+    TEST_ASSERT_EQUAL_UINT16(3, first.samples);
+    TEST_ASSERT_EQUAL_INT8(-55, first.mean_rssi());
+
+    const BeaconVisit &second = buffer->visits()[1];
+    TEST_ASSERT_TRUE(second.beacon == beacon(2));
+    TEST_ASSERT_EQUAL_UINT16(1, second.samples);
+    TEST_ASSERT_EQUAL_INT8(-70, second.mean_rssi());
+    TEST_ASSERT_EQUAL_UINT32(4, buffer->stats().sightings);
+}
+
+void test_interval_runs_from_the_first_visit()
+{
+    const uint32_t first = 50000;
+    buffer->record(beacon(1), -50, first);
+    buffer->record(beacon(1), -50, first + VISIT_FLUSH_INTERVAL / 2);
+    TEST_ASSERT_FALSE(buffer->due(first + VISIT_FLUSH_INTERVAL - 1));
+    TEST_ASSERT_TRUE(buffer->due(first + VISIT_FLUSH_INTERVAL));
+}
+
+void test_sent_starts_over_and_counts_the_saved_requests()
+{
+    for (uint8_t scan = 0; scan < 10; ++scan) {
+        buffer->record(beacon(1), -50, scan * 10000);
+        buffer->record(beacon(2), -60, scan * 10000);
+    }
+    buffer->sent(VISIT_FLUSH_INTERVAL);
+    TEST_ASSERT_EQUAL_UINT8(0, buffer->count());
+    TEST_ASSERT_FALSE(buffer->due(3 * VISIT_FLUSH_INTERVAL));
+    TEST_ASSERT_EQUAL_UINT32(1, buffer->stats().uploads);
+    TEST_ASSERT_EQUAL_UINT32(2, buffer->stats().visits);
+    // 20 visit requests became one
+    TEST_ASSERT_EQUAL_UINT32(19, buffer->stats().requests_saved);
+
+    // The next visit opens a fresh entry and a fresh interval
+    const uint32_t later = 3 * VISIT_FLUSH_INTERVAL;
+    buffer->record(beacon(1), -40, later);
+    TEST_ASSERT_EQUAL_UINT16(1, buffer->visits()[0].samples);
+    TEST_ASSERT_EQUAL_UINT32(later, buffer->visits()[0].first_seen_ms);
+    TEST_ASSERT_FALSE(buffer->due(later + VISIT_FLUSH_INTERVAL - 1));
+    TEST_ASSERT_TRUE(buffer->due(later + VISIT_FLUSH_INTERVAL));
+}
+
+void test_full_buffer_is_due_at_once()
+{
+    for (uint8_t i = 0; i < VisitBuffer::capacity(); ++i) {
+        TEST_ASSERT_TRUE(buffer->record(beacon(i), -50, 1000));
+    }
+    TEST_ASSERT_TRUE(buffer->full());
+    TEST_ASSERT_FALSE(buffer->due(1001));  // Full, but every beacon so far has its entry
+
+    // Known beacons still coalesce, a new one is turned away and forces the upload
+    TEST_ASSERT_TRUE(buffer->record(beacon(0), -50, 2000));
+    TEST_ASSERT_FALSE(buffer->record(beacon(200), -50, 2000));
+    TEST_ASSERT_EQUAL_UINT32(1, buffer->stats().overflows);
+    TEST_ASSERT_TRUE(buffer->due(2001));
+
+    buffer->sent(2001);
+    TEST_ASSERT_TRUE(buffer->record(beacon(200), -50, 3000));
+    TEST_ASSERT_FALSE(buffer->due(3001));
+}
+
+void test_failure_keeps_the_visits_for_the_next_interval()
+{
+    buffer->record(beacon(1), -50, 0);
+    buffer->record(beacon(1), -50, 10000);
+    const uint32_t attempt = VISIT_FLUSH_INTERVAL;
+    TEST_ASSERT_TRUE(buffer->due(attempt));
+    buffer->record_failure(attempt);
+
+    TEST_ASSERT_EQUAL_UINT32(1, buffer->stats().failures);
+    TEST_ASSERT_EQUAL_UINT8(1, buffer->count());
+    TEST_ASSERT_FALSE(buffer->due(attempt + 1));
+    TEST_ASSERT_TRUE(buffer->due(attempt + VISIT_FLUSH_INTERVAL));
+
+    // The retry carries every sighting since the last upload that went through
+    buffer->record(beacon(1), -50, attempt + 10000);
+    buffer->sent(attempt + VISIT_FLUSH_INTERVAL);
+    TEST_ASSERT_EQUAL_UINT32(2, buffer->stats().requests_saved);
+    TEST_ASSERT_EQUAL_UINT32(0, buffer->visits()[0].first_seen_ms);
+}
+
+void test_failed_full_buffer_does_not_retry_on_every_check()
+{
+    for (uint8_t i = 0; i <= VisitBuffer::capacity(); ++i) {
+        buffer->record(beacon(i), -50, 1000);
+    }
+    TEST_ASSERT_TRUE(buffer->due(1001));
+    buffer->record_failure(1001);
+    TEST_ASSERT_FALSE(buffer->due(1002));
+    TEST_ASSERT_TRUE(buffer->due(1001 + VISIT_FLUSH_INTERVAL));
+}
+
+void test_requests_saved_scale_to_an_hour()
+{
+    ArduinoShim::Clock::set_auto_advance_us(0);
+    ArduinoShim::Clock::reset();
+    TEST_ASSERT_EQUAL_UINT32(0, buffer->requests_saved_per_hour());
+
+    for (uint8_t scan = 0; scan < 7; ++scan) {
+        buffer->record(beacon(1), -50, scan * 10000);
+    }
+    buffer->sent(VISIT_FLUSH_INTERVAL);
+    ArduinoShim::Clock::advance_ms(1800000);  // 6 requests saved in half an hour
+    TEST_ASSERT_EQUAL_UINT32(12, buffer->requests_saved_per_hour());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_buffer_is_never_due);
+    RUN_TEST(test_sightings_of_a_beacon_coalesce);
+    RUN_TEST(test_interval_runs_from_the_first_visit);
+    RUN_TEST(test_sent_starts_over_and_counts_the_saved_requests);
+    RUN_TEST(test_full_buffer_is_due_at_once);
+    RUN_TEST(test_failure_keeps_the_visits_for_the_next_interval);
+    RUN_TEST(test_failed_full_buffer_does_not_retry_on_every_check);
+    RUN_TEST(test_requests_saved_scale_to_an_hour);
+    return UNITY_END();
+}